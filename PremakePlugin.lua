@@ -42,10 +42,26 @@ Plugin.sdk.static.includedirs = -- https://github.com/premake/premake-core/wiki/
 }
 Plugin.sdk.static.files = -- https://github.com/premake/premake-core/wiki/files
 {
+    "WoaGainAlloc.h",
+    "WoaGainAutoGain.cpp",
+    "WoaGainAutoGain.h",
+    "WoaGainDSP.cpp",
+    "WoaGainDSP.h",
+    "WoaGainDSPAVX2.cpp",
+    "WoaGainDSPAVX512.cpp",
+    "WoaGainDSPKernels.h",
     "WoaGainFX.cpp",
     "WoaGainFX.h",
     "WoaGainFXParams.cpp",
     "WoaGainFXParams.h",
+    "WoaGainLevelRegistry.cpp",
+    "WoaGainLevelRegistry.h",
+    "WoaGainLoudness.cpp",
+    "WoaGainLoudness.h",
+    "WoaGainPool.cpp",
+    "WoaGainPool.h",
+    "WoaGainStats.cpp",
+    "WoaGainStats.h",
 }
 Plugin.sdk.static.excludes = -- https://github.com/premake/premake-core/wiki/removefiles
 {
@@ -59,6 +75,7 @@ Plugin.sdk.static.libdirs = -- https://github.com/premake/premake-core/wiki/libd
 }
 Plugin.sdk.static.defines = -- https://github.com/premake/premake-core/wiki/defines
 {
+    -- "WOAGAIN_ENABLE_STATS", -- Time every Execute call, see WoaGainStats.h
 }
 
 -- SDK SHARED PLUGIN SECTION
@@ -91,6 +108,8 @@ Plugin.authoring.files =
 {
     "WoaGainPlugin.cpp",
     "WoaGainPlugin.h",
+    "WoaGainMonitorAggregator.cpp",
+    "WoaGainMonitorAggregator.h",
     "WoaGain.cpp",
     "WoaGain.h",
     "WoaGain.def",
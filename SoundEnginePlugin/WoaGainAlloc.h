@@ -0,0 +1,67 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainAlloc_H
+#define WoaGainAlloc_H
+
+#include <AK/SoundEngine/Common/IAkPlugin.h>
+
+#include <new>
+#include <utility>
+
+/// Allocation of the plug-in's blocks on whole cache lines. Voices may be processed on different
+/// threads, and a block sharing a cache line with a block of another voice would be written to by
+/// both threads (false sharing), so every block starts on a cache line and is padded to the next.
+namespace WoaGainAlloc
+{
+    /// Size of the cache lines of the targeted CPUs.
+    const size_t CacheLineSize = 64;
+
+    /// Rounds in_uSize up to whole cache lines.
+    inline size_t RoundToCacheLine(size_t in_uSize)
+    {
+        return (in_uSize + CacheLineSize - 1) & ~(CacheLineSize - 1);
+    }
+
+    /// Allocates in_uSize bytes on cache lines of their own. Returns nullptr when out of memory.
+    /// The block is returned with AK_PLUGIN_FREE.
+    inline void* Alloc(AK::IAkPluginMemAlloc* in_pAllocator, size_t in_uSize)
+    {
+        return AK_PLUGIN_ALLOC_ALIGN(in_pAllocator, RoundToCacheLine(in_uSize), CacheLineSize);
+    }
+
+    /// Constructs a T from in_args in a block of Alloc. Returns nullptr when out of memory. The
+    /// object is destroyed with AK_PLUGIN_DELETE.
+    template <typename T, typename... Args>
+    T* New(AK::IAkPluginMemAlloc* in_pAllocator, Args&&... in_args)
+    {
+        void* pMem = Alloc(in_pAllocator, sizeof(T));
+        return pMem ? ::new (pMem) T(std::forward<Args>(in_args)...) : nullptr;
+    }
+}
+
+#endif // WoaGainAlloc_H
@@ -0,0 +1,122 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#include "WoaGainAutoGain.h"
+#include "WoaGainAlloc.h"
+#include "WoaGainLoudness.h"
+
+#include <math.h>
+#include <new>
+
+namespace
+{
+    // Input below the absolute gate of BS.1770 is silence, for which the correction is held
+    const AkReal32 kSilenceLufs = -70.f;
+
+    // A correction closer than this to the one it approaches snaps to it, so that a steady input
+    // settles to a constant gain rather than ramping by ever smaller steps
+    const AkReal32 kSnapDb = 0.05f;
+}
+
+WoaGainAutoGain* WoaGainAutoGain::Create(AK::IAkPluginMemAlloc* in_pAllocator, AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate)
+{
+    WoaGainLoudness* pMeter = WoaGainLoudness::Create(in_pAllocator, in_channelConfig, in_uSampleRate);
+    if (!pMeter)
+        return nullptr;
+
+    void* pMem = WoaGainAlloc::Alloc(in_pAllocator, sizeof(WoaGainAutoGain));
+    if (!pMem)
+    {
+        pMeter->Destroy(in_pAllocator);
+        return nullptr;
+    }
+    return ::new (pMem) WoaGainAutoGain(pMeter, in_uSampleRate);
+}
+
+void WoaGainAutoGain::Destroy(AK::IAkPluginMemAlloc* in_pAllocator)
+{
+    m_pMeter->Destroy(in_pAllocator);
+    this->~WoaGainAutoGain();
+    AK_PLUGIN_FREE(in_pAllocator, this);
+}
+
+WoaGainAutoGain::WoaGainAutoGain(WoaGainLoudness* in_pMeter, AkUInt32 in_uSampleRate)
+    : m_pMeter(in_pMeter)
+    , m_fBlockTime(1000.f * (AkReal32)in_pMeter->GetBlockFrames() / (AkReal32)in_uSampleRate)
+    , m_fCorrectionDb(0.f)
+    , m_fCorrection(1.f)
+{
+}
+
+void WoaGainAutoGain::Reset()
+{
+    m_pMeter->Reset();
+    m_fCorrectionDb = 0.f;
+    m_fCorrection = 1.f;
+}
+
+bool WoaGainAutoGain::Process(AkAudioBuffer* in_pBuffer, AkUInt32 in_uFrames, const WoaGainParamsSnapshot& in_params)
+{
+    const AkUInt32 uBlocksEnded = m_pMeter->Process(in_pBuffer, in_uFrames);
+    if (uBlocksEnded == 0)
+        return false;
+
+    const AkReal32 fLoudness = m_pMeter->GetMomentary();
+    if (!(fLoudness > kSilenceLufs))
+        return false;
+
+    const WoaGainNonRTPCParams& nonRTPC = in_params.NonRTPC;
+    AkReal32 fTargetDb = in_params.RTPC.fTargetLoudness - fLoudness;
+    if (fTargetDb > nonRTPC.fMaxCorrection)
+        fTargetDb = nonRTPC.fMaxCorrection;
+    else if (fTargetDb < -nonRTPC.fMaxCorrection)
+        fTargetDb = -nonRTPC.fMaxCorrection;
+
+    // Buffers shorter than a block end at most one; a longer one steps over all its blocks at once
+    const AkReal32 fTimeConstant = fTargetDb < m_fCorrectionDb ? nonRTPC.fAttackTime : nonRTPC.fReleaseTime;
+    AkReal32 fCorrectionDb = fTargetDb;
+    if (fTimeConstant > 0.f)
+        fCorrectionDb += (m_fCorrectionDb - fTargetDb) * expf(-(AkReal32)uBlocksEnded * m_fBlockTime / fTimeConstant);
+    if (fabsf(fCorrectionDb - fTargetDb) < kSnapDb)
+        fCorrectionDb = fTargetDb;
+
+    if (fCorrectionDb == m_fCorrectionDb)
+        return false;
+    m_fCorrectionDb = fCorrectionDb;
+    m_fCorrection = AK_DBTOLIN(fCorrectionDb);
+    return true;
+}
+
+void WoaGainAutoGain::Skip(AkUInt32 in_uFrames)
+{
+    m_pMeter->Skip(in_uFrames);
+}
+
+AkUInt32 WoaGainAutoGain::GetBlockFrames() const
+{
+    return m_pMeter->GetBlockFrames();
+}
@@ -0,0 +1,82 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainAutoGain_H
+#define WoaGainAutoGain_H
+
+#include "WoaGainFXParams.h"
+
+class WoaGainLoudness;
+
+/// Feed-forward loudness normalization of WoaGainFX in auto-gain mode.
+///
+/// A WoaGainLoudness meter measures the momentary loudness of the input. At the end of every
+/// 100 ms block, the correction that brings it to the target is clamped to the maximum correction,
+/// then approached exponentially: with the attack time constant when the gain goes down, with the
+/// release time constant when it goes up. Below the absolute gate of BS.1770 (-70 LUFS) the input
+/// is taken as silence and the correction is held, so that pauses are not boosted. Measuring the
+/// input rather than the output keeps the loop open: a correction never feeds back into its own
+/// measurement.
+///
+/// All the memory is allocated by Create.
+class WoaGainAutoGain
+{
+public:
+    /// Returns nullptr when the allocation fails.
+    static WoaGainAutoGain* Create(AK::IAkPluginMemAlloc* in_pAllocator, AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate);
+
+    /// Releases an auto-gain obtained from Create.
+    void Destroy(AK::IAkPluginMemAlloc* in_pAllocator);
+
+    /// Clears the measurement and the correction.
+    void Reset();
+
+    /// Measures in_uFrames frames of input in in_pBuffer, and updates the correction for every
+    /// block that ended, from the auto-gain parameters of in_params. Returns whether the
+    /// correction changed.
+    bool Process(AkAudioBuffer* in_pBuffer, AkUInt32 in_uFrames, const WoaGainParamsSnapshot& in_params);
+
+    /// Same as processing in_uFrames frames of silence: the correction is held.
+    void Skip(AkUInt32 in_uFrames);
+
+    /// Frames per block, over which a change of the correction should be ramped.
+    AkUInt32 GetBlockFrames() const;
+
+    /// Gain correction, linear and in dB.
+    AkReal32 GetCorrection() const { return m_fCorrection; }
+    AkReal32 GetCorrectionDb() const { return m_fCorrectionDb; }
+
+private:
+    WoaGainAutoGain(WoaGainLoudness* in_pMeter, AkUInt32 in_uSampleRate);
+
+    WoaGainLoudness* m_pMeter;      ///< Input loudness
+    AkReal32 m_fBlockTime;          ///< Duration of a block in milliseconds
+    AkReal32 m_fCorrectionDb;
+    AkReal32 m_fCorrection;
+};
+
+#endif // WoaGainAutoGain_H
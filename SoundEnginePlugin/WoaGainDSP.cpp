@@ -0,0 +1,292 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainDSP.h"
+#include "WoaGainDSPKernels.h"
+
+#include <AK/SoundEngine/Common/AkSimd.h>
+
+#include <atomic>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+#define WOAGAIN_DSP_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    // Vectors of the AKSIMD kernels, see WoaGainDSPKernels.h
+    struct SimdV4
+    {
+        typedef AKSIMD_V4F32 F;
+        typedef AKSIMD_V4I32 I;
+        static const AkUInt32 FramesPerVector = 4;
+        static const AkUInt32 Alignment = AK_SIMD_ALIGNMENT;
+
+        static AkForceInline F Load(const AkReal32* in_p) { return AKSIMD_LOAD_V4F32(in_p); }
+        static AkForceInline F LoadU(const AkReal32* in_p) { return AKSIMD_LOADU_V4F32(in_p); }
+        static AkForceInline void Store(AkReal32* out_p, F in_v) { AKSIMD_STORE_V4F32(out_p, in_v); }
+        static AkForceInline F Set(AkReal32 in_f) { return AKSIMD_SET_V4F32(in_f); }
+        static AkForceInline F SetZero() { return AKSIMD_SETZERO_V4F32(); }
+        /// Frame numbers in_uFirst + 1 to in_uFirst + 4
+        static AkForceInline F Ramp(AkUInt32 in_uFirst)
+        {
+            return AKSIMD_SETV_V4F32((AkReal32)(in_uFirst + 4), (AkReal32)(in_uFirst + 3), (AkReal32)(in_uFirst + 2), (AkReal32)(in_uFirst + 1));
+        }
+        static AkForceInline F Mul(F in_a, F in_b) { return AKSIMD_MUL_V4F32(in_a, in_b); }
+        static AkForceInline F Add(F in_a, F in_b) { return AKSIMD_ADD_V4F32(in_a, in_b); }
+        static AkForceInline F Sub(F in_a, F in_b) { return AKSIMD_SUB_V4F32(in_a, in_b); }
+        static AkForceInline F MAdd(F in_a, F in_b, F in_c) { return AKSIMD_MADD_V4F32(in_a, in_b, in_c); }
+        static AkForceInline F Min(F in_a, F in_b) { return AKSIMD_MIN_V4F32(in_a, in_b); }
+        static AkForceInline F Max(F in_a, F in_b) { return AKSIMD_MAX_V4F32(in_a, in_b); }
+        static AkForceInline F Abs(F in_a) { return AKSIMD_ABS_V4F32(in_a); }
+        static AkForceInline I RoundToInt(F in_a) { return AKSIMD_CONVERT_V4F32_TO_V4I32(in_a); }
+        static AkForceInline F ToFloat(I in_a) { return AKSIMD_CONVERT_V4I32_TO_V4F32(in_a); }
+        /// 2^n, built from the float bits
+        static AkForceInline F Pow2(I in_n) { return AKSIMD_CAST_V4I32_TO_V4F32(AKSIMD_SHIFTLEFT_V4I32(AKSIMD_ADD_V4I32(in_n, AKSIMD_SET_V4I32(127)), 23)); }
+
+        static AkForceInline AkReal32 HorizontalAdd(F in_v)
+        {
+            return (AKSIMD_GETELEMENT_V4F32(in_v, 0) + AKSIMD_GETELEMENT_V4F32(in_v, 1))
+                 + (AKSIMD_GETELEMENT_V4F32(in_v, 2) + AKSIMD_GETELEMENT_V4F32(in_v, 3));
+        }
+
+        static AkForceInline AkReal32 HorizontalMax(F in_v)
+        {
+            using WoaGainDSPKernels::MaxReal;
+            return MaxReal(MaxReal(AKSIMD_GETELEMENT_V4F32(in_v, 0), AKSIMD_GETELEMENT_V4F32(in_v, 1)),
+                           MaxReal(AKSIMD_GETELEMENT_V4F32(in_v, 2), AKSIMD_GETELEMENT_V4F32(in_v, 3)));
+        }
+    };
+
+    // 1.5 * 2^23: adding then subtracting it rounds a float below 2^22 to the nearest integer
+    const AkReal32 kRoundMagic = 12582912.f;
+
+    AkForceInline AkReal32 DbToLinFastImpl(AkReal32 in_fDb)
+    {
+        using namespace WoaGainDSPKernels;
+        AkReal32 fX = in_fDb * kDbToLog2;
+        fX = fX > kMaxLog2 ? kMaxLog2 : (fX < -kMaxLog2 ? -kMaxLog2 : fX);
+        const AkReal32 fN = (fX + kRoundMagic) - kRoundMagic;
+        const AkReal32 fF = fX - fN;
+        const AkReal32 fPoly = ((kExp2C3 * fF + kExp2C2) * fF + kExp2C1) * fF + kExp2C0;
+
+        const AkUInt32 uScaleBits = (AkUInt32)((AkInt32)fN + 127) << 23;
+        AkReal32 fScale;
+        memcpy(&fScale, &uScaleBits, sizeof(fScale));
+        return fPoly * fScale;
+    }
+
+#ifdef WOAGAIN_DSP_X86
+    void CpuId(AkUInt32 in_uLeaf, AkUInt32 in_uSubLeaf, AkUInt32 out_regs[4])
+    {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuidex(regs, (int)in_uLeaf, (int)in_uSubLeaf);
+        for (AkUInt32 i = 0; i < 4; ++i)
+            out_regs[i] = (AkUInt32)regs[i];
+#else
+        __cpuid_count(in_uLeaf, in_uSubLeaf, out_regs[0], out_regs[1], out_regs[2], out_regs[3]);
+#endif
+    }
+
+    // Register states the operating system saves on context switches
+    AkUInt64 GetXcr0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        AkUInt32 uEax, uEdx;
+        __asm__ volatile("xgetbv" : "=a"(uEax), "=d"(uEdx) : "c"(0));
+        return ((AkUInt64)uEdx << 32) | uEax;
+#endif
+    }
+#endif
+
+    WoaGainDSP::Isa DetectIsa()
+    {
+#ifdef WOAGAIN_DSP_X86
+        AkUInt32 regs[4];   // EAX, EBX, ECX, EDX
+        CpuId(0, 0, regs);
+        const AkUInt32 uMaxLeaf = regs[0];
+
+        // AVX needs OSXSAVE (leaf 1, ECX bit 27), then the XMM and YMM states in XCR0
+        CpuId(1, 0, regs);
+        const AkUInt32 uAvxBits = (1u << 27) | (1u << 28);
+        if (uMaxLeaf < 7 || (regs[2] & uAvxBits) != uAvxBits || (GetXcr0() & 0x6) != 0x6)
+            return WoaGainDSP::Isa_Baseline;
+
+        // Leaf 7, EBX: AVX2 is bit 5, AVX-512F is bit 16 and also needs the opmask and ZMM states
+        CpuId(7, 0, regs);
+        if ((regs[1] & (1u << 5)) == 0)
+            return WoaGainDSP::Isa_Baseline;
+        if ((regs[1] & (1u << 16)) != 0 && (GetXcr0() & 0xE0) == 0xE0)
+            return WoaGainDSP::Isa_AVX512;
+        return WoaGainDSP::Isa_AVX2;
+#else
+        return WoaGainDSP::Isa_Baseline;
+#endif
+    }
+
+    // GetSupportedIsa, lowered by the WOAGAIN_ISA environment variable
+    WoaGainDSP::Isa SelectIsa()
+    {
+        const WoaGainDSP::Isa eSupported = WoaGainDSP::GetSupportedIsa();
+        const char* szIsa = getenv("WOAGAIN_ISA");
+        WoaGainDSP::Isa eIsa;
+        if (szIsa && WoaGainDSP::ParseIsa(szIsa, eIsa) && eIsa < eSupported)
+            return eIsa;
+        return eSupported;
+    }
+
+    std::atomic<AkInt32>& GetIsaState()
+    {
+        static std::atomic<AkInt32> s_iIsa(SelectIsa());
+        return s_iIsa;
+    }
+}
+
+void WoaGainDSP::ApplyGain(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain)
+{
+    WoaGainDSPKernels::ApplyGain<SimdV4>(io_pBuf, in_uFrames, in_fGain);
+}
+
+void WoaGainDSP::ApplyGainRamp(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc)
+{
+    WoaGainDSPKernels::ApplyGainRamp<SimdV4>(io_pBuf, in_uFrames, in_fStart, in_fInc);
+}
+
+void WoaGainDSP::ApplyGainMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain, Meter& io_in)
+{
+    WoaGainDSPKernels::ApplyGainMeter<SimdV4, true>(io_pBuf, in_uFrames, in_fGain, io_in);
+}
+
+void WoaGainDSP::Measure(const AkReal32* in_pBuf, AkUInt32 in_uFrames, Meter& io_in)
+{
+    WoaGainDSPKernels::ApplyGainMeter<SimdV4, false>((AkReal32*)in_pBuf, in_uFrames, 1.f, io_in);
+}
+
+void WoaGainDSP::ApplyGainRampMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc, Meter& io_in, Meter& io_out)
+{
+    WoaGainDSPKernels::ApplyGainRampMeter<SimdV4>(io_pBuf, in_uFrames, in_fStart, in_fInc, io_in, io_out);
+}
+
+AkReal32 WoaGainDSP::DbToLinFast(AkReal32 in_fDb)
+{
+    return DbToLinFastImpl(in_fDb);
+}
+
+void WoaGainDSP::DbToLinFast(const AkReal32* in_pDb, AkReal32* out_pLin, AkUInt32 in_uCount)
+{
+    AkUInt32 i = 0;
+    for (; i + SimdV4::FramesPerVector <= in_uCount; i += SimdV4::FramesPerVector)
+        AKSIMD_STOREU_V4F32(out_pLin + i, WoaGainDSPKernels::DbToLinFast<SimdV4>(AKSIMD_LOADU_V4F32(in_pDb + i)));
+    for (; i < in_uCount; ++i)
+        out_pLin[i] = DbToLinFastImpl(in_pDb[i]);
+}
+
+WoaGainDSP::Path WoaGainDSP::GetPath(const BufferGain& in_gain)
+{
+    if (in_gain.uRampFrames > 0)
+        return Path_Ramp;
+    if (in_gain.fGain == 1.f)
+        return Path_Unity;
+    if (in_gain.fGain == 0.f)
+        return Path_Mute;
+    return Path_Constant;
+}
+
+const char* WoaGainDSP::GetIsaName(Isa in_eIsa)
+{
+    switch (in_eIsa)
+    {
+#ifdef AKSIMD_NEON
+    case Isa_Baseline: return "neon";
+#else
+    case Isa_Baseline: return "sse2";
+#endif
+    case Isa_AVX2: return "avx2";
+    case Isa_AVX512: return "avx512";
+    default: return "unknown";
+    }
+}
+
+bool WoaGainDSP::ParseIsa(const char* in_szName, Isa& out_eIsa)
+{
+    for (AkInt32 i = 0; i < Isa_Count; ++i)
+    {
+        if (strcmp(in_szName, GetIsaName((Isa)i)) == 0)
+        {
+            out_eIsa = (Isa)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+WoaGainDSP::Isa WoaGainDSP::GetSupportedIsa()
+{
+    static const Isa s_eSupported = DetectIsa();
+    return s_eSupported;
+}
+
+WoaGainDSP::Isa WoaGainDSP::GetIsa()
+{
+    return (Isa)GetIsaState().load(std::memory_order_relaxed);
+}
+
+bool WoaGainDSP::SetIsa(Isa in_eIsa)
+{
+    if (in_eIsa > GetSupportedIsa())
+        return false;
+    GetIsaState().store(in_eIsa, std::memory_order_relaxed);
+    return true;
+}
+
+WoaGainDSP::ProcessFunc WoaGainDSP::GetProcessFunc(AkUInt32 in_uNumChannels, bool in_bMetering)
+{
+    return GetProcessFunc(in_uNumChannels, in_bMetering, GetIsa());
+}
+
+WoaGainDSP::ProcessFunc WoaGainDSP::GetProcessFunc(AkUInt32 in_uNumChannels, bool in_bMetering, Isa in_eIsa)
+{
+#ifdef WOAGAIN_DSP_X86
+    if (in_eIsa > GetSupportedIsa())
+        in_eIsa = GetSupportedIsa();
+    if (in_eIsa == Isa_AVX512)
+        return GetProcessFuncAVX512(in_uNumChannels, in_bMetering);
+    if (in_eIsa == Isa_AVX2)
+        return GetProcessFuncAVX2(in_uNumChannels, in_bMetering);
+#endif
+    return WoaGainDSPKernels::GetProcessFunc<SimdV4>(in_uNumChannels, in_bMetering);
+}
@@ -0,0 +1,193 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainDSP_H
+#define WoaGainDSP_H
+
+#include <AK/SoundEngine/Common/AkCommonDefs.h>
+
+/// Vectorized DSP kernels used by WoaGainFX::Execute.
+///
+/// Channel kernels work in place on a single deinterleaved channel. A scalar head brings the
+/// pointer to AK_SIMD_ALIGNMENT, the body then uses aligned AKSIMD loads and stores (SSE2 on x86,
+/// NEON on ARM) and a scalar tail handles the remaining frames, so any buffer length is accepted.
+///
+/// On x86, the buffer kernels also come in AVX2 and AVX-512 variants, selected at run time by
+/// GetProcessFunc according to GetIsa. They process 8 or 16 frames per vector, aligning to 32 or
+/// 64 bytes, and their audio output is bit-identical to the AKSIMD kernels'. Only the summation
+/// order of the meters differs, with more partial sums, so the bound below still holds.
+///
+/// Precision with respect to the original scalar loop of WoaGainFX::Execute:
+/// - ApplyGain performs exactly one IEEE-754 single precision multiply per sample with the same
+///   gain value, so its output is bit-identical to the scalar path (0 ULP).
+/// - ApplyGainRamp computes the gain of every frame from the ramp start and the frame index rather
+///   than by accumulation, so the ramp does not drift and costs one extra multiply-add per sample.
+/// - The metering variants produce the same audio output as their plain counterparts. Their sums
+///   of squares accumulate in 8 partial sums instead of one, which only changes the summation
+///   order. The relative difference to the sequential sum is bounded by (N / 8 + 3) * 2^-24 for N
+///   frames, i.e. below 1.3e-5 (about 1e-4 dB on the RMS) for an 8192 frame buffer. Peaks are exact.
+/// - Ramps along a Curve other than Curve_Linear go through DbToLinFast, see its error bound.
+namespace WoaGainDSP
+{
+    /// Signal statistics of a channel, accumulated over one or more calls to the metering kernels.
+    struct Meter
+    {
+        Meter() : fSumSq(0.f), fPeak(0.f) {}
+
+        AkReal32 fSumSq;    ///< Sum of the squares of the samples
+        AkReal32 fPeak;     ///< Largest absolute sample value
+    };
+
+    /// Multiplies in_uFrames samples of io_pBuf by the linear gain in_fGain.
+    void ApplyGain(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain);
+
+    /// Multiplies in_uFrames samples of io_pBuf by a linear ramp: frame k is scaled by
+    /// in_fStart + in_fInc * (k + 1), so that the last frame of a ramp reaches its target gain.
+    void ApplyGainRamp(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc);
+
+    /// Same as ApplyGain, and accumulates the statistics of the input samples into io_in in the same pass.
+    /// For a constant gain the output statistics follow analytically: sum of squares times in_fGain^2
+    /// and peak times |in_fGain|.
+    void ApplyGainMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain, Meter& io_in);
+
+    /// Accumulates the statistics of in_uFrames samples of in_pBuf into io_in, without modifying them.
+    void Measure(const AkReal32* in_pBuf, AkUInt32 in_uFrames, Meter& io_in);
+
+    /// Same as ApplyGainRamp, and accumulates the statistics of the input samples into io_in and of the
+    /// output samples into io_out in the same pass.
+    void ApplyGainRampMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc, Meter& io_in, Meter& io_out);
+
+    /// Converts a gain in dB to a linear gain, as 2^(in_fDb * log2(10) / 20): the power of two of
+    /// the rounded exponent is built from its float bits, and the remaining 2^f, f in [-0.5, 0.5],
+    /// is a degree 3 minimax polynomial. The relative error is below 7.5e-5, i.e. 0.00065 dB, for
+    /// inputs within +-750 dB, which are clamped to that range. There is no mute floor: -96 dB
+    /// converts to 1.58e-5, not 0. Without a call to powf, as in AK_DBTOLIN, the conversion costs a
+    /// few multiply-adds and vectorizes.
+    AkReal32 DbToLinFast(AkReal32 in_fDb);
+
+    /// Vectorized DbToLinFast of in_uCount values, with the same results.
+    void DbToLinFast(const AkReal32* in_pDb, AkReal32* out_pLin, AkUInt32 in_uCount);
+
+    /// Shape of the gain ramps of a BufferGain.
+    enum Curve
+    {
+        Curve_Linear,   ///< Linear in amplitude, see ApplyGainRamp
+        Curve_Decibel,  ///< Linear in dB: the loudness changes at an even rate over the ramp
+        Curve_SCurve,   ///< Smoothstep in dB: eases out of the start gain and into the target
+        Curve_Count
+    };
+
+    /// Gain applied to every channel of a buffer: a ramp over the first uRampFrames frames, then
+    /// the flat gain fGain up to uFrames. The buffer kernels leave the flat part untouched when
+    /// fGain is 1 (only measuring it when metered) and clear it with memset when fGain is 0.
+    ///
+    /// Curve_Linear ramps scale frame k by fRampStart + fRampInc * (k + 1), see ApplyGainRamp.
+    /// Other curves interpolate in dB: with t = fRampStart + fRampInc * (k + 1) the position in
+    /// the ramp, from 0 to 1, frame k is scaled by DbToLinFast(fRampFromDb + fRampRangeDb * s(t)),
+    /// s(t) = t for Curve_Decibel and 3t^2 - 2t^3 for Curve_SCurve. The gains of a dB ramp are
+    /// computed once per block of frames and shared by all channels, so that their cost is spread
+    /// over the channels.
+    ///
+    /// When fScaleInc is not 0, the ramped frames are also scaled by fScaleStart + fScaleInc * (k + 1),
+    /// a linear ramp of its own multiplied into either curve, and their gains are computed by blocks
+    /// as for dB curves. WoaGainFX ramps the auto-gain correction this way while a smoothing or event
+    /// ramp runs. The flat frames are not scaled: fGain includes the end of the scale ramp.
+    struct BufferGain
+    {
+        AkUInt32 uFrames;
+        AkUInt32 uRampFrames;
+        AkReal32 fRampStart;
+        AkReal32 fRampInc;
+        AkReal32 fGain;
+        Curve eCurve;
+        AkReal32 fRampFromDb;   ///< Gain at the start of a dB ramp, unused by Curve_Linear
+        AkReal32 fRampRangeDb;  ///< Gain change over a whole dB ramp, unused by Curve_Linear
+        AkReal32 fScaleStart;   ///< Scale before the first ramped frame, unused when fScaleInc is 0
+        AkReal32 fScaleInc;     ///< Increment per frame of the scale, 0 to leave the ramp unscaled
+    };
+
+    /// Statistics of a channel before and after the gain, over one buffer.
+    struct ChannelMeter
+    {
+        Meter in;
+        Meter out;
+    };
+
+    /// Processing of a buffer by the buffer kernels, from the cheapest.
+    enum Path
+    {
+        Path_Unity,     ///< Flat unity gain: the samples are left untouched
+        Path_Mute,      ///< Flat zero gain: the channels are cleared
+        Path_Constant,  ///< Flat gain: one multiply per sample
+        Path_Ramp,      ///< Gain ramp over some or all of the frames
+        Path_Count
+    };
+
+    /// Returns the path the buffer kernels take for in_gain.
+    Path GetPath(const BufferGain& in_gain);
+
+    /// Buffer kernel: applies in_gain to every channel of io_pBuffer. Metered kernels also accumulate
+    /// the buffer statistics into io_pMeters, one ChannelMeter per channel, plain kernels ignore it.
+    typedef void (*ProcessFunc)(AkAudioBuffer* io_pBuffer, const BufferGain& in_gain, ChannelMeter* io_pMeters);
+
+    /// Instruction sets of the buffer kernels, from the most widely supported.
+    enum Isa
+    {
+        Isa_Baseline,   ///< AKSIMD: SSE2 on x86, NEON on ARM
+        Isa_AVX2,       ///< x86 only
+        Isa_AVX512,     ///< AVX-512F, x86 only
+        Isa_Count
+    };
+
+    /// Lowercase name of in_eIsa: "sse2" (or "neon" on ARM), "avx2" or "avx512".
+    const char* GetIsaName(Isa in_eIsa);
+
+    /// Finds the instruction set named in_szName, see GetIsaName. Returns false for unknown names.
+    bool ParseIsa(const char* in_szName, Isa& out_eIsa);
+
+    /// Widest instruction set supported by both the CPU and the operating system, detected on the
+    /// first call.
+    Isa GetSupportedIsa();
+
+    /// Instruction set of the kernels returned by GetProcessFunc. On the first call, this is
+    /// GetSupportedIsa, lowered to the level named by the WOAGAIN_ISA environment variable if set.
+    Isa GetIsa();
+
+    /// Forces the instruction set of the kernels returned from now on, for instance to test or compare
+    /// the variants. Instances keep the kernels selected in their Init. Returns false, leaving it
+    /// unchanged, when in_eIsa is above GetSupportedIsa.
+    bool SetIsa(Isa in_eIsa);
+
+    /// Returns the buffer kernel for in_uNumChannels channels. Mono, stereo, 5.1, 7.1 and 7.1.4 get
+    /// kernels specialized on their channel count, with the channel loop unrolled at compile time;
+    /// other channel counts get a generic kernel. The kernel uses GetIsa.
+    ProcessFunc GetProcessFunc(AkUInt32 in_uNumChannels, bool in_bMetering);
+
+    /// Same as GetProcessFunc, for a given instruction set, lowered to GetSupportedIsa.
+    ProcessFunc GetProcessFunc(AkUInt32 in_uNumChannels, bool in_bMetering, Isa in_eIsa);
+}
+
+#endif // WoaGainDSP_H
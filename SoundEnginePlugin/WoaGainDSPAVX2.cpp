@@ -0,0 +1,103 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// AVX2 variant of the buffer kernels, see WoaGainDSPKernels.h
+
+#include "WoaGainDSP.h"
+
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+
+#include <immintrin.h>
+#include <math.h>
+#include <string.h>
+
+// The rest of the file is compiled for AVX2, whatever the flags of the build. The headers are
+// included above so that their inline functions keep the flags of the build.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx2")
+#endif
+
+#include "WoaGainDSPKernels.h"
+
+namespace
+{
+    struct SimdV8
+    {
+        typedef __m256 F;
+        typedef __m256i I;
+        static const AkUInt32 FramesPerVector = 8;
+        static const AkUInt32 Alignment = 32;
+
+        static AkForceInline F Load(const AkReal32* in_p) { return _mm256_load_ps(in_p); }
+        static AkForceInline F LoadU(const AkReal32* in_p) { return _mm256_loadu_ps(in_p); }
+        static AkForceInline void Store(AkReal32* out_p, F in_v) { _mm256_store_ps(out_p, in_v); }
+        static AkForceInline F Set(AkReal32 in_f) { return _mm256_set1_ps(in_f); }
+        static AkForceInline F SetZero() { return _mm256_setzero_ps(); }
+        /// Frame numbers in_uFirst + 1 to in_uFirst + 8
+        static AkForceInline F Ramp(AkUInt32 in_uFirst)
+        {
+            return _mm256_add_ps(_mm256_set1_ps((AkReal32)in_uFirst), _mm256_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f));
+        }
+        static AkForceInline F Mul(F in_a, F in_b) { return _mm256_mul_ps(in_a, in_b); }
+        static AkForceInline F Add(F in_a, F in_b) { return _mm256_add_ps(in_a, in_b); }
+        static AkForceInline F Sub(F in_a, F in_b) { return _mm256_sub_ps(in_a, in_b); }
+        static AkForceInline F MAdd(F in_a, F in_b, F in_c) { return _mm256_add_ps(_mm256_mul_ps(in_a, in_b), in_c); }
+        static AkForceInline F Min(F in_a, F in_b) { return _mm256_min_ps(in_a, in_b); }
+        static AkForceInline F Max(F in_a, F in_b) { return _mm256_max_ps(in_a, in_b); }
+        static AkForceInline F Abs(F in_a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), in_a); }
+        static AkForceInline I RoundToInt(F in_a) { return _mm256_cvtps_epi32(in_a); }
+        static AkForceInline F ToFloat(I in_a) { return _mm256_cvtepi32_ps(in_a); }
+        /// 2^n, built from the float bits
+        static AkForceInline F Pow2(I in_n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(in_n, _mm256_set1_epi32(127)), 23)); }
+
+        static AkForceInline AkReal32 HorizontalAdd(F in_v)
+        {
+            const __m128 v4 = _mm_add_ps(_mm256_castps256_ps128(in_v), _mm256_extractf128_ps(in_v, 1));
+            const __m128 v2 = _mm_add_ps(v4, _mm_movehl_ps(v4, v4));
+            return _mm_cvtss_f32(_mm_add_ss(v2, _mm_shuffle_ps(v2, v2, 1)));
+        }
+
+        static AkForceInline AkReal32 HorizontalMax(F in_v)
+        {
+            const __m128 v4 = _mm_max_ps(_mm256_castps256_ps128(in_v), _mm256_extractf128_ps(in_v, 1));
+            const __m128 v2 = _mm_max_ps(v4, _mm_movehl_ps(v4, v4));
+            return _mm_cvtss_f32(_mm_max_ss(v2, _mm_shuffle_ps(v2, v2, 1)));
+        }
+    };
+}
+
+WoaGainDSP::ProcessFunc WoaGainDSP::GetProcessFuncAVX2(AkUInt32 in_uNumChannels, bool in_bMetering)
+{
+    return WoaGainDSPKernels::GetProcessFunc<SimdV8>(in_uNumChannels, in_bMetering);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+
+#endif
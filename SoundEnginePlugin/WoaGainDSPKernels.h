@@ -0,0 +1,523 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainDSPKernels_H
+#define WoaGainDSPKernels_H
+
+#include "WoaGainDSP.h"
+
+#include <math.h>
+#include <string.h>
+
+// Buffer kernels of WoaGainDSP, written once for any vector width.
+//
+// Every kernel is a template on a vector type V, which wraps one instruction set:
+//     typedef F, I                Float and integer vectors of FramesPerVector lanes
+//     FramesPerVector, Alignment  Lanes, and bytes of alignment of Load and Store
+//     Load, LoadU, Store, Set, SetZero, Ramp, Mul, Add, Sub, MAdd, Min, Max, Abs,
+//     RoundToInt, ToFloat, Pow2, HorizontalAdd, HorizontalMax
+// WoaGainDSP.cpp instantiates them with AKSIMD (SSE2 or NEON), WoaGainDSPAVX2.cpp and
+// WoaGainDSPAVX512.cpp with wider vectors, each compiled for its own instruction set. MAdd is a
+// multiply then an add, not a fused multiply-add, so that every variant computes the same gains:
+// their audio output is bit-identical, only the summation order of the meters differs.
+//
+// Everything here has internal linkage: each file including it gets its own copy, built for its
+// instruction set, and the linker cannot substitute the copy of one variant for another's.
+namespace WoaGainDSP
+{
+    /// Buffer kernels of the x86 variants, see GetProcessFunc.
+    ProcessFunc GetProcessFuncAVX2(AkUInt32 in_uNumChannels, bool in_bMetering);
+    ProcessFunc GetProcessFuncAVX512(AkUInt32 in_uNumChannels, bool in_bMetering);
+}
+
+namespace
+{
+namespace WoaGainDSPKernels
+{
+    AkForceInline AkReal32 MaxReal(AkReal32 in_fA, AkReal32 in_fB)
+    {
+        return in_fA > in_fB ? in_fA : in_fB;
+    }
+
+    // Number of scalar frames to process before in_pBuf reaches an address aligned for V::Load.
+    template <typename V>
+    AkForceInline AkUInt32 FramesToAlignment(const AkReal32* in_pBuf, AkUInt32 in_uFrames)
+    {
+        const AkUInt32 uMisaligned = (AkUInt32)(((AkUIntPtr)in_pBuf & (V::Alignment - 1)) / sizeof(AkReal32));
+        const AkUInt32 uHead = uMisaligned ? V::FramesPerVector - uMisaligned : 0;
+        return uHead < in_uFrames ? uHead : in_uFrames;
+    }
+
+    // log2(10) / 20: converts dB to a base 2 exponent
+    const AkReal32 kDbToLog2 = 0.166096404744368f;
+
+    // Largest base 2 exponent converted, 2^126 is still a normal float and so is its reciprocal
+    const AkReal32 kMaxLog2 = 126.f;
+
+    // Minimax polynomial of 2^f over f in [-0.5, 0.5], for the relative error (7.5e-5)
+    const AkReal32 kExp2C0 = 9.999280572e-01f;
+    const AkReal32 kExp2C1 = 6.932609677e-01f;
+    const AkReal32 kExp2C2 = 2.426111400e-01f;
+    const AkReal32 kExp2C3 = 5.517165735e-02f;
+
+    // WoaGainDSP::DbToLinFast on a vector: the conversion to integers rounds to nearest even
+    template <typename V>
+    AkForceInline typename V::F DbToLinFast(typename V::F in_vDb)
+    {
+        typename V::F vX = V::Mul(in_vDb, V::Set(kDbToLog2));
+        vX = V::Min(V::Max(vX, V::Set(-kMaxLog2)), V::Set(kMaxLog2));
+        const typename V::I vN = V::RoundToInt(vX);
+        const typename V::F vF = V::Sub(vX, V::ToFloat(vN));
+        typename V::F vPoly = V::MAdd(V::Set(kExp2C3), vF, V::Set(kExp2C2));
+        vPoly = V::MAdd(vPoly, vF, V::Set(kExp2C1));
+        vPoly = V::MAdd(vPoly, vF, V::Set(kExp2C0));
+        return V::Mul(vPoly, V::Pow2(vN));
+    }
+
+    template <typename V>
+    AkForceInline void ApplyGain(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+        const AkUInt32 uStep = V::FramesPerVector;
+
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+            io_pBuf[i] *= in_fGain;
+
+        const typename V::F vGain = V::Set(in_fGain);
+        for (; i + 2 * uStep <= in_uFrames; i += 2 * uStep)
+        {
+            const typename V::F vIn0 = V::Load(io_pBuf + i);
+            const typename V::F vIn1 = V::Load(io_pBuf + i + uStep);
+            V::Store(io_pBuf + i, V::Mul(vIn0, vGain));
+            V::Store(io_pBuf + i + uStep, V::Mul(vIn1, vGain));
+        }
+
+        for (; i < in_uFrames; ++i)
+            io_pBuf[i] *= in_fGain;
+    }
+
+    template <typename V>
+    AkForceInline void ApplyGainRamp(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+            io_pBuf[i] *= in_fStart + in_fInc * (AkReal32)(i + 1);
+
+        // Frame indices are exact in single precision for any AkAudioBuffer length
+        const typename V::F vStart = V::Set(in_fStart);
+        const typename V::F vInc = V::Set(in_fInc);
+        const typename V::F vStep = V::Set((AkReal32)V::FramesPerVector);
+        typename V::F vIndex = V::Ramp(i);
+        for (; i + V::FramesPerVector <= in_uFrames; i += V::FramesPerVector)
+        {
+            const typename V::F vGain = V::MAdd(vInc, vIndex, vStart);
+            V::Store(io_pBuf + i, V::Mul(V::Load(io_pBuf + i), vGain));
+            vIndex = V::Add(vIndex, vStep);
+        }
+
+        for (; i < in_uFrames; ++i)
+            io_pBuf[i] *= in_fStart + in_fInc * (AkReal32)(i + 1);
+    }
+
+    // Without in_bApplyGain, only measures the input: the buffer is left untouched
+    template <typename V, bool in_bApplyGain>
+    AkForceInline void ApplyGainMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain, WoaGainDSP::Meter& io_in)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+        const AkUInt32 uStep = V::FramesPerVector;
+
+        AkReal32 fSumSq = 0.f;
+        AkReal32 fPeak = io_in.fPeak;
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            fSumSq += fIn * fIn;
+            fPeak = MaxReal(fPeak, fabsf(fIn));
+            if (in_bApplyGain)
+                io_pBuf[i] = fIn * in_fGain;
+        }
+
+        // Two independent sum accumulators hide the latency of the vector adds
+        const typename V::F vGain = V::Set(in_fGain);
+        typename V::F vSum0 = V::SetZero();
+        typename V::F vSum1 = V::SetZero();
+        typename V::F vPeak = V::SetZero();
+        for (; i + 2 * uStep <= in_uFrames; i += 2 * uStep)
+        {
+            const typename V::F vIn0 = V::Load(io_pBuf + i);
+            const typename V::F vIn1 = V::Load(io_pBuf + i + uStep);
+            vSum0 = V::MAdd(vIn0, vIn0, vSum0);
+            vSum1 = V::MAdd(vIn1, vIn1, vSum1);
+            vPeak = V::Max(vPeak, V::Max(V::Abs(vIn0), V::Abs(vIn1)));
+            if (in_bApplyGain)
+            {
+                V::Store(io_pBuf + i, V::Mul(vIn0, vGain));
+                V::Store(io_pBuf + i + uStep, V::Mul(vIn1, vGain));
+            }
+        }
+        fSumSq += V::HorizontalAdd(V::Add(vSum0, vSum1));
+        fPeak = MaxReal(fPeak, V::HorizontalMax(vPeak));
+
+        for (; i < in_uFrames; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            fSumSq += fIn * fIn;
+            fPeak = MaxReal(fPeak, fabsf(fIn));
+            if (in_bApplyGain)
+                io_pBuf[i] = fIn * in_fGain;
+        }
+
+        io_in.fSumSq += fSumSq;
+        io_in.fPeak = fPeak;
+    }
+
+    template <typename V>
+    AkForceInline void ApplyGainRampMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fStart, AkReal32 in_fInc, WoaGainDSP::Meter& io_in, WoaGainDSP::Meter& io_out)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+
+        AkReal32 fSumSqIn = 0.f;
+        AkReal32 fSumSqOut = 0.f;
+        AkReal32 fPeakIn = io_in.fPeak;
+        AkReal32 fPeakOut = io_out.fPeak;
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            const AkReal32 fOut = fIn * (in_fStart + in_fInc * (AkReal32)(i + 1));
+            fSumSqIn += fIn * fIn;
+            fSumSqOut += fOut * fOut;
+            fPeakIn = MaxReal(fPeakIn, fabsf(fIn));
+            fPeakOut = MaxReal(fPeakOut, fabsf(fOut));
+            io_pBuf[i] = fOut;
+        }
+
+        const typename V::F vStart = V::Set(in_fStart);
+        const typename V::F vInc = V::Set(in_fInc);
+        const typename V::F vStep = V::Set((AkReal32)V::FramesPerVector);
+        typename V::F vIndex = V::Ramp(i);
+        typename V::F vSumIn = V::SetZero();
+        typename V::F vSumOut = V::SetZero();
+        typename V::F vPeakIn = V::SetZero();
+        typename V::F vPeakOut = V::SetZero();
+        for (; i + V::FramesPerVector <= in_uFrames; i += V::FramesPerVector)
+        {
+            const typename V::F vIn = V::Load(io_pBuf + i);
+            const typename V::F vOut = V::Mul(vIn, V::MAdd(vInc, vIndex, vStart));
+            vSumIn = V::MAdd(vIn, vIn, vSumIn);
+            vSumOut = V::MAdd(vOut, vOut, vSumOut);
+            vPeakIn = V::Max(vPeakIn, V::Abs(vIn));
+            vPeakOut = V::Max(vPeakOut, V::Abs(vOut));
+            V::Store(io_pBuf + i, vOut);
+            vIndex = V::Add(vIndex, vStep);
+        }
+        fSumSqIn += V::HorizontalAdd(vSumIn);
+        fSumSqOut += V::HorizontalAdd(vSumOut);
+        fPeakIn = MaxReal(fPeakIn, V::HorizontalMax(vPeakIn));
+        fPeakOut = MaxReal(fPeakOut, V::HorizontalMax(vPeakOut));
+
+        for (; i < in_uFrames; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            const AkReal32 fOut = fIn * (in_fStart + in_fInc * (AkReal32)(i + 1));
+            fSumSqIn += fIn * fIn;
+            fSumSqOut += fOut * fOut;
+            fPeakIn = MaxReal(fPeakIn, fabsf(fIn));
+            fPeakOut = MaxReal(fPeakOut, fabsf(fOut));
+            io_pBuf[i] = fOut;
+        }
+
+        io_in.fSumSq += fSumSqIn;
+        io_in.fPeak = fPeakIn;
+        io_out.fSumSq += fSumSqOut;
+        io_out.fPeak = fPeakOut;
+    }
+
+    // Frames of a computed ramp whose gains are computed at once, then applied to every channel
+    const AkUInt32 kCurveBlockFrames = 256;
+
+    // Gains of frames in_uFirst to in_uFirst + in_uFrames - 1 of a dB ramp, see BufferGain. Whole
+    // vectors are written: out_pGains must have room for in_uFrames rounded up to V::FramesPerVector.
+    template <typename V, bool in_bSCurve>
+    AkForceInline void ComputeCurveGains(AkReal32* out_pGains, AkUInt32 in_uFirst, AkUInt32 in_uFrames, const WoaGainDSP::BufferGain& in_gain)
+    {
+        const typename V::F vStart = V::Set(in_gain.fRampStart);
+        const typename V::F vInc = V::Set(in_gain.fRampInc);
+        const typename V::F vFromDb = V::Set(in_gain.fRampFromDb);
+        const typename V::F vRangeDb = V::Set(in_gain.fRampRangeDb);
+        const typename V::F vThree = V::Set(3.f);
+        const typename V::F vStep = V::Set((AkReal32)V::FramesPerVector);
+        typename V::F vIndex = V::Ramp(in_uFirst);
+        for (AkUInt32 i = 0; i < in_uFrames; i += V::FramesPerVector)
+        {
+            typename V::F vPos = V::MAdd(vInc, vIndex, vStart);
+            if (in_bSCurve)
+                vPos = V::Mul(V::Mul(vPos, vPos), V::Sub(vThree, V::Add(vPos, vPos)));
+            V::Store(out_pGains + i, DbToLinFast<V>(V::MAdd(vRangeDb, vPos, vFromDb)));
+            vIndex = V::Add(vIndex, vStep);
+        }
+    }
+
+    // Gains of frames in_uFirst to in_uFirst + in_uFrames - 1 of a linear ramp, written as by ComputeCurveGains
+    template <typename V>
+    AkForceInline void ComputeLinearGains(AkReal32* out_pGains, AkUInt32 in_uFirst, AkUInt32 in_uFrames, const WoaGainDSP::BufferGain& in_gain)
+    {
+        const typename V::F vStart = V::Set(in_gain.fRampStart);
+        const typename V::F vInc = V::Set(in_gain.fRampInc);
+        const typename V::F vStep = V::Set((AkReal32)V::FramesPerVector);
+        typename V::F vIndex = V::Ramp(in_uFirst);
+        for (AkUInt32 i = 0; i < in_uFrames; i += V::FramesPerVector)
+        {
+            V::Store(out_pGains + i, V::MAdd(vInc, vIndex, vStart));
+            vIndex = V::Add(vIndex, vStep);
+        }
+    }
+
+    // Multiplies the gains of frames in_uFirst to in_uFirst + in_uFrames - 1, computed above, by the
+    // scale ramp of in_gain
+    template <typename V>
+    AkForceInline void ScaleGains(AkReal32* io_pGains, AkUInt32 in_uFirst, AkUInt32 in_uFrames, const WoaGainDSP::BufferGain& in_gain)
+    {
+        const typename V::F vStart = V::Set(in_gain.fScaleStart);
+        const typename V::F vInc = V::Set(in_gain.fScaleInc);
+        const typename V::F vStep = V::Set((AkReal32)V::FramesPerVector);
+        typename V::F vIndex = V::Ramp(in_uFirst);
+        for (AkUInt32 i = 0; i < in_uFrames; i += V::FramesPerVector)
+        {
+            V::Store(io_pGains + i, V::Mul(V::Load(io_pGains + i), V::MAdd(vInc, vIndex, vStart)));
+            vIndex = V::Add(vIndex, vStep);
+        }
+    }
+
+    // Multiplies in_uFrames samples of io_pBuf by the gains of in_pGains, which need not be aligned
+    template <typename V>
+    AkForceInline void ApplyGains(AkReal32* AK_RESTRICT io_pBuf, const AkReal32* AK_RESTRICT in_pGains, AkUInt32 in_uFrames)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+            io_pBuf[i] *= in_pGains[i];
+
+        for (; i + V::FramesPerVector <= in_uFrames; i += V::FramesPerVector)
+            V::Store(io_pBuf + i, V::Mul(V::Load(io_pBuf + i), V::LoadU(in_pGains + i)));
+
+        for (; i < in_uFrames; ++i)
+            io_pBuf[i] *= in_pGains[i];
+    }
+
+    // Same as ApplyGains, measuring the input into io_in and the output into io_out
+    template <typename V>
+    AkForceInline void ApplyGainsMeter(AkReal32* AK_RESTRICT io_pBuf, const AkReal32* AK_RESTRICT in_pGains, AkUInt32 in_uFrames, WoaGainDSP::Meter& io_in, WoaGainDSP::Meter& io_out)
+    {
+        const AkUInt32 uHead = FramesToAlignment<V>(io_pBuf, in_uFrames);
+
+        AkReal32 fSumSqIn = 0.f;
+        AkReal32 fSumSqOut = 0.f;
+        AkReal32 fPeakIn = io_in.fPeak;
+        AkReal32 fPeakOut = io_out.fPeak;
+        AkUInt32 i = 0;
+        for (; i < uHead; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            const AkReal32 fOut = fIn * in_pGains[i];
+            fSumSqIn += fIn * fIn;
+            fSumSqOut += fOut * fOut;
+            fPeakIn = MaxReal(fPeakIn, fabsf(fIn));
+            fPeakOut = MaxReal(fPeakOut, fabsf(fOut));
+            io_pBuf[i] = fOut;
+        }
+
+        typename V::F vSumIn = V::SetZero();
+        typename V::F vSumOut = V::SetZero();
+        typename V::F vPeakIn = V::SetZero();
+        typename V::F vPeakOut = V::SetZero();
+        for (; i + V::FramesPerVector <= in_uFrames; i += V::FramesPerVector)
+        {
+            const typename V::F vIn = V::Load(io_pBuf + i);
+            const typename V::F vOut = V::Mul(vIn, V::LoadU(in_pGains + i));
+            vSumIn = V::MAdd(vIn, vIn, vSumIn);
+            vSumOut = V::MAdd(vOut, vOut, vSumOut);
+            vPeakIn = V::Max(vPeakIn, V::Abs(vIn));
+            vPeakOut = V::Max(vPeakOut, V::Abs(vOut));
+            V::Store(io_pBuf + i, vOut);
+        }
+        fSumSqIn += V::HorizontalAdd(vSumIn);
+        fSumSqOut += V::HorizontalAdd(vSumOut);
+        fPeakIn = MaxReal(fPeakIn, V::HorizontalMax(vPeakIn));
+        fPeakOut = MaxReal(fPeakOut, V::HorizontalMax(vPeakOut));
+
+        for (; i < in_uFrames; ++i)
+        {
+            const AkReal32 fIn = io_pBuf[i];
+            const AkReal32 fOut = fIn * in_pGains[i];
+            fSumSqIn += fIn * fIn;
+            fSumSqOut += fOut * fOut;
+            fPeakIn = MaxReal(fPeakIn, fabsf(fIn));
+            fPeakOut = MaxReal(fPeakOut, fabsf(fOut));
+            io_pBuf[i] = fOut;
+        }
+
+        io_in.fSumSq += fSumSqIn;
+        io_in.fPeak = fPeakIn;
+        io_out.fSumSq += fSumSqOut;
+        io_out.fPeak = fPeakOut;
+    }
+
+    // Ramp of a dB curve or a scaled ramp over the first in_gain.uRampFrames frames of every channel,
+    // in blocks of kCurveBlockFrames gains shared by the channels. Metered when io_pMeters is not null.
+    template <typename V>
+    AkForceInline void ApplyComputedRamp(AkAudioBuffer* io_pBuffer, AkUInt32 in_uNumChannels, const WoaGainDSP::BufferGain& in_gain, WoaGainDSP::ChannelMeter* io_pMeters)
+    {
+        typename V::F gainVectors[kCurveBlockFrames / V::FramesPerVector];
+        AkReal32* pGains = (AkReal32*)gainVectors;
+        for (AkUInt32 uFirst = 0; uFirst < in_gain.uRampFrames; uFirst += kCurveBlockFrames)
+        {
+            const AkUInt32 uFrames = in_gain.uRampFrames - uFirst < kCurveBlockFrames ? in_gain.uRampFrames - uFirst : kCurveBlockFrames;
+            if (in_gain.eCurve == WoaGainDSP::Curve_SCurve)
+                ComputeCurveGains<V, true>(pGains, uFirst, uFrames, in_gain);
+            else if (in_gain.eCurve == WoaGainDSP::Curve_Decibel)
+                ComputeCurveGains<V, false>(pGains, uFirst, uFrames, in_gain);
+            else
+                ComputeLinearGains<V>(pGains, uFirst, uFrames, in_gain);
+            if (in_gain.fScaleInc != 0.f)
+                ScaleGains<V>(pGains, uFirst, uFrames, in_gain);
+
+            for (AkUInt32 i = 0; i < in_uNumChannels; ++i)
+            {
+                AkReal32* AK_RESTRICT pBuf = (AkReal32* AK_RESTRICT)io_pBuffer->GetChannel(i) + uFirst;
+                if (io_pMeters)
+                    ApplyGainsMeter<V>(pBuf, pGains, uFrames, io_pMeters[i].in, io_pMeters[i].out);
+                else
+                    ApplyGains<V>(pBuf, pGains, uFrames);
+            }
+        }
+    }
+
+    // Flat gain over in_uFrames frames, with fast paths for the unity and mute gains
+    template <typename V>
+    AkForceInline void ApplyFlatGain(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain)
+    {
+        if (in_fGain == 1.f)
+            return;
+        if (in_fGain == 0.f)
+            memset(io_pBuf, 0, in_uFrames * sizeof(AkReal32));
+        else
+            ApplyGain<V>(io_pBuf, in_uFrames, in_fGain);
+    }
+
+    // Same as ApplyFlatGain, measuring the input into io_in
+    template <typename V>
+    AkForceInline void ApplyFlatGainMeter(AkReal32* AK_RESTRICT io_pBuf, AkUInt32 in_uFrames, AkReal32 in_fGain, WoaGainDSP::Meter& io_in)
+    {
+        if (in_fGain == 1.f || in_fGain == 0.f)
+        {
+            ApplyGainMeter<V, false>(io_pBuf, in_uFrames, in_fGain, io_in);
+            if (in_fGain == 0.f)
+                memset(io_pBuf, 0, in_uFrames * sizeof(AkReal32));
+        }
+        else
+        {
+            ApplyGainMeter<V, true>(io_pBuf, in_uFrames, in_fGain, io_in);
+        }
+    }
+
+    // in_uNumChannels is a compile-time constant in the specialized kernels, 0 selects the generic kernel
+    template <typename V, AkUInt32 in_uNumChannels>
+    void ProcessBuffer(AkAudioBuffer* io_pBuffer, const WoaGainDSP::BufferGain& in_gain, WoaGainDSP::ChannelMeter* /*io_pMeters*/)
+    {
+        const AkUInt32 uNumChannels = in_uNumChannels ? in_uNumChannels : io_pBuffer->NumChannels();
+        const AkUInt32 uFlatFrames = in_gain.uFrames - in_gain.uRampFrames;
+        const bool bComputedRamp = in_gain.uRampFrames > 0 && (in_gain.eCurve != WoaGainDSP::Curve_Linear || in_gain.fScaleInc != 0.f);
+        if (bComputedRamp)
+            ApplyComputedRamp<V>(io_pBuffer, uNumChannels, in_gain, nullptr);
+        for (AkUInt32 i = 0; i < uNumChannels; ++i)
+        {
+            AkReal32* AK_RESTRICT pBuf = (AkReal32* AK_RESTRICT)io_pBuffer->GetChannel(i);
+            if (in_gain.uRampFrames > 0 && !bComputedRamp)
+                ApplyGainRamp<V>(pBuf, in_gain.uRampFrames, in_gain.fRampStart, in_gain.fRampInc);
+            ApplyFlatGain<V>(pBuf + in_gain.uRampFrames, uFlatFrames, in_gain.fGain);
+        }
+    }
+
+    template <typename V, AkUInt32 in_uNumChannels>
+    void ProcessBufferMetered(AkAudioBuffer* io_pBuffer, const WoaGainDSP::BufferGain& in_gain, WoaGainDSP::ChannelMeter* io_pMeters)
+    {
+        const AkUInt32 uNumChannels = in_uNumChannels ? in_uNumChannels : io_pBuffer->NumChannels();
+        const AkUInt32 uFlatFrames = in_gain.uFrames - in_gain.uRampFrames;
+        const AkReal32 fGainSq = in_gain.fGain * in_gain.fGain;
+        const AkReal32 fGainAbs = fabsf(in_gain.fGain);
+        const bool bComputedRamp = in_gain.uRampFrames > 0 && (in_gain.eCurve != WoaGainDSP::Curve_Linear || in_gain.fScaleInc != 0.f);
+        if (bComputedRamp)
+            ApplyComputedRamp<V>(io_pBuffer, uNumChannels, in_gain, io_pMeters);
+        for (AkUInt32 i = 0; i < uNumChannels; ++i)
+        {
+            AkReal32* AK_RESTRICT pBuf = (AkReal32* AK_RESTRICT)io_pBuffer->GetChannel(i);
+            WoaGainDSP::ChannelMeter& meter = io_pMeters[i];
+
+            // Output statistics of the flat part follow from its input statistics,
+            // only ramped frames are measured on both sides
+            if (in_gain.uRampFrames > 0 && !bComputedRamp)
+                ApplyGainRampMeter<V>(pBuf, in_gain.uRampFrames, in_gain.fRampStart, in_gain.fRampInc, meter.in, meter.out);
+
+            WoaGainDSP::Meter flatIn;
+            ApplyFlatGainMeter<V>(pBuf + in_gain.uRampFrames, uFlatFrames, in_gain.fGain, flatIn);
+
+            meter.in.fSumSq += flatIn.fSumSq;
+            meter.in.fPeak = MaxReal(meter.in.fPeak, flatIn.fPeak);
+            meter.out.fSumSq += flatIn.fSumSq * fGainSq;
+            meter.out.fPeak = MaxReal(meter.out.fPeak, flatIn.fPeak * fGainAbs);
+        }
+    }
+
+    template <typename V, AkUInt32 in_uNumChannels>
+    WoaGainDSP::ProcessFunc SelectProcessFunc(bool in_bMetering)
+    {
+        return in_bMetering ? ProcessBufferMetered<V, in_uNumChannels> : ProcessBuffer<V, in_uNumChannels>;
+    }
+
+    // See WoaGainDSP::GetProcessFunc
+    template <typename V>
+    WoaGainDSP::ProcessFunc GetProcessFunc(AkUInt32 in_uNumChannels, bool in_bMetering)
+    {
+        switch (in_uNumChannels)
+        {
+        case 1: return SelectProcessFunc<V, 1>(in_bMetering);     // Mono
+        case 2: return SelectProcessFunc<V, 2>(in_bMetering);     // Stereo
+        case 6: return SelectProcessFunc<V, 6>(in_bMetering);     // 5.1
+        case 8: return SelectProcessFunc<V, 8>(in_bMetering);     // 7.1
+        case 12: return SelectProcessFunc<V, 12>(in_bMetering);   // 7.1.4
+        default: return SelectProcessFunc<V, 0>(in_bMetering);
+        }
+    }
+}
+}
+
+#endif // WoaGainDSPKernels_H
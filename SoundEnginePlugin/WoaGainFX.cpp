@@ -25,27 +25,92 @@ the specific language governing permissions and limitations under the License.
 *******************************************************************************/
 
 #include "WoaGainFX.h"
+#include "WoaGainAlloc.h"
+#include "WoaGainAutoGain.h"
+#include "WoaGainLevelRegistry.h"
+#include "WoaGainLoudness.h"
 #include "../WoaGainConfig.h"
+#include "../WoaGainMonitorData.h"
+#include "WoaGainPool.h"
 
 #include <AK/AkWwiseSDKVersion.h>
+#include <AK/Tools/Common/AkAssert.h>
+#ifdef WOAGAIN_ENABLE_STATS
+#include <AK/Tools/Common/AkPlatformFuncs.h>
+#endif
+
+#include <string.h>
 
 AK::IAkPlugin* CreateWoaGainFX(AK::IAkPluginMemAlloc* in_pAllocator)
 {
-    return AK_PLUGIN_NEW(in_pAllocator, WoaGainFX());
+#ifdef WOAGAIN_POOLED_ALLOC
+    return WoaGainPool::New<WoaGainFX>(in_pAllocator);
+#else
+    return WoaGainAlloc::New<WoaGainFX>(in_pAllocator);
+#endif
 }
 
 AK::IAkPluginParam* CreateWoaGainFXParams(AK::IAkPluginMemAlloc* in_pAllocator)
 {
-    return AK_PLUGIN_NEW(in_pAllocator, WoaGainFXParams());
+#ifdef WOAGAIN_POOLED_ALLOC
+    return WoaGainPool::New<WoaGainFXParams>(in_pAllocator);
+#else
+    return WoaGainAlloc::New<WoaGainFXParams>(in_pAllocator);
+#endif
 }
 
 AK_IMPLEMENT_PLUGIN_FACTORY(WoaGainFX, AkPluginTypeEffect, WoaGainConfig::CompanyID, WoaGainConfig::PluginID)
 
+static_assert(WoaGainDSP::Path_Count == WoaGainMonitorData::NumPaths, "Monitor data path counts must match WoaGainDSP::Path");
+
+// Minimum of the gain property in WoaGain.xml
+static const AkReal32 GAIN_FLOOR_DB = -96.f;
+
 WoaGainFX::WoaGainFX()
     : m_pParams(nullptr)
-    , m_pAllocator(nullptr)
+    , m_params()
     , m_pContext(nullptr)
+    , m_pAllocator(nullptr)
+    , m_uSampleRate(0)
+    , m_channelConfig()
+    , m_uNumChannels(0)
+    , m_fnProcess(nullptr)
+    , m_fnProcessMetered(nullptr)
+    , m_pMeters(nullptr)
+    , m_pLoudness(nullptr)
+    , m_pAutoGain(nullptr)
+    , m_fGainOffset(1.f)
+    , m_uMeterFrames(0)
+    , m_uMeterIntervalFrames(0)
+    , m_uLevelKey(0)
+    , m_uLevelSlot(WoaGainLevelRegistry::InvalidSlot)
+    , m_fGain(1.f)
+    , m_fTargetGain(1.f)
+    , m_fGainInc(0.f)
+    , m_uRampFrames(0)
+    , m_uRampLength(0)
+    , m_fRampStartGain(1.f)
+    , m_eRampCurve(WoaGainDSP::Curve_Linear)
+    , m_fRampPos(0.f)
+    , m_fRampFromDb(0.f)
+    , m_fRampRangeDb(0.f)
+    , m_fCorrection(1.f)
+    , m_fTargetCorrection(1.f)
+    , m_fTargetCorrectionDb(0.f)
+    , m_fCorrectionInc(0.f)
+    , m_fCorrectionStart(1.f)
+    , m_uCorrectionFrames(0)
+    , m_uCorrectionLength(0)
+    , m_uFrame(0)
+    , m_uEventFrames(0)
+    , m_fEventGainDb(0.f)
+    , m_bEventGain(false)
 {
+    for (AkUInt32 i = 0; i < WoaGainDSP::Path_Count; ++i)
+    {
+        m_uPathCounts[i] = 0;
+        m_uMeterPathCounts[i] = 0;
+    }
 }
 
 WoaGainFX::~WoaGainFX()
@@ -55,20 +120,73 @@ WoaGainFX::~WoaGainFX()
 AKRESULT WoaGainFX::Init(AK::IAkPluginMemAlloc* in_pAllocator, AK::IAkEffectPluginContext* in_pContext, AK::IAkPluginParam* in_pParams, AkAudioFormat& in_rFormat)
 {
     m_pParams = (WoaGainFXParams*)in_pParams;
-    m_pAllocator = in_pAllocator;
     m_pContext = in_pContext;
+    m_pAllocator = in_pAllocator;
+    m_uSampleRate = in_rFormat.uSampleRate;
+    m_channelConfig = in_rFormat.channelConfig;
+    m_uNumChannels = in_rFormat.GetNumChannels();
+    WoaGainFXParams::GetDefaults(m_params);
+#ifdef WOAGAIN_POOLED_ALLOC
+    WoaGainPool::RegisterTermCallback(in_pContext->GlobalContext(), AkPluginTypeEffect, WoaGainConfig::CompanyID, WoaGainConfig::PluginID);
+#endif
 
-    return AK_Success;
+    // The channel configuration of an in-place effect is fixed: pick its kernels once
+    m_fnProcess = WoaGainDSP::GetProcessFunc(m_uNumChannels, false);
+    m_fnProcessMetered = WoaGainDSP::GetProcessFunc(m_uNumChannels, true);
+    if (m_uNumChannels > 0)
+    {
+        m_pMeters = (WoaGainDSP::ChannelMeter*)WoaGainAlloc::Alloc(in_pAllocator, sizeof(WoaGainDSP::ChannelMeter) * m_uNumChannels);
+        if (!m_pMeters)
+            return AK_InsufficientMemory;
+    }
+
+    return Reset();
 }
 
 AKRESULT WoaGainFX::Term(AK::IAkPluginMemAlloc* in_pAllocator)
 {
+    if (m_pMeters)
+        AK_PLUGIN_FREE(in_pAllocator, m_pMeters);
+    if (m_pLoudness)
+        m_pLoudness->Destroy(in_pAllocator);
+    if (m_pAutoGain)
+        m_pAutoGain->Destroy(in_pAllocator);
+    WoaGainLevelRegistry::Release(m_uLevelSlot);
+#ifdef WOAGAIN_POOLED_ALLOC
+    WoaGainPool::Delete(this);
+#else
     AK_PLUGIN_DELETE(in_pAllocator, this);
+#endif
     return AK_Success;
 }
 
 AKRESULT WoaGainFX::Reset()
 {
+    // Start from the current parameter value without ramping. Events still queued apply from the
+    // next buffer, on the same frame clock. The read is bounded like those of Execute: when writers
+    // keep it from going through, the previous values are kept, the defaults set by Init on the
+    // first reset, and every parameter is flagged so that the next buffer applies the whole set.
+    // A clone has no changes flagged otherwise, and no later snapshot would replace them.
+    if (!m_pParams->GetSnapshot(m_params))
+        m_pParams->FlagAllChanged();
+    m_bEventGain = false;
+    m_uEventFrames = 0;
+    UpdateGainOffset();
+    UpdateAutoGain();
+    if (m_pAutoGain)
+        m_pAutoGain->Reset();
+    m_fGain = m_fTargetGain = GetTargetGain();
+    m_fGainInc = 0.f;
+    m_uRampFrames = 0;
+    m_eRampCurve = WoaGainDSP::Curve_Linear;
+    RampCorrection(0.f, 0);
+
+    UpdateMeterInterval();
+    UpdateLoudnessMeter();
+    if (m_pLoudness)
+        m_pLoudness->Reset();
+    UpdateLevelSlot();
+    ResetMeters();
     return AK_Success;
 }
 
@@ -82,51 +200,547 @@ AKRESULT WoaGainFX::GetPluginInfo(AkPluginInfo& out_rPluginInfo)
 
 #define AK_LINTODB( __lin__ ) (log10f(__lin__) * 20.f)
 
+AkForceInline void WoaGainFX::ExecuteOne(AkAudioBuffer* io_pBuffer)
+{
+#ifdef WOAGAIN_ENABLE_STATS
+    AkInt64 iStart, iEnd;
+    AKPLATFORM::PerformanceCounter(&iStart);
+#endif
+    bool bMetered;
+    BeginBuffer(io_pBuffer, bMetered);
+    const WoaGainDSP::Path ePath = ProcessParts(io_pBuffer, bMetered);
+    EndBuffer(io_pBuffer->uValidFrames, ePath, bMetered);
+#ifdef WOAGAIN_ENABLE_STATS
+    AKPLATFORM::PerformanceCounter(&iEnd);
+    m_stats.Record(iEnd - iStart, io_pBuffer->uValidFrames, ePath, bMetered);
+#endif
+}
+
 void WoaGainFX::Execute(AkAudioBuffer* io_pBuffer)
 {
-    const AkUInt32 uNumChannels = io_pBuffer->NumChannels();
+    AKASSERT(io_pBuffer->NumChannels() == m_uNumChannels);
+    ExecuteOne(io_pBuffer);
+}
 
-    // Monitor Data
-    AkReal32 rmsBefore = 0.f;
-    AkReal32 rmsAfter = 0.f;
+void WoaGainFX::ExecuteBatch(WoaGainFX* const* in_ppInstances, AkAudioBuffer* const* io_ppBuffers, AkUInt32 in_uNumInstances)
+{
+    for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+    {
+        AKASSERT(io_ppBuffers[i]->NumChannels() == in_ppInstances[i]->m_uNumChannels);
+        in_ppInstances[i]->ExecuteOne(io_ppBuffers[i]);
+    }
+}
 
-    AkUInt16 uFramesProcessed;
-    for (AkUInt32 i = 0; i < uNumChannels; ++i)
+void WoaGainFX::BeginBuffer(AkAudioBuffer* in_pBuffer, bool& out_bMetered)
+{
+    const AkUInt16 uValidFrames = in_pBuffer->uValidFrames;
+    ApplyParamChanges(uValidFrames);
+
+    // Events posted from now on are scheduled from the end of this buffer
+    m_pParams->SetNextBufferFrame(m_uFrame + uValidFrames);
+
+    // The input is measured before the kernel processes the buffer in place. Corrections are
+    // ramped over a block, which makes the correction piecewise linear between block updates,
+    // on their own so that a smoothing or event ramp keeps its length and curve.
+    if (m_pAutoGain && m_pAutoGain->Process(in_pBuffer, uValidFrames, m_params))
+        RampCorrection(m_pAutoGain->GetCorrectionDb(), m_pAutoGain->GetBlockFrames());
+
+    out_bMetered = IsMetering() && uValidFrames > 0;
+}
+
+AkForceInline WoaGainDSP::Path WoaGainFX::ProcessParts(AkAudioBuffer* io_pBuffer, bool in_bMetered)
+{
+    // Without gain events, or a correction ramp during a gain ramp, the buffer is processed in one part
+    const AkUInt32 uFrames = BeginPart(io_pBuffer->uValidFrames);
+    const WoaGainDSP::Path ePath = ProcessPart(io_pBuffer, uFrames, in_bMetered);
+    return uFrames == io_pBuffer->uValidFrames ? ePath : ProcessLaterParts(io_pBuffer, uFrames, ePath, in_bMetered);
+}
+
+WoaGainDSP::Path WoaGainFX::ProcessLaterParts(AkAudioBuffer* io_pBuffer, AkUInt32 in_uFirst, WoaGainDSP::Path in_ePath, bool in_bMetered)
+{
+    // Parts after a gain event are processed through a buffer starting at their first frame
+    const AkUInt32 uValidFrames = io_pBuffer->uValidFrames;
+    WoaGainDSP::Path eBufferPath = in_ePath;
+    AkAudioBuffer part;
+    for (AkUInt32 uFirst = in_uFirst, uFrames = 0; uFirst < uValidFrames; uFirst += uFrames)
     {
-        AkReal32* AK_RESTRICT pBuf = (AkReal32* AK_RESTRICT)io_pBuffer->GetChannel(i);
+        uFrames = BeginPart(uValidFrames - uFirst);
+        part.AttachContiguousDeinterleavedData(io_pBuffer->GetChannel(0) + uFirst, io_pBuffer->MaxFrames(), (AkUInt16)uFrames, io_pBuffer->GetChannelConfig());
+        const WoaGainDSP::Path ePath = ProcessPart(&part, uFrames, in_bMetered);
+        eBufferPath = ePath > eBufferPath ? ePath : eBufferPath;
+    }
+    return eBufferPath;
+}
 
-        uFramesProcessed = 0;
-        while (uFramesProcessed < io_pBuffer->uValidFrames)
-        {
-            if (m_pContext->CanPostMonitorData())
-                rmsBefore += powf(pBuf[uFramesProcessed], 2);
+AkForceInline WoaGainDSP::Path WoaGainFX::ProcessPart(AkAudioBuffer* io_pBuffer, AkUInt32 in_uFrames, bool in_bMetered)
+{
+    WoaGainDSP::BufferGain gain;
+    GetPartGain(in_uFrames, gain);
+    const WoaGainDSP::Path ePath = WoaGainDSP::GetPath(gain);
+    if (in_bMetered)
+        ProcessMetered(io_pBuffer, gain);
+    else if (ePath != WoaGainDSP::Path_Unity)   // At unity gain the buffer is left as is
+        m_fnProcess(io_pBuffer, gain, nullptr);
+    EndPart(in_uFrames);
+    return ePath;
+}
 
-            pBuf[uFramesProcessed] = pBuf[uFramesProcessed] * AK_DBTOLIN(m_pParams->RTPC.fDummy);
+void WoaGainFX::ProcessMetered(AkAudioBuffer* io_pBuffer, const WoaGainDSP::BufferGain& in_gain)
+{
+    m_fnProcessMetered(io_pBuffer, in_gain, m_pMeters);
 
-            if (m_pContext->CanPostMonitorData())
-                rmsAfter += powf(pBuf[uFramesProcessed], 2);
+    // Measured on the output, in the same pass over the buffer while it is still in the cache
+    if (m_pLoudness)
+        m_pLoudness->Process(io_pBuffer, in_gain.uFrames);
+}
 
-            ++uFramesProcessed;
+void WoaGainFX::EndBuffer(AkUInt32 in_uFrames, WoaGainDSP::Path in_ePath, bool in_bMetered)
+{
+    // Path counts are posted for the buffers of the monitored interval only
+    if (in_bMetered && m_uMeterFrames == 0)
+        memset(m_uMeterPathCounts, 0, sizeof(m_uMeterPathCounts));
+    ++m_uPathCounts[in_ePath];
+    ++m_uMeterPathCounts[in_ePath];
+
+    if (in_bMetered)
+    {
+        m_uMeterFrames += in_uFrames;
+        if (m_uMeterFrames >= m_uMeterIntervalFrames)
+            EndMeterInterval();
+    }
+    else if (m_uMeterFrames > 0)
+    {
+        // Levels gathered before metering stopped would be stale by the time it resumes
+        ResetMeters();
+    }
+}
+
+AkForceInline AkUInt32 WoaGainFX::BeginPart(AkUInt32 in_uFrames)
+{
+    // The ramp toward an event ends on its frame, whatever the buffer boundaries: it spans the
+    // frames from the previous event, or from the current frame for the first one. A late event
+    // is reached on the next frame.
+    WoaGainEvent event;
+    if (m_uEventFrames == 0 && m_pParams->PeekGainEvent(event))
+    {
+        m_pParams->PopGainEvent();
+        const AkInt32 iFrames = (AkInt32)(event.uFrame - m_uFrame) + 1;
+        m_uEventFrames = iFrames > 1 ? (AkUInt32)iFrames : 1;
+        m_fEventGainDb = event.fGainDb;
+        m_bEventGain = true;
+        RampGain(GetTargetGain(), m_uEventFrames, GetSmoothingCurve());
+    }
+    AkUInt32 uFrames = m_uEventFrames > 0 && m_uEventFrames < in_uFrames ? m_uEventFrames : in_uFrames;
+
+    // While both ramp, the correction scales every frame of the part, see ApplyCorrection
+    if (m_uRampFrames > 0 && m_uCorrectionFrames > 0)
+    {
+        const AkUInt32 uRampFrames = m_uRampFrames < m_uCorrectionFrames ? m_uRampFrames : m_uCorrectionFrames;
+        uFrames = uRampFrames < uFrames ? uRampFrames : uFrames;
+    }
+    return uFrames;
+}
+
+AkForceInline void WoaGainFX::GetPartGain(AkUInt32 in_uFrames, WoaGainDSP::BufferGain& out_gain) const
+{
+    // Ramped frames at the start, the remainder is processed at the flat target gain
+    out_gain.uFrames = in_uFrames;
+    out_gain.uRampFrames = m_uRampFrames < in_uFrames ? m_uRampFrames : in_uFrames;
+    out_gain.fRampStart = m_eRampCurve == WoaGainDSP::Curve_Linear ? m_fGain : m_fRampPos;
+    out_gain.fRampInc = m_fGainInc;
+    out_gain.fGain = m_fTargetGain;
+    out_gain.eCurve = m_eRampCurve;
+    out_gain.fRampFromDb = m_fRampFromDb;
+    out_gain.fRampRangeDb = m_fRampRangeDb;
+    out_gain.fScaleStart = 1.f;
+    out_gain.fScaleInc = 0.f;
+    if (m_fCorrection != 1.f || m_uCorrectionFrames > 0)
+        ApplyCorrection(in_uFrames, out_gain);
+}
+
+AkForceInline void WoaGainFX::ApplyCorrection(AkUInt32 in_uFrames, WoaGainDSP::BufferGain& io_gain) const
+{
+    if (m_uCorrectionFrames == 0)
+    {
+        // A flat correction scales a linear ramp and offsets a dB curve, both exactly
+        if (io_gain.eCurve == WoaGainDSP::Curve_Linear)
+        {
+            io_gain.fRampStart *= m_fCorrection;
+            io_gain.fRampInc *= m_fCorrection;
         }
+        else
+        {
+            io_gain.fRampFromDb += m_fTargetCorrectionDb;
+        }
+    }
+    else if (io_gain.uRampFrames == 0)
+    {
+        // Over a flat gain, the correction ramp is the ramp of the part
+        io_gain.uRampFrames = m_uCorrectionFrames < in_uFrames ? m_uCorrectionFrames : in_uFrames;
+        io_gain.fRampStart = io_gain.fGain * m_fCorrection;
+        io_gain.fRampInc = io_gain.fGain * m_fCorrectionInc;
+        io_gain.eCurve = WoaGainDSP::Curve_Linear;
+    }
+    else
+    {
+        // Both ramp over the whole part, see BeginPart: the kernel multiplies them frame by frame
+        io_gain.fScaleStart = m_fCorrection;
+        io_gain.fScaleInc = m_fCorrectionInc;
+    }
+    io_gain.fGain *= m_fTargetCorrection;
+}
+
+AkForceInline void WoaGainFX::EndPart(AkUInt32 in_uFrames)
+{
+    AdvanceGainRamp(m_uRampFrames < in_uFrames ? m_uRampFrames : in_uFrames);
+    AdvanceCorrectionRamp(m_uCorrectionFrames < in_uFrames ? m_uCorrectionFrames : in_uFrames);
+    if (m_uEventFrames > 0)
+        m_uEventFrames -= in_uFrames;
+    m_uFrame += in_uFrames;
+}
+
+void WoaGainFX::ApplyParamChanges(AkUInt32 in_uFrames)
+{
+    // Parameters are read once per buffer, from a consistent snapshot, and gain changes turned into a ramp.
+    // Most buffers have no change: the snapshot of the previous buffer is kept.
+    if (!m_pParams->HasChanges())
+        return;
+    m_pParams->GetSnapshot(m_params);
+    if (m_params.HasChanged(PARAM_AUTO_GAIN_ID))
+    {
+        // Turned off, the correction returns to 0 dB as smoothly as a parameter change
+        UpdateAutoGain();
+        RampCorrection(m_pAutoGain ? m_pAutoGain->GetCorrectionDb() : 0.f, GetSmoothingFrames(in_uFrames));
+    }
+    if (m_params.HasChanged(PARAM_GAIN_OFFSETS_ID))
+        UpdateGainOffset();
+    if (m_params.HasChanged(PARAM_DUMMY_ID))
+    {
+        // The parameter takes over from the events, which apply again from the next one
+        m_bEventGain = false;
+        m_uEventFrames = 0;
+    }
+    if (m_params.HasChanged(PARAM_DUMMY_ID) || m_params.HasChanged(PARAM_GAIN_OFFSETS_ID))
+        StartGainRamp(GetTargetGain(), in_uFrames);
+    if (m_params.HasChanged(PARAM_METER_RATE_ID))
+        UpdateMeterInterval();
+    if (m_params.HasChanged(PARAM_LOUDNESS_ID))
+        UpdateLoudnessMeter();
+    if (m_params.HasChanged(PARAM_LEVEL_KEY_ID))
+        UpdateLevelSlot();
+}
+
+void WoaGainFX::AdvanceGainRamp(AkUInt32 in_uRampFrames)
+{
+    m_uRampFrames -= in_uRampFrames;
+    if (m_uRampFrames == 0)
+    {
+        m_fGain = m_fTargetGain;
+        return;
+    }
+
+    // Computed from the frames done rather than accumulated, so that the rounding does not
+    // depend on how the ramp is split into buffers
+    const AkReal32 fFramesDone = (AkReal32)(m_uRampLength - m_uRampFrames);
+    if (m_eRampCurve == WoaGainDSP::Curve_Linear)
+    {
+        m_fGain = m_fRampStartGain + m_fGainInc * fFramesDone;
+    }
+    else
+    {
+        m_fRampPos = m_fGainInc * fFramesDone;
+        m_fGain = WoaGainDSP::DbToLinFast(GetCurveRampDb());
+    }
+}
+
+void WoaGainFX::AdvanceCorrectionRamp(AkUInt32 in_uRampFrames)
+{
+    m_uCorrectionFrames -= in_uRampFrames;
+    if (m_uCorrectionFrames == 0)
+        m_fCorrection = m_fTargetCorrection;
+    else
+        m_fCorrection = m_fCorrectionStart + m_fCorrectionInc * (AkReal32)(m_uCorrectionLength - m_uCorrectionFrames);
+}
+
+AkReal32 WoaGainFX::GetCurveRampDb() const
+{
+    const AkReal32 fShape = m_eRampCurve == WoaGainDSP::Curve_SCurve ? m_fRampPos * m_fRampPos * (3.f - 2.f * m_fRampPos) : m_fRampPos;
+    return m_fRampFromDb + m_fRampRangeDb * fShape;
+}
+
+AkReal32 WoaGainFX::GetLinearGain(AkReal32 in_fGainDb)
+{
+    return in_fGainDb > GAIN_FLOOR_DB ? AK_DBTOLIN(in_fGainDb) : 0.f;
+}
+
+AkReal32 WoaGainFX::GetRampGainDb(AkReal32 in_fGain)
+{
+    const AkReal32 fGainDb = in_fGain > 0.f ? AK_LINTODB(in_fGain) : GAIN_FLOOR_DB;
+    return fGainDb > GAIN_FLOOR_DB ? fGainDb : GAIN_FLOOR_DB;
+}
+
+WoaGainDSP::Curve WoaGainFX::GetSmoothingCurve() const
+{
+    const AkInt32 iCurve = m_params.NonRTPC.iSmoothingCurve;
+    return iCurve > 0 && iCurve < WoaGainDSP::Curve_Count ? (WoaGainDSP::Curve)iCurve : WoaGainDSP::Curve_Linear;
+}
+
+AkReal32 WoaGainFX::GetTargetGain() const
+{
+    return GetLinearGain(m_bEventGain ? m_fEventGainDb : m_params.RTPC.fDummy) * m_fGainOffset;
+}
+
+void WoaGainFX::UpdateGainOffset()
+{
+    AkReal32 fOffsetDb;
+    m_pParams->FindGainOffset(m_pContext->GetNodeID(), fOffsetDb);
+    m_fGainOffset = AK_DBTOLIN(fOffsetDb);
+}
+
+void WoaGainFX::UpdateMeterInterval()
+{
+    const AkReal32 fMeterRate = m_params.NonRTPC.fMeterRate;
+    m_uMeterIntervalFrames = fMeterRate > 0.f
+        ? (AkUInt32)((AkReal32)m_uSampleRate / fMeterRate + 0.5f)
+        : 0;
+}
+
+void WoaGainFX::UpdateLoudnessMeter()
+{
+    // Allocated only while turned on, so that instances without it do not pay for its memory
+    if (m_params.NonRTPC.bLoudness && !m_pLoudness)
+    {
+        m_pLoudness = WoaGainLoudness::Create(m_pAllocator, m_channelConfig, m_uSampleRate);
+    }
+    else if (!m_params.NonRTPC.bLoudness && m_pLoudness)
+    {
+        m_pLoudness->Destroy(m_pAllocator);
+        m_pLoudness = nullptr;
+    }
+}
+
+void WoaGainFX::UpdateAutoGain()
+{
+    // Created with a neutral correction: turning auto-gain on does not change the gain until
+    // the first block of input is measured
+    if (m_params.NonRTPC.bAutoGain && !m_pAutoGain)
+    {
+        m_pAutoGain = WoaGainAutoGain::Create(m_pAllocator, m_channelConfig, m_uSampleRate);
     }
+    else if (!m_params.NonRTPC.bAutoGain && m_pAutoGain)
+    {
+        m_pAutoGain->Destroy(m_pAllocator);
+        m_pAutoGain = nullptr;
+    }
+}
+
+void WoaGainFX::UpdateLevelSlot()
+{
+    // When the registry is full, the level is not published until the key changes again
+    const AkUInt32 uLevelKey = m_params.NonRTPC.uLevelKey;
+    if (uLevelKey == m_uLevelKey)
+        return;
+    WoaGainLevelRegistry::Release(m_uLevelSlot);
+    m_uLevelSlot = uLevelKey != 0 ? WoaGainLevelRegistry::Acquire(uLevelKey) : WoaGainLevelRegistry::InvalidSlot;
+    m_uLevelKey = uLevelKey;
+}
 
+bool WoaGainFX::IsMetering() const
+{
+    return m_uLevelSlot != WoaGainLevelRegistry::InvalidSlot || m_pContext->CanPostMonitorData();
+}
+
+void WoaGainFX::ResetMeters()
+{
+    for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+        m_pMeters[i] = WoaGainDSP::ChannelMeter();
+    m_uMeterFrames = 0;
+}
+
+void WoaGainFX::EndMeterInterval()
+{
     if (m_pContext->CanPostMonitorData())
+        PostMonitorData();
+    if (m_uLevelSlot != WoaGainLevelRegistry::InvalidSlot)
+        PublishLevel();
+    ResetMeters();
+}
+
+void WoaGainFX::PostMonitorData()
+{
+    struct
+    {
+        WoaGainMonitorData::Header header;
+        WoaGainMonitorData::ChannelLevels channels[WoaGainMonitorData::MaxChannels];
+        AkUInt8 sections[sizeof(WoaGainMonitorData::PathCounts) + sizeof(WoaGainMonitorData::Loudness) + sizeof(WoaGainMonitorData::Stats)];   // Room for the optional sections
+    } monitorData;
+
+    // RMS = Root of the Mean of the Squares
+    //       sqrt( (1/n) * sum_0-n( (x_1)^2, ..., (x_n)^2 ) )
+    // Levels are posted as powers in dB, which saves the square roots.
+    const AkReal32 fInvFrames = 1.f / (AkReal32)m_uMeterFrames;
+    AkReal32 fSumSqBefore = 0.f;
+    AkReal32 fSumSqAfter = 0.f;
+    for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+    {
+        const WoaGainDSP::ChannelMeter& meter = m_pMeters[i];
+        WoaGainMonitorData::ChannelLevels& levels = monitorData.channels[i];
+        fSumSqBefore += meter.in.fSumSq;
+        fSumSqAfter += meter.out.fSumSq;
+        levels.iRmsBefore = WoaGainMonitorData::QuantizePower(meter.in.fSumSq * fInvFrames);
+        levels.iRmsAfter = WoaGainMonitorData::QuantizePower(meter.out.fSumSq * fInvFrames);
+        levels.iPeakBefore = WoaGainMonitorData::QuantizeAmplitude(meter.in.fPeak);
+        levels.iPeakAfter = WoaGainMonitorData::QuantizeAmplitude(meter.out.fPeak);
+    }
+
+    const AkReal32 fInvSamples = fInvFrames / (AkReal32)m_uNumChannels;
+    monitorData.header.uVersion = WoaGainMonitorData::Version;
+    monitorData.header.uFlags = WoaGainMonitorData::Flag_PathCounts | (m_pLoudness ? WoaGainMonitorData::Flag_Loudness : 0);
+#ifdef WOAGAIN_ENABLE_STATS
+    monitorData.header.uFlags |= WoaGainMonitorData::Flag_Stats;
+#endif
+    monitorData.header.uNumChannels = (AkUInt16)m_uNumChannels;
+    monitorData.header.iRmsBefore = WoaGainMonitorData::QuantizePower(fSumSqBefore * fInvSamples);
+    monitorData.header.iRmsAfter = WoaGainMonitorData::QuantizePower(fSumSqAfter * fInvSamples);
+
+    // Sections follow the channels in the order of their flags
+    AkUInt8* pSection = (AkUInt8*)&monitorData + WoaGainMonitorData::GetSize(m_uNumChannels);
+    WoaGainMonitorData::PathCounts pathCounts;
+    for (AkUInt32 i = 0; i < WoaGainDSP::Path_Count; ++i)
+        pathCounts.uBuffers[i] = m_uMeterPathCounts[i];
+    memcpy(pSection, &pathCounts, sizeof(pathCounts));
+    pSection += sizeof(pathCounts);
+
+    if (m_pLoudness)
+    {
+        WoaGainMonitorData::Loudness loudness;
+        loudness.fMomentary = m_pLoudness->GetMomentary();
+        loudness.fShortTerm = m_pLoudness->GetShortTerm();
+        loudness.fIntegrated = m_pLoudness->GetIntegrated();
+        memcpy(pSection, &loudness, sizeof(loudness));
+        pSection += sizeof(loudness);
+    }
+
+#ifdef WOAGAIN_ENABLE_STATS
+    WoaGainStats::Summary summary;
+    m_stats.GetSummary(summary);
+    WoaGainMonitorData::Stats stats;
+    stats.fAvgNs = summary.fAvgNs;
+    stats.fP99Ns = summary.fP99Ns;
+    stats.fMaxNs = summary.fMaxNs;
+    stats.fNsPerFrame = summary.fNsPerFrame;
+    memcpy(pSection, &stats, sizeof(stats));
+#endif
+
+    m_pContext->PostMonitorData((void*)&monitorData, WoaGainMonitorData::GetSize(m_uNumChannels, monitorData.header.uFlags));
+}
+
+void WoaGainFX::PublishLevel()
+{
+    AkReal32 fSumSq = 0.f;
+    AkReal32 fPeak = 0.f;
+    for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+    {
+        fSumSq += m_pMeters[i].out.fSumSq;
+        fPeak = m_pMeters[i].out.fPeak > fPeak ? m_pMeters[i].out.fPeak : fPeak;
+    }
+    WoaGainLevelRegistry::Publish(m_uLevelSlot, fSumSq / (AkReal32)(m_uMeterFrames * m_uNumChannels), fPeak);
+}
+
+AkUInt32 WoaGainFX::GetSmoothingFrames(AkUInt32 in_uBufferFrames) const
+{
+    const WoaGainNonRTPCParams& nonRTPC = m_params.NonRTPC;
+    const AkUInt32 uRampFrames = nonRTPC.fSmoothingTime > 0.f
+        ? (AkUInt32)(nonRTPC.fSmoothingTime * 0.001f * (AkReal32)m_uSampleRate + 0.5f)
+        : in_uBufferFrames;
+    return nonRTPC.bSmoothing ? uRampFrames : 0;
+}
+
+void WoaGainFX::StartGainRamp(AkReal32 in_fTargetGain, AkUInt32 in_uBufferFrames)
+{
+    RampGain(in_fTargetGain, GetSmoothingFrames(in_uBufferFrames), GetSmoothingCurve());
+}
+
+void WoaGainFX::RampGain(AkReal32 in_fTargetGain, AkUInt32 in_uRampFrames, WoaGainDSP::Curve in_eCurve)
+{
+    const bool bCurveRamping = m_uRampFrames > 0 && m_eRampCurve != WoaGainDSP::Curve_Linear;
+    m_fTargetGain = in_fTargetGain;
+    if (in_uRampFrames == 0 || m_fGain == in_fTargetGain)
     {
-        // RMS = Root of the Mean of the Squares
-        //       sqrt( (1/n) * sum_0-n( (x_1)^2, ..., (x_n)^2 ) )
+        m_fGain = in_fTargetGain;
+        m_fGainInc = 0.f;
+        m_uRampFrames = 0;
+        return;
+    }
 
-        rmsBefore /= (uNumChannels * io_pBuffer->uValidFrames);
-        rmsBefore = sqrtf(rmsBefore);
+    // Ramps restart from the current gain, so a change during a ramp stays continuous
+    m_uRampFrames = m_uRampLength = in_uRampFrames;
+    if (in_eCurve == WoaGainDSP::Curve_Linear)
+    {
+        m_eRampCurve = in_eCurve;
+        m_fRampStartGain = m_fGain;
+        m_fGainInc = (in_fTargetGain - m_fGain) / (AkReal32)in_uRampFrames;
+        return;
+    }
 
-        rmsAfter /= (uNumChannels * io_pBuffer->uValidFrames);
-        rmsAfter = sqrtf(rmsAfter);
+    // A ramp along a dB curve restarts from its position in dB rather than from the converted gain,
+    // so that the error of WoaGainDSP::DbToLinFast does not build up over successive changes
+    m_fRampFromDb = bCurveRamping ? GetCurveRampDb() : GetRampGainDb(m_fGain);
+    m_fRampRangeDb = GetRampGainDb(in_fTargetGain) - m_fRampFromDb;
+    m_fRampPos = 0.f;
+    m_fGainInc = 1.f / (AkReal32)in_uRampFrames;
+    m_eRampCurve = in_eCurve;
+}
 
-        AkReal32 monitorData[2] = { AK_LINTODB(rmsBefore), AK_LINTODB(rmsAfter) };
-        m_pContext->PostMonitorData((void*)monitorData, sizeof(monitorData));
+void WoaGainFX::RampCorrection(AkReal32 in_fCorrectionDb, AkUInt32 in_uRampFrames)
+{
+    m_fTargetCorrectionDb = in_fCorrectionDb;
+    m_fTargetCorrection = AK_DBTOLIN(in_fCorrectionDb);
+    if (in_uRampFrames == 0 || m_fCorrection == m_fTargetCorrection)
+    {
+        m_fCorrection = m_fTargetCorrection;
+        m_fCorrectionInc = 0.f;
+        m_uCorrectionFrames = 0;
+        return;
     }
+
+    // Restarts from the current correction, as RampGain
+    m_uCorrectionFrames = m_uCorrectionLength = in_uRampFrames;
+    m_fCorrectionStart = m_fCorrection;
+    m_fCorrectionInc = (m_fTargetCorrection - m_fCorrection) / (AkReal32)in_uRampFrames;
 }
 
 AKRESULT WoaGainFX::TimeSkip(AkUInt32 in_uFrames)
 {
+    // Same state updates as Execute processing in_uFrames frames of silence, in constant time:
+    // the ramp gain is a function of the frame position, so it advances in one step, and silence
+    // adds nothing to the meters. Each gain event due in the skipped frames takes one more step.
+    ApplyParamChanges(in_uFrames);
+    m_pParams->SetNextBufferFrame(m_uFrame + in_uFrames);
+    AkUInt32 uFirst = 0;
+    do
+    {
+        const AkUInt32 uFrames = BeginPart(in_uFrames - uFirst);
+        EndPart(uFrames);
+        uFirst += uFrames;
+    } while (uFirst < in_uFrames);
+    if (m_pAutoGain)
+        m_pAutoGain->Skip(in_uFrames);
+
+    if (IsMetering() && in_uFrames > 0)
+    {
+        if (m_uMeterFrames == 0)
+            memset(m_uMeterPathCounts, 0, sizeof(m_uMeterPathCounts));
+        if (m_pLoudness)
+            m_pLoudness->Skip(in_uFrames);
+        m_uMeterFrames += in_uFrames;
+        if (m_uMeterFrames >= m_uMeterIntervalFrames)
+            EndMeterInterval();
+    }
+    else if (m_uMeterFrames > 0)
+    {
+        ResetMeters();
+    }
+
     return AK_DataReady;
 }
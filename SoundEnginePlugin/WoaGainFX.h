@@ -28,6 +28,13 @@ the specific language governing permissions and limitations under the License.
 #define WoaGainFX_H
 
 #include "WoaGainFXParams.h"
+#include "WoaGainDSP.h"
+#ifdef WOAGAIN_ENABLE_STATS
+#include "WoaGainStats.h"
+#endif
+
+class WoaGainAutoGain;
+class WoaGainLoudness;
 
 /// See https://www.audiokinetic.com/library/edge/?source=SDK&id=soundengine__plugins__effects.html
 /// for the documentation about effect plug-ins
@@ -56,15 +63,205 @@ public:
     /// Effect plug-in DSP execution.
     void Execute(AkAudioBuffer* io_pBuffer);
 
+    /// Processes io_ppBuffers[i] with in_ppInstances[i] for every i below in_uNumInstances, with the
+    /// same result as calling Execute on each instance in turn. The instances must be distinct.
+    /// Optional entry point for hosts owning many instances, e.g. one per mono one-shot voice: the
+    /// instances are processed in one loop, without a virtual call per buffer.
+    static void ExecuteBatch(WoaGainFX* const* in_ppInstances, AkAudioBuffer* const* io_ppBuffers, AkUInt32 in_uNumInstances);
+
     /// Skips execution of some frames, when the voice is virtual playing from elapsed time.
     /// This can be used to simulate processing that would have taken place (e.g. update internal state).
     /// Return AK_DataReady or AK_NoMoreData, depending if there would be audio output or not at that point.
+    /// Gain ramps and meters advance as if in_uFrames frames of silence had been processed, in constant
+    /// time per gain event due in the skipped frames.
     AKRESULT TimeSkip(AkUInt32 in_uFrames);
 
+    /// Number of buffers processed by in_ePath since Init. Buffers split at gain events count once,
+    /// for the costliest path of their parts.
+    AkUInt64 GetPathCount(WoaGainDSP::Path in_ePath) const { return m_uPathCounts[in_ePath]; }
+
+#ifdef WOAGAIN_ENABLE_STATS
+    /// Time and frames of the Execute calls since Init, see WoaGainStats. Can be called from any thread.
+    void GetStats(WoaGainStats::Summary& out_summary) const { m_stats.GetSummary(out_summary); }
+#endif
+
 private:
+    /// Converts a gain parameter in dB to a linear gain. The -96 dB floor of the property
+    /// is a mute, so that the buffer kernels can clear the buffer instead of scaling it.
+    static AkReal32 GetLinearGain(AkReal32 in_fGainDb);
+
+    /// Converts a linear gain to dB for the ramps of dB curves, which start and end no lower than
+    /// the -96 dB floor: a ramp to a mute reaches -96 dB on its last frame.
+    static AkReal32 GetRampGainDb(AkReal32 in_fGain);
+
+    /// Smoothing curve parameter, Curve_Linear when out of range.
+    WoaGainDSP::Curve GetSmoothingCurve() const;
+
+    /// Linear gain to apply: the gain parameter or the gain of the last event, times the gain offset of the node.
+    /// The auto-gain correction is ramped on its own and multiplied in by GetPartGain.
+    AkReal32 GetTargetGain() const;
+
+    /// Frames of a ramp toward a changed parameter: the smoothing time, or the in_uBufferFrames frames
+    /// of the current buffer without one, 0 when smoothing is off.
+    AkUInt32 GetSmoothingFrames(AkUInt32 in_uBufferFrames) const;
+
+    /// Looks up the gain offset of the node the effect is inserted on, in the table of the parameters.
+    void UpdateGainOffset();
+
+    /// Picks up the parameter changes made since the last call, before processing or skipping in_uFrames frames.
+    void ApplyParamChanges(AkUInt32 in_uFrames);
+
+    /// Processes the valid frames of io_pBuffer, and times the call with execution statistics:
+    /// the body of Execute, and of ExecuteBatch for each of its instances.
+    void ExecuteOne(AkAudioBuffer* io_pBuffer);
+
+    /// Prepares the processing of the valid frames of in_pBuffer: applies the parameter changes and the
+    /// auto-gain correction measured on the input, and returns in out_bMetered whether to meter it.
+    void BeginBuffer(AkAudioBuffer* in_pBuffer, bool& out_bMetered);
+
+    /// Applies the gain to the valid frames of io_pBuffer, in parts split at the frames of the gain
+    /// events, and returns the costliest path taken. A buffer without events is processed in one part.
+    WoaGainDSP::Path ProcessParts(AkAudioBuffer* io_pBuffer, bool in_bMetered);
+
+    /// Processes the parts of io_pBuffer from frame in_uFirst on, after a first part processed by
+    /// in_ePath, and returns the costliest path taken.
+    WoaGainDSP::Path ProcessLaterParts(AkAudioBuffer* io_pBuffer, AkUInt32 in_uFirst, WoaGainDSP::Path in_ePath, bool in_bMetered);
+
+    /// Applies in_gain with the metered kernel and measures the loudness of the output when enabled.
+    void ProcessMetered(AkAudioBuffer* io_pBuffer, const WoaGainDSP::BufferGain& in_gain);
+
+    /// Completes the processing of in_uFrames frames started with BeginBuffer: counts in_ePath and
+    /// accumulates or posts the meters.
+    void EndBuffer(AkUInt32 in_uFrames, WoaGainDSP::Path in_ePath, bool in_bMetered);
+
+    /// Starts the ramp toward the next gain event once the previous one is reached, and returns how
+    /// many of the next in_uFrames frames come before the frame of the current event, included. While
+    /// the gain and the correction both ramp, the part also ends with the first ramp to end.
+    AkUInt32 BeginPart(AkUInt32 in_uFrames);
+
+    /// Applies the gain to the first in_uFrames frames of io_pBuffer, then moves past them, and
+    /// returns the path taken. in_uFrames comes from BeginPart.
+    WoaGainDSP::Path ProcessPart(AkAudioBuffer* io_pBuffer, AkUInt32 in_uFrames, bool in_bMetered);
+
+    /// Returns the gain of the next in_uFrames frames, see BeginPart.
+    void GetPartGain(AkUInt32 in_uFrames, WoaGainDSP::BufferGain& out_gain) const;
+
+    /// Multiplies the auto-gain correction of the next in_uFrames frames into io_gain, from GetPartGain.
+    void ApplyCorrection(AkUInt32 in_uFrames, WoaGainDSP::BufferGain& io_gain) const;
+
+    /// Moves the gain and the frame position past in_uFrames processed or skipped frames.
+    void EndPart(AkUInt32 in_uFrames);
+
+    /// Moves the current gain in_uRampFrames frames along the current ramp, at most the frames left in it.
+    void AdvanceGainRamp(AkUInt32 in_uRampFrames);
+
+    /// Moves the correction in_uRampFrames frames along its ramp, at most the frames left in it.
+    void AdvanceCorrectionRamp(AkUInt32 in_uRampFrames);
+
+    /// Returns the gain in dB at the last processed frame of the current ramp along a dB curve.
+    AkReal32 GetCurveRampDb() const;
+
+    /// Starts a ramp along the smoothing curve from the current gain to in_fTargetGain, or jumps to it
+    /// when smoothing is off. Without a smoothing time, the ramp spans the in_uBufferFrames frames of
+    /// the current buffer.
+    void StartGainRamp(AkReal32 in_fTargetGain, AkUInt32 in_uBufferFrames);
+
+    /// Starts a ramp of in_uRampFrames frames along in_eCurve from the current gain to in_fTargetGain,
+    /// or jumps to it without frames.
+    void RampGain(AkReal32 in_fTargetGain, AkUInt32 in_uRampFrames, WoaGainDSP::Curve in_eCurve);
+
+    /// Starts a linear ramp of in_uRampFrames frames from the current correction to in_fCorrectionDb,
+    /// or jumps to it without frames. The gain ramp keeps running.
+    void RampCorrection(AkReal32 in_fCorrectionDb, AkUInt32 in_uRampFrames);
+
+    /// Converts the meter rate parameter to the number of frames accumulated between monitor posts.
+    void UpdateMeterInterval();
+
+    /// Creates or destroys the loudness meter as the loudness parameter turns it on or off.
+    void UpdateLoudnessMeter();
+
+    /// Creates or destroys the auto-gain as the auto-gain parameter turns it on or off.
+    void UpdateAutoGain();
+
+    /// Claims or gives back the slot of WoaGainLevelRegistry the output level is published in, as the
+    /// level key parameter changes.
+    void UpdateLevelSlot();
+
+    /// Whether the levels are accumulated in m_pMeters: while monitored, or while publishing them.
+    bool IsMetering() const;
+
+    /// Clears the levels accumulated in m_pMeters.
+    void ResetMeters();
+
+    /// Posts the levels accumulated in m_pMeters while monitored and publishes them under the level
+    /// key, then clears them.
+    void EndMeterInterval();
+
+    /// Posts the levels accumulated in m_pMeters over the last m_uMeterFrames frames.
+    void PostMonitorData();
+
+    /// Publishes the output level accumulated in m_pMeters over the last m_uMeterFrames frames.
+    void PublishLevel();
+
     WoaGainFXParams* m_pParams;
-    AK::IAkPluginMemAlloc* m_pAllocator;
+    WoaGainParamsSnapshot m_params;     ///< Parameters of the current buffer, see WoaGainFXParams::GetSnapshot
     AK::IAkEffectPluginContext* m_pContext;
+    AK::IAkPluginMemAlloc* m_pAllocator;    ///< For the loudness meter and auto-gain, allocated when turned on
+
+    AkUInt32 m_uSampleRate;
+    AkChannelConfig m_channelConfig;
+    AkUInt32 m_uNumChannels;
+
+    // Buffer kernels specialized for the channel configuration, selected in Init
+    WoaGainDSP::ProcessFunc m_fnProcess;
+    WoaGainDSP::ProcessFunc m_fnProcessMetered;
+    WoaGainDSP::ChannelMeter* m_pMeters;    ///< One per channel, accumulated by m_fnProcessMetered
+    WoaGainLoudness* m_pLoudness;           ///< Loudness of the output, when enabled
+    WoaGainAutoGain* m_pAutoGain;           ///< Correction toward the target loudness, when enabled
+    AkReal32 m_fGainOffset;                 ///< Linear gain offset of the node, precomputed offline
+
+    // Monitor data is accumulated over several buffers and posted at the meter rate
+    AkUInt32 m_uMeterFrames;            ///< Frames accumulated in m_pMeters since the last post
+    AkUInt32 m_uMeterIntervalFrames;    ///< Frames between posts, 0 to post every buffer
+    AkUInt32 m_uLevelKey;               ///< Key of m_uLevelSlot, 0 when not publishing
+    AkUInt32 m_uLevelSlot;              ///< Slot the output level is published in at the meter rate, see WoaGainLevelRegistry
+
+    AkUInt64 m_uPathCounts[WoaGainDSP::Path_Count];         ///< Buffers processed by each path since Init
+    AkUInt32 m_uMeterPathCounts[WoaGainDSP::Path_Count];    ///< Buffers processed by each path during the meter interval
+
+#ifdef WOAGAIN_ENABLE_STATS
+    WoaGainStats m_stats;   ///< Time per Execute call since Init
+#endif
+
+    // Gain smoothing state, as linear gains
+    AkReal32 m_fGain;           ///< Gain applied at the last processed frame
+    AkReal32 m_fTargetGain;     ///< Gain at the end of the current ramp
+    AkReal32 m_fGainInc;        ///< Increment per frame of the current ramp: of the gain, or of m_fRampPos for dB curves
+    AkUInt32 m_uRampFrames;     ///< Frames left in the current ramp, 0 when the gain is flat
+    AkUInt32 m_uRampLength;     ///< Frames of the whole current ramp
+    AkReal32 m_fRampStartGain;  ///< Gain before the first frame of the current linear ramp
+
+    // Ramps along dB curves, see WoaGainDSP::BufferGain
+    WoaGainDSP::Curve m_eRampCurve; ///< Curve of the current ramp
+    AkReal32 m_fRampPos;            ///< Position of the last processed frame in the ramp, from 0 to 1
+    AkReal32 m_fRampFromDb;         ///< Gain at the start of the ramp
+    AkReal32 m_fRampRangeDb;        ///< Gain change over the whole ramp
+
+    // Auto-gain correction, multiplied into the gain with a linear ramp of its own over each block so
+    // that its updates leave the smoothing and event ramps as they are. 1 without auto-gain.
+    AkReal32 m_fCorrection;             ///< Correction applied at the last processed frame
+    AkReal32 m_fTargetCorrection;       ///< Correction at the end of the current correction ramp
+    AkReal32 m_fTargetCorrectionDb;     ///< m_fTargetCorrection in dB, to offset the ramps of dB curves
+    AkReal32 m_fCorrectionInc;          ///< Increment per frame of the current correction ramp
+    AkReal32 m_fCorrectionStart;        ///< Correction before the first frame of the current correction ramp
+    AkUInt32 m_uCorrectionFrames;       ///< Frames left in the current correction ramp, 0 when flat
+    AkUInt32 m_uCorrectionLength;       ///< Frames of the whole current correction ramp
+
+    // Gain events, see WoaGainFXParams::PostGainEvent
+    AkUInt32 m_uFrame;          ///< Frame of the next frame to process, on the clock of WoaGainEvent::uFrame
+    AkUInt32 m_uEventFrames;    ///< Frames left up to the frame of the current event, 0 once reached
+    AkReal32 m_fEventGainDb;    ///< Gain of the last event, in place of the gain parameter when m_bEventGain
+    bool m_bEventGain;          ///< Set by an event, cleared when the gain parameter changes
 };
 
 #endif // WoaGainFX_H
@@ -25,11 +25,51 @@ the specific language governing permissions and limitations under the License.
 *******************************************************************************/
 
 #include "WoaGainFXParams.h"
+#include "WoaGainAlloc.h"
+#include "WoaGainPool.h"
 
 #include <AK/Tools/Common/AkBankReadHelpers.h>
 
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+#include <emmintrin.h>
+#endif
+#include <string.h>
+#include <thread>
+
+namespace
+{
+    // Spins before yielding the thread to the one being waited for
+    const AkUInt32 kSpinsBeforeYield = 64;
+
+    void SpinWait(AkUInt32& io_uSpins)
+    {
+        if (++io_uSpins < kSpinsBeforeYield)
+        {
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+            _mm_pause();
+#endif
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
 WoaGainFXParams::WoaGainFXParams()
+    : m_uSequence(0)
+    , m_uChangedParams(0)
+    , m_pAllocator(nullptr)
+    , m_pGainOffsets(nullptr)
+    , m_uGainOffsetReaders(0)
+    , m_uEventWrite(0)
+    , m_uEventRead(0)
+    , m_uNextBufferFrame(0)
 {
+    for (AkUInt32 i = 0; i < NumWords; ++i)
+        m_publishedWords[i].store(0, std::memory_order_relaxed);
+    for (AkUInt32 i = 0; i < MaxGainEvents; ++i)
+        m_gainEvents[i].uSequence.store(i, std::memory_order_relaxed);
 }
 
 WoaGainFXParams::~WoaGainFXParams()
@@ -37,24 +77,57 @@ WoaGainFXParams::~WoaGainFXParams()
 }
 
 WoaGainFXParams::WoaGainFXParams(const WoaGainFXParams& in_rParams)
+    : WoaGainFXParams()
 {
-    RTPC = in_rParams.RTPC;
-    NonRTPC = in_rParams.NonRTPC;
-    m_paramChangeHandler.SetAllParamChanges();
+    // The source may be updated concurrently, copy its published values. Nothing differs from
+    // the source yet, so no change is flagged: the effect reads the whole set when it is reset.
+    // A clone has no previous values to fall back on, so when writers keep the bounded read from
+    // going through, the values are read under their lock, which they only hold to publish.
+    Values values;
+    WoaGainParamsSnapshot snapshot;
+    if (in_rParams.ReadPublished(snapshot))
+    {
+        values.RTPC = snapshot.RTPC;
+        values.NonRTPC = snapshot.NonRTPC;
+    }
+    else
+    {
+        in_rParams.LockWrite();
+        values = in_rParams.ReadForWrite();
+        in_rParams.UnlockWrite();
+    }
+    Publish(values, 0);
 }
 
 AK::IAkPluginParam* WoaGainFXParams::Clone(AK::IAkPluginMemAlloc* in_pAllocator)
 {
-    return AK_PLUGIN_NEW(in_pAllocator, WoaGainFXParams(*this));
+#ifdef WOAGAIN_POOLED_ALLOC
+    WoaGainFXParams* pClone = WoaGainPool::New<WoaGainFXParams>(in_pAllocator, *this);
+#else
+    WoaGainFXParams* pClone = WoaGainAlloc::New<WoaGainFXParams>(in_pAllocator, *this);
+#endif
+    if (!pClone)
+        return nullptr;
+
+    // A reference to the table, which costs the same whatever its size
+    pClone->m_pAllocator = in_pAllocator;
+    pClone->m_pGainOffsets.store(AcquireGainOffsets(), std::memory_order_relaxed);
+    return pClone;
 }
 
 AKRESULT WoaGainFXParams::Init(AK::IAkPluginMemAlloc* in_pAllocator, const void* in_pParamsBlock, AkUInt32 in_ulBlockSize)
 {
+    m_pAllocator = in_pAllocator;
     if (in_ulBlockSize == 0)
     {
-        // Initialize default parameters here
-        RTPC.fDummy = 0.0f;
-        m_paramChangeHandler.SetAllParamChanges();
+        WoaGainParamsSnapshot defaults;
+        GetDefaults(defaults);
+        Values values;
+        values.RTPC = defaults.RTPC;
+        values.NonRTPC = defaults.NonRTPC;
+        LockWrite();
+        Publish(values, ALL_PARAMS_CHANGED);
+        UnlockWrite();
         return AK_Success;
     }
 
@@ -63,7 +136,13 @@ AKRESULT WoaGainFXParams::Init(AK::IAkPluginMemAlloc* in_pAllocator, const void*
 
 AKRESULT WoaGainFXParams::Term(AK::IAkPluginMemAlloc* in_pAllocator)
 {
+    ReleaseGainOffsets(m_pGainOffsets.load(std::memory_order_relaxed));
+#ifdef WOAGAIN_POOLED_ALLOC
+    (void)in_pAllocator;
+    WoaGainPool::Delete(this);
+#else
     AK_PLUGIN_DELETE(in_pAllocator, this);
+#endif
     return AK_Success;
 }
 
@@ -73,28 +152,346 @@ AKRESULT WoaGainFXParams::SetParamsBlock(const void* in_pParamsBlock, AkUInt32 i
     AkUInt8* pParamsBlock = (AkUInt8*)in_pParamsBlock;
 
     // Read bank data here
-    RTPC.fDummy = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
-    CHECKBANKDATASIZE(in_ulBlockSize, eResult);
-    m_paramChangeHandler.SetAllParamChanges();
+    Values values;
+    values.RTPC.fDummy = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.bSmoothing = READBANKDATA(bool, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.fSmoothingTime = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.fMeterRate = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.bLoudness = READBANKDATA(bool, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.bAutoGain = READBANKDATA(bool, pParamsBlock, in_ulBlockSize);
+    values.RTPC.fTargetLoudness = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.fAttackTime = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.fReleaseTime = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.fMaxCorrection = READBANKDATA(AkReal32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.iSmoothingCurve = READBANKDATA(AkInt32, pParamsBlock, in_ulBlockSize);
+    values.NonRTPC.uLevelKey = READBANKDATA(AkUInt32, pParamsBlock, in_ulBlockSize);
+
+    // The gain offset table ends the block
+    bool bGainOffsetsChanged = false;
+    eResult = SetGainOffsets(pParamsBlock, in_ulBlockSize, bGainOffsetsChanged);
+
+    LockWrite();
+    AkUInt32 uChangedParams = GetChangedParams(ReadForWrite(), values);
+    if (bGainOffsetsChanged)
+        uChangedParams |= 1u << PARAM_GAIN_OFFSETS_ID;
+    if (uChangedParams != 0)
+        Publish(values, uChangedParams);
+    UnlockWrite();
 
     return eResult;
 }
 
-AKRESULT WoaGainFXParams::SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 in_ulParamSize)
+AKRESULT WoaGainFXParams::SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 /*in_ulParamSize*/)
 {
     AKRESULT eResult = AK_Success;
 
     // Handle parameter change here
+    LockWrite();
+    const Values current = ReadForWrite();
+    Values values = current;
     switch (in_paramID)
     {
     case PARAM_DUMMY_ID:
-        RTPC.fDummy = *((AkReal32*)in_pValue);
-        m_paramChangeHandler.SetParamChange(PARAM_DUMMY_ID);
+        values.RTPC.fDummy = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_SMOOTHING_ID:
+        values.NonRTPC.bSmoothing = *((bool*)in_pValue);
+        break;
+    case PARAM_SMOOTHING_TIME_ID:
+        values.NonRTPC.fSmoothingTime = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_METER_RATE_ID:
+        values.NonRTPC.fMeterRate = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_LOUDNESS_ID:
+        values.NonRTPC.bLoudness = *((bool*)in_pValue);
+        break;
+    case PARAM_AUTO_GAIN_ID:
+        values.NonRTPC.bAutoGain = *((bool*)in_pValue);
+        break;
+    case PARAM_TARGET_LOUDNESS_ID:
+        values.RTPC.fTargetLoudness = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_ATTACK_TIME_ID:
+        values.NonRTPC.fAttackTime = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_RELEASE_TIME_ID:
+        values.NonRTPC.fReleaseTime = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_MAX_CORRECTION_ID:
+        values.NonRTPC.fMaxCorrection = *((AkReal32*)in_pValue);
+        break;
+    case PARAM_SMOOTHING_CURVE_ID:
+        values.NonRTPC.iSmoothingCurve = *((AkInt32*)in_pValue);
+        break;
+    case PARAM_LEVEL_KEY_ID:
+        values.NonRTPC.uLevelKey = (AkUInt32)*((AkInt32*)in_pValue);
         break;
     default:
         eResult = AK_InvalidParameter;
         break;
     }
+    // Setting the current value again, as done for every new voice, is not a change
+    if (eResult == AK_Success && GetChangedParams(current, values) != 0)
+        Publish(values, 1u << in_paramID);
+    UnlockWrite();
 
     return eResult;
 }
+
+bool WoaGainFXParams::FindGainOffset(AkUInt32 in_uKey, AkReal32& out_fOffsetDb) const
+{
+    // Counted as a reader before loading the table: either the writer replacing it sees this
+    // reader and waits, or this load sees the new table (sequentially consistent, see SetGainOffsets)
+    m_uGainOffsetReaders.fetch_add(1, std::memory_order_seq_cst);
+    const GainOffsets* pGainOffsets = m_pGainOffsets.load(std::memory_order_seq_cst);
+    const WoaGainOffsetTable::Entry* pEntry = pGainOffsets ? WoaGainOffsetTable::Find(pGainOffsets->GetEntries(), pGainOffsets->uNumEntries, in_uKey) : nullptr;
+    out_fOffsetDb = pEntry ? WoaGainOffsetTable::GetOffsetDb(*pEntry) : 0.f;
+    m_uGainOffsetReaders.fetch_sub(1, std::memory_order_release);
+    return pEntry != nullptr;
+}
+
+WoaGainFXParams::GainOffsets* WoaGainFXParams::AcquireGainOffsets() const
+{
+    // Same as FindGainOffset: the table cannot lose its last reference before this one is taken
+    m_uGainOffsetReaders.fetch_add(1, std::memory_order_seq_cst);
+    GainOffsets* pGainOffsets = m_pGainOffsets.load(std::memory_order_seq_cst);
+    if (pGainOffsets)
+        pGainOffsets->uRefCount.fetch_add(1, std::memory_order_relaxed);
+    m_uGainOffsetReaders.fetch_sub(1, std::memory_order_release);
+    return pGainOffsets;
+}
+
+void WoaGainFXParams::ReleaseGainOffsets(GainOffsets* in_pGainOffsets)
+{
+    if (in_pGainOffsets && in_pGainOffsets->uRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        AK::IAkPluginMemAlloc* pAllocator = in_pGainOffsets->pAllocator;
+        in_pGainOffsets->~GainOffsets();
+        AK_PLUGIN_FREE(pAllocator, in_pGainOffsets);
+    }
+}
+
+AKRESULT WoaGainFXParams::SetGainOffsets(AkUInt8* in_pData, AkUInt32 in_uSize, bool& out_bChanged)
+{
+    out_bChanged = false;
+
+    // The size left after the fixed parameters wraps around when the block is too short for them
+    if (in_uSize < sizeof(AkUInt32) || in_uSize > WoaGainOffsetTable::MaxEntries * WoaGainOffsetTable::EntrySize + sizeof(AkUInt32))
+        return AK_InvalidParameter;
+    const AkUInt32 uNumEntries = READBANKDATA(AkUInt32, in_pData, in_uSize);
+    if (in_uSize != uNumEntries * WoaGainOffsetTable::EntrySize)
+        return AK_InvalidParameter;
+
+    // Read outside of the lock, then compared and swapped under it
+    GainOffsets* pGainOffsets = nullptr;
+    if (uNumEntries > 0)
+    {
+        void* pMemory = WoaGainAlloc::Alloc(m_pAllocator, sizeof(GainOffsets) + sizeof(WoaGainOffsetTable::Entry) * uNumEntries);
+        if (!pMemory)
+            return AK_InsufficientMemory;
+        pGainOffsets = new (pMemory) GainOffsets;
+        pGainOffsets->uRefCount.store(1, std::memory_order_relaxed);
+        pGainOffsets->uNumEntries = uNumEntries;
+        pGainOffsets->pAllocator = m_pAllocator;
+        WoaGainOffsetTable::Entry* pEntries = pGainOffsets->GetEntries();
+        for (AkUInt32 i = 0; i < uNumEntries; ++i)
+        {
+            WoaGainOffsetTable::ReadEntry(in_pData + i * WoaGainOffsetTable::EntrySize, pEntries[i]);
+            if (i > 0 && pEntries[i].uKey <= pEntries[i - 1].uKey)
+            {
+                ReleaseGainOffsets(pGainOffsets);
+                return AK_InvalidParameter;
+            }
+        }
+    }
+
+    // Only writers replace the table, so it can be compared under the write lock without a reference
+    LockWrite();
+    const GainOffsets* pCurrent = m_pGainOffsets.load(std::memory_order_relaxed);
+    const AkUInt32 uNumCurrent = pCurrent ? pCurrent->uNumEntries : 0;
+    bool bSame = uNumEntries == uNumCurrent;
+    for (AkUInt32 i = 0; bSame && i < uNumEntries; ++i)
+    {
+        const WoaGainOffsetTable::Entry& entry = pGainOffsets->GetEntries()[i];
+        const WoaGainOffsetTable::Entry& current = pCurrent->GetEntries()[i];
+        bSame = entry.uKey == current.uKey && entry.iOffset == current.iOffset;
+    }
+    if (!bSame)
+        pGainOffsets = m_pGainOffsets.exchange(pGainOffsets, std::memory_order_seq_cst);
+    UnlockWrite();
+
+    // Either the new table, unused, or the replaced one once no reader can still be loading it:
+    // readers that come later see the new table. Clones may keep referencing the replaced one.
+    if (!bSame)
+    {
+        AkUInt32 uSpins = 0;
+        while (m_uGainOffsetReaders.load(std::memory_order_seq_cst) != 0)
+            SpinWait(uSpins);
+    }
+    ReleaseGainOffsets(pGainOffsets);
+    out_bChanged = !bSame;
+    return AK_Success;
+}
+
+AKRESULT WoaGainFXParams::PostGainEvent(AkUInt32 in_uFrameOffset, AkReal32 in_fGainDb)
+{
+    static_assert((MaxGainEvents & (MaxGainEvents - 1)) == 0, "The event indices wrap around MaxGainEvents");
+
+    // The entry of index uWrite is free when its sequence is uWrite, and still holds the event of
+    // the previous lap, not read yet, when it is behind: the ring is full
+    AkUInt32 uWrite = m_uEventWrite.load(std::memory_order_relaxed);
+    GainEventEntry* pEntry;
+    for (;;)
+    {
+        pEntry = &m_gainEvents[uWrite & (MaxGainEvents - 1)];
+        const AkInt32 iLag = (AkInt32)(pEntry->uSequence.load(std::memory_order_acquire) - uWrite);
+        if (iLag == 0)
+        {
+            if (m_uEventWrite.compare_exchange_weak(uWrite, uWrite + 1, std::memory_order_relaxed, std::memory_order_relaxed))
+                break;
+        }
+        else if (iLag < 0)
+        {
+            return AK_InsufficientMemory;
+        }
+        else
+        {
+            // Taken by another thread since uWrite was read
+            uWrite = m_uEventWrite.load(std::memory_order_relaxed);
+        }
+    }
+
+    // The frame is fixed at posting time, so that the event does not move with the buffer size
+    pEntry->event.uFrame = m_uNextBufferFrame.load(std::memory_order_relaxed) + in_uFrameOffset;
+    pEntry->event.fGainDb = in_fGainDb;
+    pEntry->uSequence.store(uWrite + 1, std::memory_order_release);
+    return AK_Success;
+}
+
+void WoaGainFXParams::GetDefaults(WoaGainParamsSnapshot& out_snapshot)
+{
+    // Initialize default parameters here
+    out_snapshot.RTPC.fDummy = 0.0f;
+    out_snapshot.NonRTPC.bSmoothing = true;
+    out_snapshot.NonRTPC.fSmoothingTime = 0.0f;
+    out_snapshot.NonRTPC.fMeterRate = 30.0f;
+    out_snapshot.NonRTPC.bLoudness = false;
+    out_snapshot.NonRTPC.bAutoGain = false;
+    out_snapshot.RTPC.fTargetLoudness = -23.0f;
+    out_snapshot.NonRTPC.fAttackTime = 1000.0f;
+    out_snapshot.NonRTPC.fReleaseTime = 3000.0f;
+    out_snapshot.NonRTPC.fMaxCorrection = 12.0f;
+    out_snapshot.NonRTPC.iSmoothingCurve = 0;
+    out_snapshot.NonRTPC.uLevelKey = 0;
+    out_snapshot.uChangedParams = 0;
+}
+
+bool WoaGainFXParams::GetSnapshot(WoaGainParamsSnapshot& io_snapshot)
+{
+    // Take the change flags first: a change flagged after this point is published before
+    // being flagged, so it is either in the copy below or reported by the next call
+    const AkUInt32 uChangedParams = m_uChangedParams.exchange(0, std::memory_order_acq_rel);
+    if (!ReadPublished(io_snapshot))
+    {
+        m_uChangedParams.fetch_or(uChangedParams, std::memory_order_relaxed);
+        io_snapshot.uChangedParams = 0;
+        return false;
+    }
+
+    io_snapshot.uChangedParams = uChangedParams;
+    return true;
+}
+
+bool WoaGainFXParams::ReadPublished(WoaGainParamsSnapshot& io_snapshot) const
+{
+    for (AkUInt32 uAttempt = 0; uAttempt < MaxSnapshotAttempts; ++uAttempt)
+    {
+        const AkUInt32 uSequence = m_uSequence.load(std::memory_order_acquire);
+        if (uSequence & 1)
+            continue;
+
+        AkUInt32 words[NumWords];
+        for (AkUInt32 i = 0; i < NumWords; ++i)
+            words[i] = m_publishedWords[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_uSequence.load(std::memory_order_relaxed) == uSequence)
+        {
+            Values values;
+            memcpy(&values, words, sizeof(values));
+            io_snapshot.RTPC = values.RTPC;
+            io_snapshot.NonRTPC = values.NonRTPC;
+            return true;
+        }
+    }
+    return false;
+}
+
+AkUInt32 WoaGainFXParams::GetChangedParams(const Values& in_before, const Values& in_after)
+{
+    AkUInt32 uChangedParams = 0;
+    if (in_before.RTPC.fDummy != in_after.RTPC.fDummy)
+        uChangedParams |= 1u << PARAM_DUMMY_ID;
+    if (in_before.NonRTPC.bSmoothing != in_after.NonRTPC.bSmoothing)
+        uChangedParams |= 1u << PARAM_SMOOTHING_ID;
+    if (in_before.NonRTPC.fSmoothingTime != in_after.NonRTPC.fSmoothingTime)
+        uChangedParams |= 1u << PARAM_SMOOTHING_TIME_ID;
+    if (in_before.NonRTPC.fMeterRate != in_after.NonRTPC.fMeterRate)
+        uChangedParams |= 1u << PARAM_METER_RATE_ID;
+    if (in_before.NonRTPC.bLoudness != in_after.NonRTPC.bLoudness)
+        uChangedParams |= 1u << PARAM_LOUDNESS_ID;
+    if (in_before.NonRTPC.bAutoGain != in_after.NonRTPC.bAutoGain)
+        uChangedParams |= 1u << PARAM_AUTO_GAIN_ID;
+    if (in_before.RTPC.fTargetLoudness != in_after.RTPC.fTargetLoudness)
+        uChangedParams |= 1u << PARAM_TARGET_LOUDNESS_ID;
+    if (in_before.NonRTPC.fAttackTime != in_after.NonRTPC.fAttackTime)
+        uChangedParams |= 1u << PARAM_ATTACK_TIME_ID;
+    if (in_before.NonRTPC.fReleaseTime != in_after.NonRTPC.fReleaseTime)
+        uChangedParams |= 1u << PARAM_RELEASE_TIME_ID;
+    if (in_before.NonRTPC.fMaxCorrection != in_after.NonRTPC.fMaxCorrection)
+        uChangedParams |= 1u << PARAM_MAX_CORRECTION_ID;
+    if (in_before.NonRTPC.iSmoothingCurve != in_after.NonRTPC.iSmoothingCurve)
+        uChangedParams |= 1u << PARAM_SMOOTHING_CURVE_ID;
+    if (in_before.NonRTPC.uLevelKey != in_after.NonRTPC.uLevelKey)
+        uChangedParams |= 1u << PARAM_LEVEL_KEY_ID;
+    return uChangedParams;
+}
+
+WoaGainFXParams::Values WoaGainFXParams::ReadForWrite() const
+{
+    AkUInt32 words[NumWords];
+    for (AkUInt32 i = 0; i < NumWords; ++i)
+        words[i] = m_publishedWords[i].load(std::memory_order_relaxed);
+
+    Values values;
+    memcpy(&values, words, sizeof(values));
+    return values;
+}
+
+void WoaGainFXParams::Publish(const Values& in_values, AkUInt32 in_uChangedParams)
+{
+    AkUInt32 words[NumWords] = {};
+    memcpy(words, &in_values, sizeof(in_values));
+
+    const AkUInt32 uSequence = m_uSequence.load(std::memory_order_relaxed);
+    m_uSequence.store(uSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (AkUInt32 i = 0; i < NumWords; ++i)
+        m_publishedWords[i].store(words[i], std::memory_order_relaxed);
+    m_uSequence.store(uSequence + 2, std::memory_order_release);
+
+    m_uChangedParams.fetch_or(in_uChangedParams, std::memory_order_release);
+}
+
+void WoaGainFXParams::LockWrite() const
+{
+    AkUInt32 uSpins = 0;
+    while (m_writeLock.test_and_set(std::memory_order_acquire))
+        SpinWait(uSpins);
+}
+
+void WoaGainFXParams::UnlockWrite() const
+{
+    m_writeLock.clear(std::memory_order_release);
+}
@@ -28,22 +28,73 @@ the specific language governing permissions and limitations under the License.
 #define WoaGainFXParams_H
 
 #include <AK/SoundEngine/Common/IAkPlugin.h>
-#include <AK/Plugin/PluginServices/AkFXParameterChangeHandler.h>
+
+#include "../WoaGainOffsetTable.h"
+
+#include <atomic>
 
 // Add parameters IDs here, those IDs should map to the AudioEnginePropertyID
 // attributes in the xml property definition.
 static const AkPluginParamID PARAM_DUMMY_ID = 0;
-static const AkUInt32 NUM_PARAMS = 1;
+static const AkPluginParamID PARAM_SMOOTHING_ID = 1;
+static const AkPluginParamID PARAM_SMOOTHING_TIME_ID = 2;
+static const AkPluginParamID PARAM_METER_RATE_ID = 3;
+static const AkPluginParamID PARAM_LOUDNESS_ID = 4;
+static const AkPluginParamID PARAM_AUTO_GAIN_ID = 5;
+static const AkPluginParamID PARAM_TARGET_LOUDNESS_ID = 6;
+static const AkPluginParamID PARAM_ATTACK_TIME_ID = 7;
+static const AkPluginParamID PARAM_RELEASE_TIME_ID = 8;
+static const AkPluginParamID PARAM_MAX_CORRECTION_ID = 9;
+static const AkPluginParamID PARAM_GAIN_OFFSETS_ID = 10;   ///< Not a property: the gain offset table of the parameter block
+static const AkPluginParamID PARAM_SMOOTHING_CURVE_ID = 11;
+static const AkPluginParamID PARAM_LEVEL_KEY_ID = 12;
+static const AkUInt32 NUM_PARAMS = 13;
+static const AkUInt32 ALL_PARAMS_CHANGED = (1u << NUM_PARAMS) - 1;
 
 struct WoaGainRTPCParams
 {
     AkReal32 fDummy;
+    AkReal32 fTargetLoudness;   ///< Output loudness in LUFS that auto-gain corrects toward
 };
 
 struct WoaGainNonRTPCParams
 {
+    bool bSmoothing;            ///< Ramp gain changes instead of applying them as a step
+    AkReal32 fSmoothingTime;    ///< Ramp duration in milliseconds, 0 to ramp over a single buffer
+    AkReal32 fMeterRate;        ///< Monitor data posts per second, 0 to post every buffer
+    bool bLoudness;             ///< Measure the BS.1770 loudness of the output while monitored
+    bool bAutoGain;             ///< Correct the gain toward fTargetLoudness, on top of fDummy
+    AkReal32 fAttackTime;       ///< Time constant in milliseconds of auto-gain corrections that lower the gain
+    AkReal32 fReleaseTime;      ///< Time constant in milliseconds of auto-gain corrections that raise the gain
+    AkReal32 fMaxCorrection;    ///< Largest auto-gain correction in dB, either way
+    AkInt32 iSmoothingCurve;    ///< Shape of the ramps of gain changes, a WoaGainDSP::Curve
+    AkUInt32 uLevelKey;         ///< Key the output level is published under in WoaGainLevelRegistry, 0 not to publish it
+};
+
+/// Complete set of parameter values, as seen by the effect during one buffer.
+struct WoaGainParamsSnapshot
+{
+    WoaGainRTPCParams RTPC;
+    WoaGainNonRTPCParams NonRTPC;
+    AkUInt32 uChangedParams;    ///< Bit (1 << ID) set for every parameter set since the previous snapshot
+
+    bool HasChanged(AkPluginParamID in_paramID) const { return (uChangedParams & (1u << in_paramID)) != 0; }
 };
 
+/// Breakpoint of the gain automation: the gain parameter reaches fGainDb at frame uFrame.
+struct WoaGainEvent
+{
+    AkUInt32 uFrame;    ///< Frame processed by the effect, counted from its first buffer and wrapping around
+    AkReal32 fGainDb;
+};
+
+/// Parameter values are handed from the threads calling SetParam and SetParamsBlock to the audio
+/// thread through a sequence lock: every change publishes a complete parameter set, and the effect
+/// copies one consistent set per buffer with GetSnapshot. Reading never blocks nor allocates.
+/// Writers are serialized among themselves by a spin flag that GetSnapshot never takes.
+/// Only values that differ from the published ones are flagged as changed.
+/// Gain events are handed over in a fixed-capacity ring, which any thread posts to and the audio
+/// thread reads, neither of them locking.
 struct WoaGainFXParams
     : public AK::IAkPluginParam
 {
@@ -52,7 +103,10 @@ struct WoaGainFXParams
 
     ~WoaGainFXParams();
 
-    /// Create a duplicate of the parameter node instance in its current state.
+    /// Create a duplicate of the parameter node instance in its current state, with no parameter
+    /// flagged as changed. The clone copies the published values, 44 bytes, and takes a reference
+    /// to the gain offset table instead of copying it: tables are never modified, a writer replaces
+    /// the table of its own node only. Gain events posted to this node are not copied.
     IAkPluginParam* Clone(AK::IAkPluginMemAlloc* in_pAllocator);
 
     /// Initialize the plug-in parameter node interface.
@@ -68,10 +122,141 @@ struct WoaGainFXParams
     /// Update a single parameter at a time and perform the necessary actions on the parameter changes.
     AKRESULT SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 in_ulParamSize);
 
-    AK::AkFXParameterChangeHandler<NUM_PARAMS> m_paramChangeHandler;
+    /// Copies the last published parameter set into io_snapshot, and the parameters set since the
+    /// previous call into io_snapshot.uChangedParams. Wait-free: when writers keep publishing during
+    /// a bounded number of attempts, io_snapshot keeps its previous values, no change is reported
+    /// and the changes are left for the next call. Returns false in that case.
+    bool GetSnapshot(WoaGainParamsSnapshot& io_snapshot);
 
-    WoaGainRTPCParams RTPC;
-    WoaGainNonRTPCParams NonRTPC;
-} AK_ALIGN_DMA;
+    /// Returns whether parameters were set since the last GetSnapshot. Without changes, the last
+    /// snapshot is still current and taking a new one can be skipped; a change being published
+    /// while this is called may only be seen by the next call.
+    bool HasChanges() const { return m_uChangedParams.load(std::memory_order_relaxed) != 0; }
+
+    /// Flags every parameter as changed, so that the next snapshot reports the whole set, e.g.
+    /// after a failed GetSnapshot whose values cannot wait for the next change.
+    void FlagAllChanged() { m_uChangedParams.fetch_or(ALL_PARAMS_CHANGED, std::memory_order_relaxed); }
+
+    /// Sets out_snapshot to the default parameter values, with no change flagged.
+    static void GetDefaults(WoaGainParamsSnapshot& out_snapshot);
+
+    /// Looks up the gain offset of in_uKey in the table of the parameter block, in dB, 0 when the
+    /// table has none, and returns whether it has one. Lock-free: the table is immutable, and the
+    /// writer replacing it waits for lookups in progress before releasing it. Meant for the start
+    /// of a voice and table changes, not every buffer.
+    bool FindGainOffset(AkUInt32 in_uKey, AkReal32& out_fOffsetDb) const;
+
+    /// Number of gain events the queue holds before PostGainEvent fails.
+    static const AkUInt32 MaxGainEvents = 64;
+
+    /// Schedules the gain parameter to reach in_fGainDb at frame in_uFrameOffset of the next buffer
+    /// the effect processes or skips, offsets past its end falling into the buffers after it. The
+    /// gain ramps along the smoothing curve from the previous event, or from the current gain for
+    /// the first one, whatever the buffer size. Events must be posted in time order; late ones are
+    /// reached on the next frame; events posted concurrently by several threads are queued in the
+    /// order they take their entry. Lock-free and never allocates. Returns AK_InsufficientMemory
+    /// when MaxGainEvents events are waiting to be processed.
+    AKRESULT PostGainEvent(AkUInt32 in_uFrameOffset, AkReal32 in_fGainDb);
+
+    /// Audio thread: copies the oldest queued event to out_event, returns false when there is none,
+    /// or when the thread that took its entry is still writing it.
+    bool PeekGainEvent(WoaGainEvent& out_event) const
+    {
+        const GainEventEntry& entry = m_gainEvents[m_uEventRead & (MaxGainEvents - 1)];
+        if (entry.uSequence.load(std::memory_order_acquire) != m_uEventRead + 1)
+            return false;
+        out_event = entry.event;
+        return true;
+    }
+
+    /// Audio thread: removes the event returned by PeekGainEvent, handing its entry back to the
+    /// posting threads for the next lap of the ring.
+    void PopGainEvent()
+    {
+        m_gainEvents[m_uEventRead & (MaxGainEvents - 1)].uSequence.store(m_uEventRead + MaxGainEvents, std::memory_order_release);
+        ++m_uEventRead;
+    }
+
+    /// Audio thread: sets the frame of the next buffer, where the offsets of PostGainEvent start from.
+    void SetNextBufferFrame(AkUInt32 in_uFrame) { m_uNextBufferFrame.store(in_uFrame, std::memory_order_relaxed); }
+
+private:
+    struct Values
+    {
+        WoaGainRTPCParams RTPC;
+        WoaGainNonRTPCParams NonRTPC;
+    };
+
+    static const AkUInt32 NumWords = (sizeof(Values) + sizeof(AkUInt32) - 1) / sizeof(AkUInt32);
+    static const AkUInt32 MaxSnapshotAttempts = 4;
+
+    /// Copies the last published parameter set, without the change flags. Returns false when
+    /// writers kept publishing during MaxSnapshotAttempts attempts.
+    bool ReadPublished(WoaGainParamsSnapshot& io_snapshot) const;
+
+    /// Gain offset table of a parameter block, immutable once read and shared by the node that read
+    /// it and its clones. The entries follow it in the same allocation.
+    struct GainOffsets
+    {
+        std::atomic<AkUInt32> uRefCount;
+        AkUInt32 uNumEntries;
+        AK::IAkPluginMemAlloc* pAllocator;  ///< Frees the table with its last reference
+
+        const WoaGainOffsetTable::Entry* GetEntries() const { return (const WoaGainOffsetTable::Entry*)(this + 1); }
+        WoaGainOffsetTable::Entry* GetEntries() { return (WoaGainOffsetTable::Entry*)(this + 1); }
+    };
+
+    /// Reads the gain offset table ending a parameter block. The table replaces the current one
+    /// when it differs, and out_bChanged tells whether it did. The current table is kept when the
+    /// block is invalid or the allocation fails.
+    AKRESULT SetGainOffsets(AkUInt8* in_pData, AkUInt32 in_uSize, bool& out_bChanged);
+
+    /// Returns a new reference to the current gain offset table, nullptr when there is none.
+    GainOffsets* AcquireGainOffsets() const;
+
+    /// Drops a reference to in_pGainOffsets, which may be nullptr, and frees it with the last one.
+    static void ReleaseGainOffsets(GainOffsets* in_pGainOffsets);
+
+    /// Returns the bits (1 << ID) of the parameters that differ between two sets.
+    static AkUInt32 GetChangedParams(const Values& in_before, const Values& in_after);
+
+    /// Returns the published values. Requires the write lock, so that no write is in progress.
+    Values ReadForWrite() const;
+
+    /// Publishes in_values and flags in_uChangedParams as changed. Requires the write lock.
+    void Publish(const Values& in_values, AkUInt32 in_uChangedParams);
+
+    /// Spins, then yields, until the write lock is taken. Also taken by the copy constructor
+    /// on its source when snapshots keep failing.
+    void LockWrite() const;
+    void UnlockWrite() const;
+
+    // Published values, odd m_uSequence while a writer updates them
+    std::atomic<AkUInt32> m_uSequence;
+    std::atomic<AkUInt32> m_publishedWords[NumWords];
+    std::atomic<AkUInt32> m_uChangedParams;
+    mutable std::atomic_flag m_writeLock = ATOMIC_FLAG_INIT;
+
+    // Gain offsets per node, sorted by key, shared with the clones instead of copied. Writers
+    // replace the table under the write lock. Readers count themselves in m_uGainOffsetReaders
+    // while they search the table or take a reference to it, and the writer waits for them to
+    // leave before dropping the reference of the table it replaced.
+    AK::IAkPluginMemAlloc* m_pAllocator;
+    std::atomic<GainOffsets*> m_pGainOffsets;
+    mutable std::atomic<AkUInt32> m_uGainOffsetReaders;
+
+    // Gain events of the effect, not copied by Clone. Posting threads take the entry of index
+    // m_uEventWrite with a compare-and-swap, write it, then publish it in its sequence: index + 1
+    // once written, index + MaxGainEvents once read, free for the next lap. Both indices only grow.
+    struct GainEventEntry
+    {
+        std::atomic<AkUInt32> uSequence;
+        WoaGainEvent event;
+    };
+    GainEventEntry m_gainEvents[MaxGainEvents];
+    std::atomic<AkUInt32> m_uEventWrite;
+    AkUInt32 m_uEventRead;      ///< Audio thread only
+    std::atomic<AkUInt32> m_uNextBufferFrame;
+};
 
 #endif // WoaGainFXParams_H
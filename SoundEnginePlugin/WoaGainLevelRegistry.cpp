@@ -0,0 +1,198 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainLevelRegistry.h"
+#include "WoaGainAlloc.h"
+#include "../WoaGainMonitorData.h"
+
+#include <atomic>
+#include <math.h>
+
+namespace
+{
+    // Slots are aligned on cache lines, see WoaGainAlloc
+    const size_t kCacheLineSize = WoaGainAlloc::CacheLineSize;
+
+    // Key of an unused slot, which ends the probing, and of a released slot still probed through
+    const AkUInt32 kUnusedKey = 0;
+    const AkUInt32 kReleasedKey = 0xFFFFFFFF;
+
+    struct alignas(kCacheLineSize) Slot
+    {
+        std::atomic<AkUInt32> uKey;
+        std::atomic<AkUInt32> uLevels;  ///< RMS and peak levels, see PackLevels
+        std::atomic<AkUInt32> uNumProbing;  ///< Held slots whose probing went past this one, which keep it from becoming unused
+    };
+
+    static_assert(sizeof(Slot) == kCacheLineSize, "One slot per cache line");
+    static_assert((WoaGainLevelRegistry::MaxSlots & (WoaGainLevelRegistry::MaxSlots - 1)) == 0, "The probing wraps around MaxSlots");
+
+    // Zero-initialized: every slot starts unused
+    Slot s_slots[WoaGainLevelRegistry::MaxSlots];
+
+    // RMS in the low 16 bits and peak in the high 16 bits, offset so that QuantizedSilence is 0 and
+    // the zero-initialized slots read as silent
+    AkUInt32 PackLevels(WoaGainMonitorData::QuantizedDb in_iRms, WoaGainMonitorData::QuantizedDb in_iPeak)
+    {
+        return ((AkUInt32)(AkUInt16)in_iRms ^ 0x8000) | (((AkUInt32)(AkUInt16)in_iPeak ^ 0x8000) << 16);
+    }
+
+    WoaGainMonitorData::QuantizedDb UnpackLevel(AkUInt32 in_uLevels, AkUInt32 in_uShift)
+    {
+        return (WoaGainMonitorData::QuantizedDb)(AkUInt16)((in_uLevels >> in_uShift) ^ 0x8000);
+    }
+
+    const AkUInt32 kSilentLevels = 0;
+
+    // First slot probed for a key, by Fibonacci hashing, so that consecutive keys spread out
+    AkUInt32 GetFirstSlot(AkUInt32 in_uKey)
+    {
+        return (in_uKey * 2654435761u) & (WoaGainLevelRegistry::MaxSlots - 1);
+    }
+
+    // Turns a released slot into an unused one. Called once no held slot probes past it; Acquire
+    // meanwhile claims the released slot rather than going past it, which the exchange settles.
+    void ClearReleased(Slot& io_slot)
+    {
+        AkUInt32 uKey = kReleasedKey;
+        io_slot.uKey.compare_exchange_strong(uKey, kUnusedKey, std::memory_order_seq_cst);
+    }
+
+    // Drops a probing past in_uSlot, which becomes unused if it was the last one and the slot is released
+    void EndProbing(AkUInt32 in_uSlot)
+    {
+        Slot& slot = s_slots[in_uSlot];
+        if (slot.uNumProbing.fetch_sub(1, std::memory_order_seq_cst) == 1)
+            ClearReleased(slot);
+    }
+}
+
+AkUInt32 WoaGainLevelRegistry::Acquire(AkUInt32 in_uKey)
+{
+    if (in_uKey == kUnusedKey || in_uKey == kReleasedKey)
+        return InvalidSlot;
+
+    // The first free slot from the hash of the key, so that the key is found before an unused one.
+    // Every slot is counted as probed past before its key is read (sequentially consistent, like
+    // Release): either Release sees the count and leaves a tombstone, or this sees the tombstone
+    // and claims it, so a held slot is never behind an unused one.
+    const AkUInt32 uFirst = GetFirstSlot(in_uKey);
+    for (AkUInt32 i = 0; i < MaxSlots; ++i)
+    {
+        const AkUInt32 uSlot = (uFirst + i) & (MaxSlots - 1);
+        Slot& slot = s_slots[uSlot];
+        slot.uNumProbing.fetch_add(1, std::memory_order_seq_cst);
+        AkUInt32 uKey = slot.uKey.load(std::memory_order_seq_cst);
+        while (uKey == kUnusedKey || uKey == kReleasedKey)
+        {
+            if (slot.uKey.compare_exchange_weak(uKey, in_uKey, std::memory_order_seq_cst))
+            {
+                EndProbing(uSlot);
+                return uSlot;
+            }
+        }
+    }
+
+    // Every slot is held
+    for (AkUInt32 i = 0; i < MaxSlots; ++i)
+        EndProbing(i);
+    return InvalidSlot;
+}
+
+void WoaGainLevelRegistry::Release(AkUInt32 in_uSlot)
+{
+    if (in_uSlot >= MaxSlots)
+        return;
+    // Left silent for the next instance claiming the slot, and unused right away unless a held
+    // slot probes past it
+    Slot& slot = s_slots[in_uSlot];
+    const AkUInt32 uKey = slot.uKey.load(std::memory_order_relaxed);
+    slot.uLevels.store(kSilentLevels, std::memory_order_relaxed);
+    slot.uKey.store(kReleasedKey, std::memory_order_seq_cst);
+    if (slot.uNumProbing.load(std::memory_order_seq_cst) == 0)
+        ClearReleased(slot);
+
+    // The slots probed past to claim it may become unused in turn
+    for (AkUInt32 uProbed = GetFirstSlot(uKey); uProbed != in_uSlot; uProbed = (uProbed + 1) & (MaxSlots - 1))
+        EndProbing(uProbed);
+}
+
+void WoaGainLevelRegistry::Publish(AkUInt32 in_uSlot, AkReal32 in_fMeanSquare, AkReal32 in_fPeak)
+{
+    const AkUInt32 uLevels = PackLevels(WoaGainMonitorData::QuantizePower(in_fMeanSquare), WoaGainMonitorData::QuantizeAmplitude(in_fPeak));
+    s_slots[in_uSlot].uLevels.store(uLevels, std::memory_order_relaxed);
+}
+
+bool WoaGainLevelRegistry::Read(AkUInt32 in_uKey, Level& out_level)
+{
+    if (in_uKey == kUnusedKey || in_uKey == kReleasedKey)
+        return false;
+
+    AkUInt32 uPublishers = 0;
+    WoaGainMonitorData::QuantizedDb iRms = WoaGainMonitorData::QuantizedSilence;
+    WoaGainMonitorData::QuantizedDb iPeak = WoaGainMonitorData::QuantizedSilence;
+    AkReal32 fPower = 0.f;
+    const AkUInt32 uFirst = GetFirstSlot(in_uKey);
+    for (AkUInt32 i = 0; i < MaxSlots; ++i)
+    {
+        const Slot& slot = s_slots[(uFirst + i) & (MaxSlots - 1)];
+        const AkUInt32 uKey = slot.uKey.load(std::memory_order_acquire);
+        if (uKey == kUnusedKey)
+            break;
+        if (uKey != in_uKey)
+            continue;
+
+        // The key is checked again, in case the slot was released and claimed under another key
+        const AkUInt32 uLevels = slot.uLevels.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.uKey.load(std::memory_order_relaxed) != in_uKey)
+            continue;
+
+        const WoaGainMonitorData::QuantizedDb iSlotRms = UnpackLevel(uLevels, 0);
+        const WoaGainMonitorData::QuantizedDb iSlotPeak = UnpackLevel(uLevels, 16);
+        if (iSlotRms != WoaGainMonitorData::QuantizedSilence)
+            fPower += powf(10.f, WoaGainMonitorData::DequantizeDb(iSlotRms) * 0.1f);
+        iRms = iSlotRms;
+        iPeak = iSlotPeak > iPeak ? iSlotPeak : iPeak;
+        ++uPublishers;
+    }
+    if (uPublishers == 0)
+        return false;
+
+    // A single publisher's level is returned as published, without going through its power
+    out_level.fRmsDb = uPublishers == 1 ? WoaGainMonitorData::DequantizeDb(iRms) : (fPower > 0.f ? log10f(fPower) * 10.f : -INFINITY);
+    out_level.fPeakDb = WoaGainMonitorData::DequantizeDb(iPeak);
+    out_level.uPublishers = uPublishers;
+    return true;
+}
+
+AkUInt32 WoaGainLevelRegistry::GetNumUsedSlots()
+{
+    AkUInt32 uNumUsed = 0;
+    for (AkUInt32 i = 0; i < MaxSlots; ++i)
+        uNumUsed += s_slots[i].uKey.load(std::memory_order_relaxed) != kUnusedKey ? 1 : 0;
+    return uNumUsed;
+}
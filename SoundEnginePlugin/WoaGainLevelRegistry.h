@@ -0,0 +1,84 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainLevelRegistry_H
+#define WoaGainLevelRegistry_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+/// Process-wide table of the output levels that WoaGainFX instances publish under a key of the
+/// user's choosing (Level Key property), so that other instances or game code can follow the level
+/// of a bus, e.g. to duck another one, without metering it a second time.
+///
+/// Every publishing instance holds a slot of a fixed table of MaxSlots slots, each on its own
+/// cache line, so that instances publishing from different threads do not share lines. Slots are
+/// claimed with a compare-exchange, by linear probing from the hash of the key, and a key is found
+/// by probing from its hash up to the first unused slot. Every slot counts the held slots whose
+/// probing went past it: a released slot becomes unused once none does, and is otherwise left as a
+/// tombstone, which Acquire reuses, so that the probing stays short however many keys come and go.
+/// Levels are stored as two WoaGainMonitorData::QuantizedDb packed in one word, so that a reader
+/// never sees the RMS of one interval with the peak of another. Nothing locks or allocates, and
+/// every function can be called from any thread.
+///
+/// The table is a static of the plug-in library: game code reading it must link the same copy of
+/// the library as the sound engine, e.g. the static plug-in library.
+namespace WoaGainLevelRegistry
+{
+    static const AkUInt32 MaxSlots = 256;
+
+    /// Returned by Acquire when every slot is held.
+    static const AkUInt32 InvalidSlot = MaxSlots;
+
+    /// Level read under a key, see Read.
+    struct Level
+    {
+        AkReal32 fRmsDb;        ///< RMS level over the last meter interval, -infinity when silent
+        AkReal32 fPeakDb;       ///< Peak level over the same interval
+        AkUInt32 uPublishers;   ///< Instances publishing under the key
+    };
+
+    /// Claims a slot to publish under in_uKey, which must not be 0. The slot reads as silent until
+    /// the first Publish. Returns InvalidSlot when all MaxSlots slots are held.
+    AkUInt32 Acquire(AkUInt32 in_uKey);
+
+    /// Gives back a slot claimed with Acquire, whose level stops being read.
+    void Release(AkUInt32 in_uSlot);
+
+    /// Publishes the level of the last meter interval in a slot claimed with Acquire, from the mean
+    /// square and the peak of the samples. Called by the instance holding the slot only.
+    void Publish(AkUInt32 in_uSlot, AkReal32 in_fMeanSquare, AkReal32 in_fPeak);
+
+    /// Reads the level of the instances publishing under in_uKey: the RMS of their sum, taken as
+    /// uncorrelated (their powers add up), and their highest peak. Returns false, leaving out_level
+    /// unchanged, when no instance publishes under in_uKey. A slot changing hands while it is read
+    /// is skipped.
+    bool Read(AkUInt32 in_uKey, Level& out_level);
+
+    /// Returns the number of slots held or left as tombstones, for tests and statistics.
+    AkUInt32 GetNumUsedSlots();
+}
+
+#endif // WoaGainLevelRegistry_H
@@ -0,0 +1,305 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainLoudness.h"
+#include "WoaGainAlloc.h"
+
+#include <AK/Tools/Common/AkAssert.h>
+
+#include <math.h>
+#include <new>
+
+namespace
+{
+    // K-weighting stages from BS.1770-4, specified at 48 kHz and derived here for any
+    // sample rate with the bilinear transform (same formulas as libebur128)
+    const AkReal64 kShelfFrequency = 1681.974450955533;
+    const AkReal64 kShelfGainDb = 3.999843853973347;
+    const AkReal64 kShelfQ = 0.7071752369554196;
+    const AkReal64 kHighPassFrequency = 38.13547087602444;
+    const AkReal64 kHighPassQ = 0.5003270373238773;
+
+    const AkReal64 kPi = 3.14159265358979323846;
+
+    const AkReal64 kAbsoluteGateLufs = -70.;
+    const AkReal64 kRelativeGateLu = -10.;
+    const AkReal64 kSideWeight = 1.41;
+}
+
+WoaGainLoudness* WoaGainLoudness::Create(AK::IAkPluginMemAlloc* in_pAllocator, AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate)
+{
+    const AkUInt32 uNumChannels = in_channelConfig.uNumChannels;
+    void* pMem = WoaGainAlloc::Alloc(in_pAllocator, sizeof(WoaGainLoudness) + sizeof(Channel) * uNumChannels);
+    if (!pMem)
+        return nullptr;
+
+    WoaGainLoudness* pLoudness = ::new (pMem) WoaGainLoudness(uNumChannels, in_uSampleRate);
+    pLoudness->m_pChannels = (Channel*)(pLoudness + 1);
+
+    // Standard configurations store their channels in the order of the mask bits, the LFE last
+    AkUInt32 uChannel = 0;
+    if (in_channelConfig.eConfigType == AK_ChannelConfigType_Standard)
+    {
+        for (AkUInt32 uMask = in_channelConfig.uChannelMask & ~AK_SPEAKER_LOW_FREQUENCY; uMask != 0; uMask &= uMask - 1)
+        {
+            const AkUInt32 uSpeaker = uMask & (0u - uMask);
+            const bool bSide = (uSpeaker & (AK_SPEAKER_SIDE_LEFT | AK_SPEAKER_SIDE_RIGHT)) != 0;
+            pLoudness->m_pChannels[uChannel++].fWeight = bSide ? kSideWeight : 1.;
+        }
+        if (in_channelConfig.HasLFE())
+            pLoudness->m_pChannels[uChannel++].fWeight = 0.;
+    }
+    for (; uChannel < uNumChannels; ++uChannel)
+        pLoudness->m_pChannels[uChannel].fWeight = 1.;
+
+    pLoudness->Reset();
+    return pLoudness;
+}
+
+void WoaGainLoudness::Destroy(AK::IAkPluginMemAlloc* in_pAllocator)
+{
+    this->~WoaGainLoudness();
+    AK_PLUGIN_FREE(in_pAllocator, this);
+}
+
+WoaGainLoudness::WoaGainLoudness(AkUInt32 in_uNumChannels, AkUInt32 in_uSampleRate)
+    : m_pChannels(nullptr)
+    , m_uNumChannels(in_uNumChannels)
+    , m_uBlockFrames((in_uSampleRate + 5) / 10)
+{
+    const AkReal64 fSampleRate = (AkReal64)in_uSampleRate;
+
+    AkReal64 K = tan(kPi * kShelfFrequency / fSampleRate);
+    const AkReal64 fVh = pow(10., kShelfGainDb / 20.);
+    const AkReal64 fVb = pow(fVh, 0.4996667741545416);
+    AkReal64 fA0 = 1. + K / kShelfQ + K * K;
+    m_shelf.b0 = (fVh + fVb * K / kShelfQ + K * K) / fA0;
+    m_shelf.b1 = 2. * (K * K - fVh) / fA0;
+    m_shelf.b2 = (fVh - fVb * K / kShelfQ + K * K) / fA0;
+    m_shelf.a1 = 2. * (K * K - 1.) / fA0;
+    m_shelf.a2 = (1. - K / kShelfQ + K * K) / fA0;
+
+    K = tan(kPi * kHighPassFrequency / fSampleRate);
+    fA0 = 1. + K / kHighPassQ + K * K;
+    m_highPass.b0 = 1.;
+    m_highPass.b1 = -2.;
+    m_highPass.b2 = 1.;
+    m_highPass.a1 = 2. * (K * K - 1.) / fA0;
+    m_highPass.a2 = (1. - K / kHighPassQ + K * K) / fA0;
+}
+
+void WoaGainLoudness::Reset()
+{
+    for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+    {
+        Channel& channel = m_pChannels[i];
+        channel.fShelfZ1 = channel.fShelfZ2 = 0.;
+        channel.fHighPassZ1 = channel.fHighPassZ2 = 0.;
+    }
+
+    m_uBlockFramesDone = 0;
+    m_fBlockEnergy = 0.;
+    for (AkUInt32 i = 0; i < ShortTermBlocks; ++i)
+        m_fBlockPowers[i] = 0.;
+    m_uNextBlock = 0;
+    m_uNumBlocks = 0;
+    for (AkUInt32 i = 0; i < NumHistogramBins; ++i)
+        m_uHistogram[i] = 0;
+}
+
+AkUInt32 WoaGainLoudness::Process(AkAudioBuffer* in_pBuffer, AkUInt32 in_uFrames)
+{
+    AKASSERT(in_pBuffer->NumChannels() == m_uNumChannels);
+
+    // Buffers are split at block boundaries. The recursion of the filters is sequential, so
+    // channels are filtered in scalar loops, right after the gain kernel left them in the cache.
+    AkUInt32 uBlocksEnded = 0;
+    AkUInt32 uFrame = 0;
+    while (uFrame < in_uFrames)
+    {
+        const AkUInt32 uBlockFramesLeft = m_uBlockFrames - m_uBlockFramesDone;
+        const AkUInt32 uFrames = in_uFrames - uFrame < uBlockFramesLeft ? in_uFrames - uFrame : uBlockFramesLeft;
+        for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+        {
+            Channel& channel = m_pChannels[i];
+            if (channel.fWeight != 0.)
+                m_fBlockEnergy += channel.fWeight * FilterChannel(channel, in_pBuffer->GetChannel(i) + uFrame, uFrames);
+        }
+
+        uFrame += uFrames;
+        m_uBlockFramesDone += uFrames;
+        if (m_uBlockFramesDone == m_uBlockFrames)
+        {
+            EndBlock();
+            ++uBlocksEnded;
+        }
+    }
+    return uBlocksEnded;
+}
+
+void WoaGainLoudness::Skip(AkUInt32 in_uFrames)
+{
+    for (AkUInt32 i = 0; i < m_uNumChannels; ++i)
+    {
+        Channel& channel = m_pChannels[i];
+        channel.fShelfZ1 = channel.fShelfZ2 = 0.;
+        channel.fHighPassZ1 = channel.fHighPassZ2 = 0.;
+    }
+
+    // The first block ending may still hold sound from before the skip, the blocks after it are
+    // silent. Past ShortTermBlocks of them, the ring is all silence and windows stay below the
+    // absolute gate: ending more blocks changes nothing but the position in the current block.
+    AkUInt32 uBlocksEnded = 0;
+    AkUInt32 uFrames = in_uFrames;
+    while (uFrames > 0 && uBlocksEnded <= ShortTermBlocks)
+    {
+        const AkUInt32 uBlockFramesLeft = m_uBlockFrames - m_uBlockFramesDone;
+        if (uFrames < uBlockFramesLeft)
+        {
+            m_uBlockFramesDone += uFrames;
+            return;
+        }
+        uFrames -= uBlockFramesLeft;
+        m_uBlockFramesDone = m_uBlockFrames;
+        EndBlock();
+        ++uBlocksEnded;
+    }
+    m_uBlockFramesDone = uFrames % m_uBlockFrames;
+}
+
+AkReal64 WoaGainLoudness::FilterChannel(Channel& io_channel, const AkReal32* in_pBuf, AkUInt32 in_uFrames) const
+{
+    const Biquad shelf = m_shelf;
+    const Biquad highPass = m_highPass;
+    AkReal64 fShelfZ1 = io_channel.fShelfZ1, fShelfZ2 = io_channel.fShelfZ2;
+    AkReal64 fHighPassZ1 = io_channel.fHighPassZ1, fHighPassZ2 = io_channel.fHighPassZ2;
+
+    AkReal64 fSumSq = 0.;
+    for (AkUInt32 i = 0; i < in_uFrames; ++i)
+    {
+        const AkReal64 fIn = (AkReal64)in_pBuf[i];
+        const AkReal64 fShelf = shelf.b0 * fIn + fShelfZ1;
+        fShelfZ1 = shelf.b1 * fIn - shelf.a1 * fShelf + fShelfZ2;
+        fShelfZ2 = shelf.b2 * fIn - shelf.a2 * fShelf;
+
+        const AkReal64 fOut = highPass.b0 * fShelf + fHighPassZ1;
+        fHighPassZ1 = highPass.b1 * fShelf - highPass.a1 * fOut + fHighPassZ2;
+        fHighPassZ2 = highPass.b2 * fShelf - highPass.a2 * fOut;
+        fSumSq += fOut * fOut;
+    }
+
+    io_channel.fShelfZ1 = fShelfZ1;
+    io_channel.fShelfZ2 = fShelfZ2;
+    io_channel.fHighPassZ1 = fHighPassZ1;
+    io_channel.fHighPassZ2 = fHighPassZ2;
+    return fSumSq;
+}
+
+void WoaGainLoudness::EndBlock()
+{
+    m_fBlockPowers[m_uNextBlock] = m_fBlockEnergy / (AkReal64)m_uBlockFrames;
+    m_uNextBlock = (m_uNextBlock + 1) % ShortTermBlocks;
+    if (m_uNumBlocks < ShortTermBlocks)
+        ++m_uNumBlocks;
+    m_fBlockEnergy = 0.;
+    m_uBlockFramesDone = 0;
+
+    // Gating windows are complete 400 ms windows only
+    if (m_uNumBlocks < MomentaryBlocks)
+        return;
+
+    AkReal64 fPower = 0.;
+    for (AkUInt32 i = 1; i <= MomentaryBlocks; ++i)
+        fPower += m_fBlockPowers[(m_uNextBlock + ShortTermBlocks - i) % ShortTermBlocks];
+    const AkReal64 fLufs = PowerToLufs(fPower / MomentaryBlocks);
+    if (fLufs <= kAbsoluteGateLufs)
+        return;
+
+    const AkReal64 fBin = (fLufs - HistogramMinLufs) * HistogramBinsPerLu;
+    const AkUInt32 uBin = fBin < (AkReal64)NumHistogramBins ? (AkUInt32)fBin : NumHistogramBins - 1;
+    ++m_uHistogram[uBin];
+}
+
+AkReal32 WoaGainLoudness::GetWindowLoudness(AkUInt32 in_uNumBlocks) const
+{
+    const AkUInt32 uNumBlocks = in_uNumBlocks < m_uNumBlocks ? in_uNumBlocks : m_uNumBlocks;
+    if (uNumBlocks == 0)
+        return -INFINITY;
+
+    AkReal64 fPower = 0.;
+    for (AkUInt32 i = 1; i <= uNumBlocks; ++i)
+        fPower += m_fBlockPowers[(m_uNextBlock + ShortTermBlocks - i) % ShortTermBlocks];
+    return (AkReal32)PowerToLufs(fPower / uNumBlocks);
+}
+
+AkReal32 WoaGainLoudness::GetIntegrated() const
+{
+    AkUInt64 uCount = 0;
+    AkReal64 fPower = 0.;
+    for (AkUInt32 i = 0; i < NumHistogramBins; ++i)
+    {
+        uCount += m_uHistogram[i];
+        fPower += m_uHistogram[i] * GetBinPower(i);
+    }
+    if (uCount == 0)
+        return -INFINITY;
+
+    // Relative gate: only the bins centered above it
+    const AkReal64 fGateLufs = PowerToLufs(fPower / (AkReal64)uCount) + kRelativeGateLu;
+    uCount = 0;
+    fPower = 0.;
+    for (AkUInt32 i = 0; i < NumHistogramBins; ++i)
+    {
+        const AkReal64 fBinLufs = HistogramMinLufs + (i + 0.5) / HistogramBinsPerLu;
+        if (fBinLufs > fGateLufs)
+        {
+            uCount += m_uHistogram[i];
+            fPower += m_uHistogram[i] * GetBinPower(i);
+        }
+    }
+    return uCount > 0 ? (AkReal32)PowerToLufs(fPower / (AkReal64)uCount) : -INFINITY;
+}
+
+AkReal64 WoaGainLoudness::PowerToLufs(AkReal64 in_fPower)
+{
+    return in_fPower > 0. ? -0.691 + 10. * log10(in_fPower) : -INFINITY;
+}
+
+AkReal64 WoaGainLoudness::GetBinPower(AkUInt32 in_uBin)
+{
+    // Computed once for all meters
+    struct BinPowers
+    {
+        BinPowers()
+        {
+            for (AkUInt32 i = 0; i < NumHistogramBins; ++i)
+                fPowers[i] = pow(10., (HistogramMinLufs + (i + 0.5) / HistogramBinsPerLu + 0.691) / 10.);
+        }
+        AkReal64 fPowers[NumHistogramBins];
+    };
+    static const BinPowers binPowers;
+    return binPowers.fPowers[in_uBin];
+}
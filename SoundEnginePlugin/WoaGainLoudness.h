@@ -0,0 +1,132 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainLoudness_H
+#define WoaGainLoudness_H
+
+#include <AK/SoundEngine/Common/IAkPlugin.h>
+
+/// ITU-R BS.1770-4 loudness meter, measuring the output of WoaGainFX when loudness metering is on.
+///
+/// Samples go through the K-weighting filter (high shelf then high-pass, in double precision) and
+/// their weighted powers are summed over 100 ms blocks. The momentary (400 ms) and short-term (3 s)
+/// loudness are the mean powers of the last 4 and 30 blocks, kept in a ring. The integrated
+/// loudness gates the 400 ms windows ending at every block (75% overlap) at -70 LUFS, then 10 LU
+/// below the loudness of the windows above that gate. Windows are counted in a histogram of 0.1 LU
+/// bins rather than stored, so memory is constant over any duration, at the cost of rounding the
+/// loudness of each window to its bin center (at most 0.05 LU).
+///
+/// All the memory is allocated by Create. Levels are in LUFS, -infinity before any sound.
+class WoaGainLoudness
+{
+public:
+    static const AkUInt32 MomentaryBlocks = 4;
+    static const AkUInt32 ShortTermBlocks = 30;
+
+    /// Creates a meter for in_channelConfig at in_uSampleRate. Channels are weighted as in
+    /// BS.1770-4: side surrounds by 1.41, the LFE not at all, other channels by 1.
+    /// Returns nullptr when the allocation fails.
+    static WoaGainLoudness* Create(AK::IAkPluginMemAlloc* in_pAllocator, AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate);
+
+    /// Releases a meter obtained from Create.
+    void Destroy(AK::IAkPluginMemAlloc* in_pAllocator);
+
+    /// Clears the filters, the windows and the integrated loudness.
+    void Reset();
+
+    /// Filters and measures in_uFrames frames of in_pBuffer. Returns the number of 100 ms blocks
+    /// that ended, after which the windows have new values.
+    AkUInt32 Process(AkAudioBuffer* in_pBuffer, AkUInt32 in_uFrames);
+
+    /// Same as processing in_uFrames frames of silence. Once the short-term window holds only
+    /// silence, the remaining frames are skipped in constant time. The filters are cleared
+    /// rather than left to decay, which only changes the first milliseconds after the silence.
+    void Skip(AkUInt32 in_uFrames);
+
+    /// Frames per 100 ms block, at which rate the windows are updated.
+    AkUInt32 GetBlockFrames() const { return m_uBlockFrames; }
+
+    AkReal32 GetMomentary() const { return GetWindowLoudness(MomentaryBlocks); }
+    AkReal32 GetShortTerm() const { return GetWindowLoudness(ShortTermBlocks); }
+
+    /// Gated loudness of everything measured since the last Reset. Goes over the histogram:
+    /// meant to be called at the monitoring rate, not on every buffer.
+    AkReal32 GetIntegrated() const;
+
+private:
+    static const AkInt32 HistogramMinLufs = -70;
+    static const AkInt32 HistogramMaxLufs = 10;   ///< Louder windows are counted in the last bin
+    static const AkUInt32 HistogramBinsPerLu = 10;
+    static const AkUInt32 NumHistogramBins = (HistogramMaxLufs - HistogramMinLufs) * HistogramBinsPerLu;
+
+    /// Biquad coefficients, normalized by a0.
+    struct Biquad
+    {
+        AkReal64 b0, b1, b2, a1, a2;
+    };
+
+    /// Filter state of a channel, for the transposed direct form II of both stages.
+    struct Channel
+    {
+        AkReal64 fWeight;
+        AkReal64 fShelfZ1, fShelfZ2;
+        AkReal64 fHighPassZ1, fHighPassZ2;
+    };
+
+    WoaGainLoudness(AkUInt32 in_uNumChannels, AkUInt32 in_uSampleRate);
+
+    /// Filters in_uFrames samples of in_pBuf through io_channel and returns the sum of the squares of the output.
+    AkReal64 FilterChannel(Channel& io_channel, const AkReal32* in_pBuf, AkUInt32 in_uFrames) const;
+
+    /// Stores the power of the block that just ended and counts the 400 ms window ending with it.
+    void EndBlock();
+
+    /// Loudness of the mean power of the last in_uNumBlocks blocks, or of the blocks so far.
+    AkReal32 GetWindowLoudness(AkUInt32 in_uNumBlocks) const;
+
+    static AkReal64 PowerToLufs(AkReal64 in_fPower);
+
+    /// Mean power of the windows in histogram bin in_uBin, taken at the bin center.
+    static AkReal64 GetBinPower(AkUInt32 in_uBin);
+
+    Channel* m_pChannels;
+    AkUInt32 m_uNumChannels;
+
+    Biquad m_shelf;
+    Biquad m_highPass;
+
+    AkUInt32 m_uBlockFrames;        ///< Frames per 100 ms block
+    AkUInt32 m_uBlockFramesDone;    ///< Frames of the current block measured so far
+    AkReal64 m_fBlockEnergy;        ///< Weighted sum of squares of the current block
+
+    AkReal64 m_fBlockPowers[ShortTermBlocks];   ///< Ring of the mean powers of the last blocks
+    AkUInt32 m_uNextBlock;          ///< Ring index of the next block
+    AkUInt32 m_uNumBlocks;          ///< Blocks in the ring, up to ShortTermBlocks
+
+    AkUInt32 m_uHistogram[NumHistogramBins];    ///< 400 ms windows above the absolute gate, per 0.1 LU
+};
+
+#endif // WoaGainLoudness_H
@@ -0,0 +1,214 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainPool.h"
+#include "WoaGainAlloc.h"
+
+#include <AK/Tools/Common/AkAssert.h>
+
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+#include <emmintrin.h>
+#endif
+#include <thread>
+
+namespace
+{
+    // Blocks and the slab header take whole cache lines, so that neighbouring blocks, which may
+    // belong to voices processed on different threads, never share one
+    const size_t kBlockAlignment = WoaGainAlloc::CacheLineSize;
+
+    // Spins on the lock before yielding the thread to the one holding it
+    const AkUInt32 kSpinsBeforeYield = 64;
+
+    // Pools created so far, linked through SlabPool::m_pNextPool
+    std::atomic<WoaGainPool::SlabPool*> s_pPools(nullptr);
+
+    // Whether the Term global callback is registered with the running sound engine
+    std::atomic<bool> s_bTermCallbackRegistered(false);
+
+    size_t AlignUp(size_t in_uSize)
+    {
+        return (in_uSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+    }
+
+    void SpinPause()
+    {
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+        _mm_pause();
+#endif
+    }
+
+    void OnTerm(AK::IAkGlobalPluginContext* in_pContext, AkGlobalCallbackLocation /*in_eLocation*/, void* /*in_pCookie*/)
+    {
+        in_pContext->UnregisterGlobalCallback(OnTerm, AkGlobalCallbackLocation_Term);
+        s_bTermCallbackRegistered.store(false, std::memory_order_release);
+        WoaGainPool::Release();
+    }
+}
+
+WoaGainPool::SlabPool::SlabPool(size_t in_uBlockSize)
+    : m_uBlockSize(AlignUp(in_uBlockSize))
+    , m_pNextPool(s_pPools.load(std::memory_order_relaxed))
+    , m_pSlabs(nullptr)
+    , m_pFreeBlocks(nullptr)
+    , m_uNumLive(0)
+    , m_bReleasePending(false)
+    , m_uNumSlabs(0)
+{
+    while (!s_pPools.compare_exchange_weak(m_pNextPool, this, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+void* WoaGainPool::SlabPool::Alloc(AK::IAkPluginMemAlloc* in_pAllocator)
+{
+    // A new sound engine after a Release still waiting for the last blocks: keep the slabs
+    if (m_bReleasePending.load(std::memory_order_relaxed))
+        m_bReleasePending.store(false, std::memory_order_relaxed);
+
+    // Only one thread takes blocks off the list at a time, so that the block read as the head
+    // cannot be taken, then freed again, before the exchange: the list needs no ABA tag. Free
+    // pushing blocks meanwhile only makes the exchange fail and read the new head.
+    Lock();
+    FreeBlock* pBlock = m_pFreeBlocks.load(std::memory_order_acquire);
+    while (pBlock && !m_pFreeBlocks.compare_exchange_weak(pBlock, pBlock->pNext, std::memory_order_acquire, std::memory_order_acquire))
+    {
+    }
+    Unlock();
+
+    if (!pBlock)
+    {
+        // Slab allocations are rare, and made without holding the lock. Threads creating objects
+        // at the same time may each allocate one.
+        const size_t uHeaderSize = AlignUp(sizeof(Slab));
+        AkUInt8* pMem = (AkUInt8*)AK_PLUGIN_ALLOC_ALIGN(in_pAllocator, uHeaderSize + m_uBlockSize * BlocksPerSlab, kBlockAlignment);
+        if (!pMem)
+            return nullptr;
+
+        Slab* pSlab = (Slab*)pMem;
+        pSlab->pAllocator = in_pAllocator;
+
+        // The first block is returned, the others are threaded in address order
+        AkUInt8* pBlocks = pMem + uHeaderSize;
+        for (AkUInt32 i = 1; i < BlocksPerSlab - 1; ++i)
+            ((FreeBlock*)(pBlocks + i * m_uBlockSize))->pNext = (FreeBlock*)(pBlocks + (i + 1) * m_uBlockSize);
+
+        Lock();
+        pSlab->pNext = m_pSlabs;
+        m_pSlabs = pSlab;
+        ++m_uNumSlabs;
+        Unlock();
+
+        PushFree((FreeBlock*)(pBlocks + m_uBlockSize), (FreeBlock*)(pBlocks + (BlocksPerSlab - 1) * m_uBlockSize));
+        pBlock = (FreeBlock*)pBlocks;
+    }
+
+    m_uNumLive.fetch_add(1, std::memory_order_relaxed);
+    return pBlock;
+}
+
+void WoaGainPool::SlabPool::Free(void* in_pBlock)
+{
+    if (!in_pBlock)
+        return;
+
+    // Pushed before being counted out, so that no block is pushed once the slabs may be released
+    FreeBlock* pBlock = (FreeBlock*)in_pBlock;
+    PushFree(pBlock, pBlock);
+    AKASSERT(m_uNumLive.load(std::memory_order_relaxed) > 0);
+    if (m_uNumLive.fetch_sub(1, std::memory_order_seq_cst) == 1 && m_bReleasePending.load(std::memory_order_seq_cst))
+        ReleaseSlabs();
+}
+
+bool WoaGainPool::SlabPool::Release()
+{
+    // Either this thread sees no block handed out, or the thread freeing the last one sees the
+    // pending release; both may, and ReleaseSlabs lets only one of them through
+    m_bReleasePending.store(true, std::memory_order_seq_cst);
+    if (m_uNumLive.load(std::memory_order_seq_cst) != 0)
+        return false;
+
+    ReleaseSlabs();
+    return true;
+}
+
+void WoaGainPool::SlabPool::ReleaseSlabs()
+{
+    if (!m_bReleasePending.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    while (m_pSlabs)
+    {
+        Slab* pSlab = m_pSlabs;
+        m_pSlabs = pSlab->pNext;
+        AK_PLUGIN_FREE(pSlab->pAllocator, pSlab);
+    }
+    m_pFreeBlocks.store(nullptr, std::memory_order_relaxed);
+    m_uNumSlabs = 0;
+}
+
+void WoaGainPool::SlabPool::PushFree(FreeBlock* in_pFirst, FreeBlock* in_pLast)
+{
+    FreeBlock* pHead = m_pFreeBlocks.load(std::memory_order_relaxed);
+    do
+    {
+        in_pLast->pNext = pHead;
+    } while (!m_pFreeBlocks.compare_exchange_weak(pHead, in_pFirst, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void WoaGainPool::SlabPool::Lock()
+{
+    AkUInt32 uSpins = 0;
+    while (m_lock.test_and_set(std::memory_order_acquire))
+    {
+        if (++uSpins < kSpinsBeforeYield)
+            SpinPause();
+        else
+            std::this_thread::yield();
+    }
+}
+
+void WoaGainPool::SlabPool::Unlock()
+{
+    m_lock.clear(std::memory_order_release);
+}
+
+bool WoaGainPool::Release()
+{
+    bool bReleased = true;
+    for (SlabPool* pPool = s_pPools.load(std::memory_order_acquire); pPool; pPool = pPool->m_pNextPool)
+        bReleased = pPool->Release() && bReleased;
+    return bReleased;
+}
+
+void WoaGainPool::RegisterTermCallback(AK::IAkGlobalPluginContext* in_pGlobalContext, AkPluginType in_eType, AkUInt32 in_ulCompanyID, AkUInt32 in_ulPluginID)
+{
+    if (!in_pGlobalContext || s_bTermCallbackRegistered.load(std::memory_order_acquire) || s_bTermCallbackRegistered.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    if (in_pGlobalContext->RegisterGlobalCallback(in_eType, in_ulCompanyID, in_ulPluginID, OnTerm, AkGlobalCallbackLocation_Term) != AK_Success)
+        s_bTermCallbackRegistered.store(false, std::memory_order_release);
+}
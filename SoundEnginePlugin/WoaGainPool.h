@@ -0,0 +1,137 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainPool_H
+#define WoaGainPool_H
+
+#include <AK/SoundEngine/Common/IAkPlugin.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+/// Pooled allocation of plug-in objects, used instead of AK_PLUGIN_NEW and AK_PLUGIN_DELETE when
+/// WOAGAIN_POOLED_ALLOC is defined. Objects of a given type are carved from slabs of
+/// SlabPool::BlocksPerSlab blocks allocated through the plug-in allocator, and recycled when
+/// deleted, so that a burst of voices costs one allocation per slab instead of one per object.
+/// Slabs are kept when their objects are deleted, until the sound engine terminates: the effect
+/// registers a Term global callback with RegisterTermCallback, which calls Release.
+namespace WoaGainPool
+{
+    /// Fixed-size block allocator. Thread-safe: Free pushes the block on a lock-free list and never
+    /// waits, Alloc takes blocks off it under a spin flag shared with the other allocations only.
+    class SlabPool
+    {
+    public:
+        static const AkUInt32 BlocksPerSlab = 32;
+
+        explicit SlabPool(size_t in_uBlockSize);
+
+        /// Returns an uninitialized block, allocating a new slab from in_pAllocator when none is free.
+        /// Returns nullptr when the slab allocation fails.
+        void* Alloc(AK::IAkPluginMemAlloc* in_pAllocator);
+
+        /// Returns a block obtained from Alloc to the pool. Lock-free, and only releases memory
+        /// when the block is the last one handed out after Release.
+        void Free(void* in_pBlock);
+
+        /// Returns the slabs to their allocators once every block is back in the pool: right away
+        /// when they are, and returns true, or else when the last block is freed. Must not run
+        /// concurrently with Alloc, nor be followed by an Alloc before the slabs are released.
+        bool Release();
+
+        AkUInt32 GetNumSlabs() const { return m_uNumSlabs; }
+        size_t GetBlockSize() const { return m_uBlockSize; }
+
+    private:
+        struct Slab
+        {
+            Slab* pNext;
+            AK::IAkPluginMemAlloc* pAllocator;  ///< Allocator the slab is returned to
+        };
+
+        struct FreeBlock
+        {
+            FreeBlock* pNext;
+        };
+
+        /// Pushes the blocks from in_pFirst to in_pLast, already linked, on the free list.
+        void PushFree(FreeBlock* in_pFirst, FreeBlock* in_pLast);
+
+        /// Returns every slab to its allocator, if Release is pending and no other thread did.
+        void ReleaseSlabs();
+
+        void Lock();
+        void Unlock();
+
+        const size_t m_uBlockSize;
+        SlabPool* m_pNextPool;          ///< In the list of the pools walked by WoaGainPool::Release
+        Slab* m_pSlabs;
+        std::atomic<FreeBlock*> m_pFreeBlocks;
+        std::atomic<AkUInt32> m_uNumLive;   ///< Blocks handed out
+        std::atomic<bool> m_bReleasePending;    ///< Set by Release, cleared by the thread releasing the slabs
+        AkUInt32 m_uNumSlabs;
+        std::atomic_flag m_lock = ATOMIC_FLAG_INIT;   ///< Serializes the removals from the free list and the slab list
+
+        friend bool Release();
+    };
+
+    /// Releases the slabs of every pool, see SlabPool::Release. Returns false when a pool still has
+    /// blocks handed out: parameter nodes may outlive the Term global callback, and the pool then
+    /// keeps its slabs until its last block is freed.
+    bool Release();
+
+    /// Registers a Term global callback calling Release through in_pGlobalContext, which may be
+    /// nullptr, unless one is already registered. Called when an effect is initialized, since the
+    /// factories have no context; the callback lets the next sound engine register it again.
+    void RegisterTermCallback(AK::IAkGlobalPluginContext* in_pGlobalContext, AkPluginType in_eType, AkUInt32 in_ulCompanyID, AkUInt32 in_ulPluginID);
+
+    /// The pool of the objects of type T.
+    template <typename T>
+    SlabPool& GetPool()
+    {
+        static SlabPool s_pool(sizeof(T));
+        return s_pool;
+    }
+
+    /// Constructs a T from in_args in a block of its pool. Returns nullptr when out of memory.
+    template <typename T, typename... Args>
+    T* New(AK::IAkPluginMemAlloc* in_pAllocator, Args&&... in_args)
+    {
+        void* pBlock = GetPool<T>().Alloc(in_pAllocator);
+        return pBlock ? ::new (pBlock) T(std::forward<Args>(in_args)...) : nullptr;
+    }
+
+    /// Destroys an object created with New and returns its block to its pool.
+    template <typename T>
+    void Delete(T* in_pObject)
+    {
+        in_pObject->~T();
+        GetPool<T>().Free(in_pObject);
+    }
+}
+
+#endif // WoaGainPool_H
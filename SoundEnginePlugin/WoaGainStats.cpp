@@ -0,0 +1,107 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#include "WoaGainStats.h"
+
+#include <AK/Tools/Common/AkPlatformFuncs.h>
+
+#include <math.h>
+
+void WoaGainStats::Reset()
+{
+    m_uCalls.store(0, std::memory_order_relaxed);
+    m_uMeteredCalls.store(0, std::memory_order_relaxed);
+    m_uFrames.store(0, std::memory_order_relaxed);
+    m_uTicks.store(0, std::memory_order_relaxed);
+    m_uMinTicks.store(~(AkUInt64)0, std::memory_order_relaxed);
+    m_uMaxTicks.store(0, std::memory_order_relaxed);
+    for (AkUInt32 i = 0; i < WoaGainDSP::Path_Count; ++i)
+    {
+        m_uPathCalls[i].store(0, std::memory_order_relaxed);
+        m_uPathTicks[i].store(0, std::memory_order_relaxed);
+    }
+    for (AkUInt32 i = 0; i < NumBuckets; ++i)
+        m_uBuckets[i].store(0, std::memory_order_relaxed);
+}
+
+void WoaGainStats::GetSummary(Summary& out_summary) const
+{
+    AkInt64 iFrequency;
+    AKPLATFORM::PerformanceFrequency(&iFrequency);
+    const AkReal64 fNsPerTick = 1e9 / (AkReal64)iFrequency;
+
+    out_summary.uCalls = m_uCalls.load(std::memory_order_relaxed);
+    out_summary.uMeteredCalls = m_uMeteredCalls.load(std::memory_order_relaxed);
+    out_summary.uFrames = m_uFrames.load(std::memory_order_relaxed);
+    for (AkUInt32 i = 0; i < WoaGainDSP::Path_Count; ++i)
+    {
+        const AkUInt64 uPathCalls = m_uPathCalls[i].load(std::memory_order_relaxed);
+        out_summary.uPathCalls[i] = uPathCalls;
+        out_summary.fPathAvgNs[i] = uPathCalls > 0 ? (AkReal32)(m_uPathTicks[i].load(std::memory_order_relaxed) * fNsPerTick / (AkReal64)uPathCalls) : 0.f;
+    }
+
+    const AkUInt64 uCalls = out_summary.uCalls;
+    if (uCalls == 0)
+    {
+        out_summary.fMinNs = out_summary.fAvgNs = out_summary.fP99Ns = out_summary.fMaxNs = out_summary.fNsPerFrame = 0.f;
+        return;
+    }
+
+    const AkReal64 fTicks = (AkReal64)m_uTicks.load(std::memory_order_relaxed);
+    const AkReal64 fMinTicks = (AkReal64)m_uMinTicks.load(std::memory_order_relaxed);
+    const AkReal64 fMaxTicks = (AkReal64)m_uMaxTicks.load(std::memory_order_relaxed);
+    out_summary.fMinNs = (AkReal32)(fMinTicks * fNsPerTick);
+    out_summary.fMaxNs = (AkReal32)(fMaxTicks * fNsPerTick);
+    out_summary.fAvgNs = (AkReal32)(fTicks * fNsPerTick / (AkReal64)uCalls);
+    out_summary.fNsPerFrame = out_summary.uFrames > 0 ? (AkReal32)(fTicks * fNsPerTick / (AkReal64)out_summary.uFrames) : 0.f;
+
+    // First bucket reaching 99% of the calls, counted from the histogram itself, which may
+    // be a call ahead of or behind uCalls
+    AkUInt64 uTotal = 0;
+    for (AkUInt32 i = 0; i < NumBuckets; ++i)
+        uTotal += m_uBuckets[i].load(std::memory_order_relaxed);
+    const AkUInt64 uRank = (uTotal * 99 + 99) / 100;
+    AkUInt64 uCount = 0;
+    AkUInt32 uBucket = 0;
+    for (; uBucket < NumBuckets - 1; ++uBucket)
+    {
+        uCount += m_uBuckets[uBucket].load(std::memory_order_relaxed);
+        if (uCount >= uRank)
+            break;
+    }
+    const AkReal64 fP99Ticks = fmin(fmax(GetBucketTicks(uBucket), fMinTicks), fMaxTicks);
+    out_summary.fP99Ns = (AkReal32)(fP99Ticks * fNsPerTick);
+}
+
+AkReal64 WoaGainStats::GetBucketTicks(AkUInt32 in_uBucket)
+{
+    if (in_uBucket == 0)
+        return 0.;
+    const AkUInt32 uExponent = (in_uBucket - 1) >> 2;
+    const AkUInt32 uMantissa = (in_uBucket - 1) & 3;
+    return ldexp(1. + (uMantissa + 0.5) * 0.25, (int)uExponent);
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainStats_H
+#define WoaGainStats_H
+
+#include "WoaGainDSP.h"
+
+#include <atomic>
+#include <string.h>
+
+/// Execution statistics of one WoaGainFX instance, kept when WOAGAIN_ENABLE_STATS is defined:
+/// time per Execute call, frames processed and calls per DSP path, since Init.
+///
+/// Times are in ticks of AKPLATFORM::PerformanceCounter, converted to ns by GetSummary, and
+/// counted in a histogram of 4 log-spaced buckets per octave (within 25% of the actual time),
+/// from which the 99th percentile is read. Everything is a fixed-size array of atomics: the audio
+/// thread is the only writer, with relaxed loads and stores rather than read-modify-writes, and
+/// GetSummary can be called from any thread. A summary read during a call may count that call in
+/// some totals and not in others.
+class WoaGainStats
+{
+public:
+    static const AkUInt32 NumBuckets = 128;
+
+    struct Summary
+    {
+        AkUInt64 uCalls;
+        AkUInt64 uMeteredCalls;     ///< Calls that ran the metered kernel
+        AkUInt64 uFrames;
+        AkUInt64 uPathCalls[WoaGainDSP::Path_Count];
+        AkReal32 fPathAvgNs[WoaGainDSP::Path_Count];    ///< Mean time of the calls of each path, 0 without calls
+        AkReal32 fMinNs;            ///< All times are 0 without calls
+        AkReal32 fAvgNs;
+        AkReal32 fP99Ns;            ///< 99% of the calls took at most about this long
+        AkReal32 fMaxNs;
+        AkReal32 fNsPerFrame;       ///< Total time over total frames
+    };
+
+    WoaGainStats() { Reset(); }
+
+    /// Clears the statistics. Not to be called while the audio thread is recording.
+    void Reset();
+
+    /// Counts a call of in_iTicks ticks that processed in_uFrames frames with in_ePath. Audio thread only.
+    AkForceInline void Record(AkInt64 in_iTicks, AkUInt32 in_uFrames, WoaGainDSP::Path in_ePath, bool in_bMetered)
+    {
+        const AkUInt64 uTicks = in_iTicks > 0 ? (AkUInt64)in_iTicks : 0;
+        Add(m_uCalls, 1);
+        Add(m_uFrames, in_uFrames);
+        Add(m_uTicks, uTicks);
+        if (in_bMetered)
+            Add(m_uMeteredCalls, 1);
+        Add(m_uPathCalls[in_ePath], 1);
+        Add(m_uPathTicks[in_ePath], uTicks);
+        if (uTicks < m_uMinTicks.load(std::memory_order_relaxed))
+            m_uMinTicks.store(uTicks, std::memory_order_relaxed);
+        if (uTicks > m_uMaxTicks.load(std::memory_order_relaxed))
+            m_uMaxTicks.store(uTicks, std::memory_order_relaxed);
+        std::atomic<AkUInt32>& bucket = m_uBuckets[GetBucket(uTicks)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// Reads the statistics recorded so far. Goes over the histogram: meant for profiling tools
+    /// and monitoring, not to be called on every buffer.
+    void GetSummary(Summary& out_summary) const;
+
+private:
+    /// Single writer increment, see the class description.
+    static AkForceInline void Add(std::atomic<AkUInt64>& io_counter, AkUInt64 in_uValue)
+    {
+        io_counter.store(io_counter.load(std::memory_order_relaxed) + in_uValue, std::memory_order_relaxed);
+    }
+
+    /// Bucket 0 holds 0 ticks, bucket 1 + 4e + m the times whose float has exponent e and top two
+    /// mantissa bits m, i.e. [1 + m/4, 1 + (m+1)/4) * 2^e ticks. Longer times go to the last bucket.
+    static AkForceInline AkUInt32 GetBucket(AkUInt64 in_uTicks)
+    {
+        if (in_uTicks == 0)
+            return 0;
+        const AkReal32 fTicks = (AkReal32)in_uTicks;
+        AkUInt32 uBits;
+        memcpy(&uBits, &fTicks, sizeof(uBits));
+        const AkUInt32 uBucket = 1 + (uBits >> 21) - (127 << 2);
+        return uBucket < NumBuckets ? uBucket : NumBuckets - 1;
+    }
+
+    /// Middle of bucket in_uBucket, in ticks.
+    static AkReal64 GetBucketTicks(AkUInt32 in_uBucket);
+
+    std::atomic<AkUInt64> m_uCalls;
+    std::atomic<AkUInt64> m_uMeteredCalls;
+    std::atomic<AkUInt64> m_uFrames;
+    std::atomic<AkUInt64> m_uTicks;
+    std::atomic<AkUInt64> m_uMinTicks;
+    std::atomic<AkUInt64> m_uMaxTicks;
+    std::atomic<AkUInt64> m_uPathCalls[WoaGainDSP::Path_Count];
+    std::atomic<AkUInt64> m_uPathTicks[WoaGainDSP::Path_Count];
+    std::atomic<AkUInt32> m_uBuckets[NumBuckets];
+};
+
+#endif // WoaGainStats_H
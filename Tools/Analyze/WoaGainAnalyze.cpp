@@ -0,0 +1,300 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// WoaGainAnalyze: measures the integrated loudness and sample peak of WAV files offline, and
+// writes the gain offsets that bring them to a target loudness as a table for the bank.
+//
+// Every file goes through the same BS.1770 meter as the effect (WoaGainLoudness), with its peak
+// taken in the same pass. Files are analyzed in parallel by a pool of --jobs threads with work
+// stealing, largest first. The offset of a file is the target minus its integrated loudness,
+// lowered when needed so that its peak stays under --ceiling, and limited to --max dB either way.
+// Silent files get no offset.
+//
+// The effect applies the offset of the node it is inserted on, so each file is keyed by the
+// short ID of the Sound playing it, given as ID=file.wav. A file given without one is keyed by
+// the hash of its name (WoaGainOffsetTable::GetFileKey). One CSV line per file is printed in the
+// order of the inputs, then a summary line, and with -o the table is written for the authoring
+// plug-in to put in the bank.
+//
+// Usage: WoaGainAnalyze [--target LUFS] [--ceiling dBFS] [--max dB] [--jobs N] [-o table] [ID=]<input.wav>...
+
+#include "../Render/WoaGainWav.h"
+#include "../Render/WoaGainWorkStealingPool.h"
+#include "../Host/WoaGainHost.h"
+#include "../../SoundEnginePlugin/WoaGainLoudness.h"
+#include "../../WoaGainOffsetTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const AkUInt16 kFrames = 4096;
+
+    struct Options
+    {
+        AkReal32 fTargetLoudness;   ///< In LUFS
+        AkReal32 fCeiling;          ///< Highest peak after the offset, in dBFS
+        AkReal32 fMaxOffset;        ///< Largest offset either way, in dB
+        AkUInt32 uNumJobs;          ///< Files analyzed in parallel
+        const char* szTable;        ///< Output table, or nullptr
+    };
+
+    struct Input
+    {
+        const char* szPath;
+        AkUInt32 uKey;
+    };
+
+    struct Result
+    {
+        bool bValid;
+        AkReal32 fIntegrated;   ///< In LUFS, -infinity for silence
+        AkReal32 fPeak;         ///< Sample peak in dBFS
+        AkUInt64 uBytes;        ///< Bytes of sample data
+    };
+
+    // Measures one file into out_result
+    bool AnalyzeFile(const char* in_szPath, Result& out_result)
+    {
+        WoaGainWav::Reader reader;
+        if (!reader.Open(in_szPath))
+        {
+            fprintf(stderr, "%s: %s\n", in_szPath, reader.GetError());
+            return false;
+        }
+
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(reader.GetFormat().uNumChannels);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::Buffer buffer;
+        WoaGainLoudness* pLoudness = WoaGainLoudness::Create(&allocator, channelConfig, reader.GetFormat().uSampleRate);
+        if (!pLoudness || !buffer.Allocate(channelConfig, kFrames))
+        {
+            if (pLoudness)
+                pLoudness->Destroy(&allocator);
+            fprintf(stderr, "%s: cannot allocate the meter\n", in_szPath);
+            return false;
+        }
+
+        AkReal32 fPeak = 0.f;
+        for (AkUInt64 uFrame = 0; uFrame < reader.GetNumFrames(); uFrame += kFrames)
+        {
+            AkAudioBuffer& audioBuffer = buffer.Get();
+            reader.Read(uFrame, audioBuffer);
+            for (AkUInt32 uChannel = 0; uChannel < channelConfig.uNumChannels; ++uChannel)
+            {
+                const AkReal32* pSamples = audioBuffer.GetChannel(uChannel);
+                for (AkUInt32 i = 0; i < audioBuffer.uValidFrames; ++i)
+                    fPeak = std::max(fPeak, fabsf(pSamples[i]));
+            }
+            pLoudness->Process(&audioBuffer, audioBuffer.uValidFrames);
+        }
+
+        out_result.fIntegrated = pLoudness->GetIntegrated();
+        out_result.fPeak = 20.f * log10f(fPeak);
+        out_result.uBytes = reader.GetNumFrames() * reader.GetFormat().GetBytesPerFrame();
+        pLoudness->Destroy(&allocator);
+        return true;
+    }
+
+    // Offset in hundredths of a dB, see the top of the file
+    AkInt16 GetOffset(const Result& in_result, const Options& in_options)
+    {
+        AkReal32 fOffset = in_options.fTargetLoudness - in_result.fIntegrated;
+        fOffset = std::min(fOffset, in_options.fCeiling - in_result.fPeak);
+        fOffset = std::max(std::min(fOffset, in_options.fMaxOffset), -in_options.fMaxOffset);
+        return (AkInt16)lroundf(fOffset * 100.f);
+    }
+
+    bool WriteTable(const char* in_szPath, std::vector<WoaGainOffsetTable::Entry>& io_entries)
+    {
+        std::sort(io_entries.begin(), io_entries.end(),
+            [](const WoaGainOffsetTable::Entry& a, const WoaGainOffsetTable::Entry& b) { return a.uKey < b.uKey; });
+
+        WoaGainOffsetTable::FileHeader header;
+        header.uMagic = WoaGainOffsetTable::Magic;
+        header.uVersion = WoaGainOffsetTable::Version;
+        header.uReserved = 0;
+        header.uNumEntries = (AkUInt32)io_entries.size();
+
+        std::vector<AkUInt8> data(sizeof(header) + io_entries.size() * WoaGainOffsetTable::EntrySize);
+        memcpy(data.data(), &header, sizeof(header));
+        for (size_t i = 0; i < io_entries.size(); ++i)
+            WoaGainOffsetTable::WriteEntry(io_entries[i], data.data() + sizeof(header) + i * WoaGainOffsetTable::EntrySize);
+
+        FILE* pFile = fopen(in_szPath, "wb");
+        if (!pFile)
+            return false;
+        const bool bWritten = fwrite(data.data(), 1, data.size(), pFile) == data.size();
+        return fclose(pFile) == 0 && bWritten;
+    }
+
+    void PrintUsage(const char* in_szProgram)
+    {
+        fprintf(stderr, "Usage: %s [--target LUFS] [--ceiling dBFS] [--max dB] [--jobs N] [-o table] [ID=]<input.wav>...\n", in_szProgram);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.fTargetLoudness = -23.f;
+    options.fCeiling = -1.f;
+    options.fMaxOffset = 24.f;
+    options.uNumJobs = std::thread::hardware_concurrency();
+    options.szTable = nullptr;
+
+    std::vector<Input> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool bHasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--target") == 0 && bHasValue)
+            options.fTargetLoudness = (AkReal32)atof(argv[++i]);
+        else if (strcmp(argv[i], "--ceiling") == 0 && bHasValue)
+            options.fCeiling = (AkReal32)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max") == 0 && bHasValue)
+            options.fMaxOffset = std::min(std::max((AkReal32)atof(argv[++i]), 0.f), 300.f);
+        else if (strcmp(argv[i], "--jobs") == 0 && bHasValue)
+            options.uNumJobs = (AkUInt32)std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "-o") == 0 && bHasValue)
+            options.szTable = argv[++i];
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            // A leading decimal short ID followed by '=' keys the file, its name does otherwise
+            Input input;
+            char* szEnd;
+            const unsigned long uID = strtoul(argv[i], &szEnd, 10);
+            if (szEnd != argv[i] && *szEnd == '=')
+            {
+                input.szPath = szEnd + 1;
+                input.uKey = (AkUInt32)uID;
+            }
+            else
+            {
+                input.szPath = argv[i];
+                input.uKey = WoaGainOffsetTable::GetFileKey(argv[i]);
+            }
+            inputs.push_back(input);
+        }
+    }
+    if (inputs.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (options.uNumJobs == 0)
+        options.uNumJobs = 1;
+    if (inputs.size() > WoaGainOffsetTable::MaxEntries)
+    {
+        fprintf(stderr, "At most %u files per table\n", WoaGainOffsetTable::MaxEntries);
+        return 1;
+    }
+
+    // Largest files first, so that the last jobs to run are short ones
+    std::vector<AkUInt32> order(inputs.size());
+    std::vector<AkUInt64> sizes(inputs.size());
+    for (AkUInt32 i = 0; i < (AkUInt32)inputs.size(); ++i)
+    {
+        struct stat fileStat;
+        sizes[i] = stat(inputs[i].szPath, &fileStat) == 0 ? (AkUInt64)fileStat.st_size : 0;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sizes](AkUInt32 a, AkUInt32 b) { return sizes[a] > sizes[b]; });
+
+    std::vector<Result> results(inputs.size());
+    const AkUInt32 uNumThreads = std::min(options.uNumJobs, (AkUInt32)inputs.size());
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    WoaGainWorkStealingPool pool;
+    pool.Run((AkUInt32)inputs.size(), uNumThreads, [&](AkUInt32 in_uJob)
+    {
+        const AkUInt32 uInput = order[in_uJob];
+        results[uInput].bValid = AnalyzeFile(inputs[uInput].szPath, results[uInput]);
+    });
+    const AkReal64 fSeconds = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+
+    // Results in the order of the inputs. A key given twice would make the table ambiguous.
+    std::vector<WoaGainOffsetTable::Entry> entries;
+    AkUInt32 uNumFailed = 0;
+    AkUInt64 uBytes = 0;
+    printf("key,integrated_lufs,peak_dbfs,offset_db,file\n");
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        const Result& result = results[i];
+        if (!result.bValid)
+        {
+            ++uNumFailed;
+            continue;
+        }
+        uBytes += result.uBytes;
+        if (!(result.fIntegrated > -INFINITY))
+        {
+            printf("%u,-inf,%.2f,,%s\n", inputs[i].uKey, result.fPeak, inputs[i].szPath);
+            continue;
+        }
+
+        WoaGainOffsetTable::Entry entry;
+        entry.uKey = inputs[i].uKey;
+        entry.iOffset = GetOffset(result, options);
+        printf("%u,%.2f,%.2f,%.2f,%s\n", entry.uKey, result.fIntegrated, result.fPeak, WoaGainOffsetTable::GetOffsetDb(entry), inputs[i].szPath);
+        entries.push_back(entry);
+    }
+
+    std::vector<AkUInt32> keys;
+    for (const WoaGainOffsetTable::Entry& entry : entries)
+        keys.push_back(entry.uKey);
+    std::sort(keys.begin(), keys.end());
+    if (std::adjacent_find(keys.begin(), keys.end()) != keys.end())
+    {
+        fprintf(stderr, "Two files have the same key, give them distinct IDs\n");
+        return 1;
+    }
+    if (options.szTable && !WriteTable(options.szTable, entries))
+    {
+        fprintf(stderr, "%s: cannot write the table\n", options.szTable);
+        return 1;
+    }
+
+    const AkReal64 fMegabytes = (AkReal64)uBytes / (1024. * 1024.);
+    fprintf(stderr, "files=%u failed=%u jobs=%u entries=%u input_mb=%.1f seconds=%.3f mb_per_sec=%.1f\n",
+        (AkUInt32)inputs.size(), uNumFailed, uNumThreads, (AkUInt32)entries.size(), fMegabytes, fSeconds,
+        fSeconds > 0. ? fMegabytes / fSeconds : 0.);
+    return uNumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,1128 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// WoaGainBench: measures the throughput of WoaGainFX::Execute outside of the Wwise runtime.
+//
+// Every configuration (channel layout x buffer size x metering x gain automation) is run on
+// the same deterministic noise and reported as one machine-readable line on stdout, as CSV
+// (default) or JSON lines (--json). Times are the best of several repetitions.
+//
+// The output and state checks of the modes below are run by WoaGainTests, the bench only times them.
+//
+// With --timeskip, WoaGainFX::TimeSkip is measured instead, per skipped frame, as for virtual
+// voices.
+//
+// With --alloc, bursts of instances are created then terminated instead, reporting the time per
+// instance, the memory in use per instance and the allocator calls (with its own CSV columns).
+// Build with WOAGAIN_POOLED_ALLOC to compare with pooled allocation.
+//
+// With --batch, N mono instances process one buffer each, by calling WoaGainFX::Execute on every
+// instance or WoaGainFX::ExecuteBatch once, for N from 1 to 1024 (with its own CSV columns).
+//
+// With --exp2, the dB to linear conversions are timed instead (powf, AK_DBTOLIN and the scalar and
+// vectorized WoaGainDSP::DbToLinFast), with their largest error over the -96 to +10 dB range of the
+// gain, followed by the stereo buffer kernels ramping along each smoothing curve (with their own
+// CSV columns). Times are per converted value, and per sample for the ramps.
+//
+// With --events, stereo buffers are timed with 0 to 4 gain events each (with their own CSV columns).
+//
+// With --kernels, the buffer kernels of every instruction set supported by the CPU (see
+// WoaGainDSP::Isa) are timed per sample at a constant gain, along a linear ramp and along an
+// S-curve ramp, with and without metering, with their speedup over the AKSIMD kernels (with their
+// own CSV columns).
+//
+// With --levels, stereo buffers are timed without metering, with a level key and monitored, then
+// WoaGainLevelRegistry reads with 1 to 16 instances publishing under the same key (with their own
+// CSV columns).
+//
+// --isa forces the instruction set of the kernels selected by the instances, as the WOAGAIN_ISA
+// environment variable does, for any mode.
+//
+// With --baseline, the configurations are timed as usual and compared with a CSV output of an
+// earlier run, and the run fails when one is more than --tolerance percent (25 by default) slower
+// than its baseline even after being timed again, or when the median of the ratios to the
+// baseline is more than --median-tolerance percent (10 by default) above 1. Builds configured with
+// WOAGAIN_PERF_TESTS register it with CTest under the perf label, against WoaGainBaseline.csv.
+//
+// With --stats, in builds with WOAGAIN_ENABLE_STATS, stereo instances process buffers with every
+// gain automation and the execution statistics they kept are printed instead (with their own CSV
+// columns), after checking their counts against the buffers processed.
+//
+// Usage: WoaGainBench [--json] [--quick] [--isa sse2|avx2|avx512] [--timeskip | --alloc | --batch | --stats | --exp2 | --events | --kernels | --levels | --baseline file.csv [--tolerance %] [--median-tolerance %]]
+
+#include "../Host/WoaGainHost.h"
+#include "../Host/WoaGainSignals.h"
+#include "../../SoundEnginePlugin/WoaGainFX.h"
+#include "../../SoundEnginePlugin/WoaGainLevelRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    using namespace WoaGainSignals;
+
+    const AkUInt32 kSampleRate = 48000;
+
+    struct Config
+    {
+        AkChannelConfig channelConfig;
+        AkUInt16 uFrames;
+        bool bMetering;
+        Automation eAutomation;
+        bool bTimeSkip;     ///< Skip the buffers instead of processing them
+    };
+
+    struct Result
+    {
+        AkReal64 fNsPerFrame;
+        AkReal64 fFramesPerSec;
+    };
+
+    Result Run(const Config& in_config, AkUInt32 in_uTargetSamples, AkUInt32 in_uRepetitions)
+    {
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        context.bCanPostMonitorData = in_config.bMetering;
+
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(in_config.channelConfig, kSampleRate);
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_DUMMY_ID, GetAutomatedGain(in_config.eAutomation, 0));
+
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(in_config.channelConfig, in_config.uFrames);
+        buffer.Allocate(in_config.channelConfig, in_config.uFrames);
+        source.FillNoise(1234, 0.5f);
+
+        AkUInt32 uNumBuffers = in_uTargetSamples / source.GetNumSamples();
+        uNumBuffers = (uNumBuffers + BuffersPerChunk - 1) / BuffersPerChunk * BuffersPerChunk;
+        if (uNumBuffers < 2 * BuffersPerChunk)
+            uNumBuffers = 2 * BuffersPerChunk;
+
+        AkReal64 fBestSeconds = 0.;
+        AkUInt32 uBuffer = 0;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumBuffers / BuffersPerChunk; ++uChunk)
+            {
+                buffer.CopyFrom(source);
+
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < BuffersPerChunk; ++i, ++uBuffer)
+                {
+                    if (in_config.eAutomation == Automation_Steps || in_config.eAutomation == Automation_Sweep)
+                        instance.SetParam(PARAM_DUMMY_ID, GetAutomatedGain(in_config.eAutomation, uBuffer));
+                    if (in_config.bTimeSkip)
+                        instance.TimeSkip(in_config.uFrames);
+                    else
+                        instance.Execute(buffer.Get());
+                }
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+
+        const AkReal64 fFrames = (AkReal64)uNumBuffers * in_config.uFrames;
+        Result result;
+        result.fNsPerFrame = fBestSeconds * 1e9 / fFrames;
+        result.fFramesPerSec = fFrames / fBestSeconds;
+        return result;
+    }
+
+    struct AllocResult
+    {
+        AkReal64 fNsPerCreate;      ///< Creation and Init of the effect and its parameter node
+        AkReal64 fNsPerTerm;
+        AkReal64 fBytesPerInstance; ///< Peak memory in use divided by the number of instances
+        AkUInt32 uNumAllocs;
+        AkUInt32 uNumFrees;
+    };
+
+    // Creates then terminates a burst of in_uNumInstances stereo instances, keeping the best times
+    AllocResult RunAlloc(AkUInt32 in_uNumInstances, AkUInt32 in_uRepetitions)
+    {
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(WoaGainHost::GetChannelConfig(2), kSampleRate);
+        WoaGainHost::EffectContext context;
+        std::unique_ptr<WoaGainHost::Instance[]> instances(new WoaGainHost::Instance[in_uNumInstances]);
+
+        AllocResult result = AllocResult();
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            WoaGainHost::Allocator allocator;
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+                instances[i].Init(allocator, context, format);
+            const std::chrono::steady_clock::time_point created = std::chrono::steady_clock::now();
+            for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+                instances[i].Term();
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            const AkReal64 fNsPerCreate = std::chrono::duration<AkReal64, std::nano>(created - start).count() / in_uNumInstances;
+            const AkReal64 fNsPerTerm = std::chrono::duration<AkReal64, std::nano>(end - created).count() / in_uNumInstances;
+            if (uRep == 0 || fNsPerCreate < result.fNsPerCreate)
+                result.fNsPerCreate = fNsPerCreate;
+            if (uRep == 0 || fNsPerTerm < result.fNsPerTerm)
+                result.fNsPerTerm = fNsPerTerm;
+            result.fBytesPerInstance = (AkReal64)allocator.uPeakBytesInUse / in_uNumInstances;
+            result.uNumAllocs = allocator.uNumAllocs;
+            result.uNumFrees = allocator.uNumFrees;
+        }
+        return result;
+    }
+
+    void PrintAllocResult(bool in_bJson, AkUInt32 in_uNumInstances, const AllocResult& in_result)
+    {
+#ifdef WOAGAIN_POOLED_ALLOC
+        const int iPooled = 1;
+#else
+        const int iPooled = 0;
+#endif
+        if (in_bJson)
+        {
+            printf("{\"instances\":%u,\"pooled\":%s,\"ns_per_create\":%.1f,\"ns_per_term\":%.1f,\"bytes_per_instance\":%.1f,\"allocs\":%u,\"frees\":%u}\n",
+                in_uNumInstances, iPooled ? "true" : "false", in_result.fNsPerCreate, in_result.fNsPerTerm,
+                in_result.fBytesPerInstance, in_result.uNumAllocs, in_result.uNumFrees);
+        }
+        else
+        {
+            printf("%u,%d,%.1f,%.1f,%.1f,%u,%u\n",
+                in_uNumInstances, iPooled, in_result.fNsPerCreate, in_result.fNsPerTerm,
+                in_result.fBytesPerInstance, in_result.uNumAllocs, in_result.uNumFrees);
+        }
+        fflush(stdout);
+    }
+
+    WoaGainFX* GetFX(WoaGainHost::Instance& in_instance)
+    {
+        return static_cast<WoaGainFX*>(in_instance.GetEffect());
+    }
+
+    // Time per buffer of in_uNumInstances mono instances at a constant gain, each processing
+    // one buffer of in_uFrames frames, with Execute on each instance or a single ExecuteBatch
+    AkReal64 RunBatch(AkUInt32 in_uNumInstances, AkUInt16 in_uFrames, bool in_bBatch, AkUInt32 in_uTargetSamples, AkUInt32 in_uRepetitions)
+    {
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(1);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+
+        std::unique_ptr<WoaGainHost::Instance[]> instances(new WoaGainHost::Instance[in_uNumInstances]);
+        std::unique_ptr<WoaGainHost::Buffer[]> sources(new WoaGainHost::Buffer[in_uNumInstances]);
+        std::unique_ptr<WoaGainHost::Buffer[]> buffers(new WoaGainHost::Buffer[in_uNumInstances]);
+        std::unique_ptr<WoaGainFX*[]> batchFX(new WoaGainFX*[in_uNumInstances]);
+        std::unique_ptr<AkAudioBuffer*[]> batchBuffers(new AkAudioBuffer*[in_uNumInstances]);
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            instances[i].Init(allocator, context, format);
+            instances[i].SetParam(PARAM_DUMMY_ID, -6.f);
+            sources[i].Allocate(channelConfig, in_uFrames);
+            sources[i].FillNoise(1234 + i, 0.5f);
+            buffers[i].Allocate(channelConfig, in_uFrames);
+            batchFX[i] = GetFX(instances[i]);
+            batchBuffers[i] = &buffers[i].Get();
+        }
+
+        AkUInt32 uNumChunks = in_uTargetSamples / (in_uNumInstances * in_uFrames * BuffersPerChunk);
+        if (uNumChunks < 2)
+            uNumChunks = 2;
+
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumChunks; ++uChunk)
+            {
+                for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+                    buffers[i].CopyFrom(sources[i]);
+
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 uBuffer = 0; uBuffer < BuffersPerChunk; ++uBuffer)
+                {
+                    if (in_bBatch)
+                    {
+                        WoaGainFX::ExecuteBatch(batchFX.get(), batchBuffers.get(), in_uNumInstances);
+                    }
+                    else
+                    {
+                        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+                            instances[i].Execute(buffers[i].Get());
+                    }
+                }
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+            instances[i].Term();
+        return fBestSeconds * 1e9 / ((AkReal64)uNumChunks * BuffersPerChunk * in_uNumInstances);
+    }
+
+    void PrintBatchResult(bool in_bJson, AkUInt32 in_uNumInstances, AkUInt16 in_uFrames, bool in_bBatch, AkReal64 in_fNsPerBuffer)
+    {
+        const char* szMode = in_bBatch ? "batch" : "execute";
+        const AkReal64 fFramesPerSec = in_uFrames * 1e9 / in_fNsPerBuffer;
+        if (in_bJson)
+        {
+            printf("{\"instances\":%u,\"frames\":%u,\"mode\":\"%s\",\"ns_per_buffer\":%.1f,\"frames_per_sec\":%.0f}\n",
+                in_uNumInstances, in_uFrames, szMode, in_fNsPerBuffer, fFramesPerSec);
+        }
+        else
+        {
+            printf("%u,%u,%s,%.1f,%.0f\n", in_uNumInstances, in_uFrames, szMode, in_fNsPerBuffer, fFramesPerSec);
+        }
+        fflush(stdout);
+    }
+
+#ifdef WOAGAIN_ENABLE_STATS
+    // Processes in_uNumBuffers buffers with in_config and reads back the statistics of the instance.
+    // Returns false when they do not count every buffer, frame and path.
+    bool RunStats(const Config& in_config, AkUInt32 in_uNumBuffers, WoaGainStats::Summary& out_summary)
+    {
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        context.bCanPostMonitorData = in_config.bMetering;
+
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(in_config.channelConfig, kSampleRate);
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_DUMMY_ID, GetAutomatedGain(in_config.eAutomation, 0));
+
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(in_config.channelConfig, in_config.uFrames);
+        buffer.Allocate(in_config.channelConfig, in_config.uFrames);
+        source.FillNoise(1234, 0.5f);
+
+        for (AkUInt32 uBuffer = 0; uBuffer < in_uNumBuffers; ++uBuffer)
+        {
+            if (uBuffer % BuffersPerChunk == 0)
+                buffer.CopyFrom(source);
+            if (in_config.eAutomation == Automation_Steps || in_config.eAutomation == Automation_Sweep)
+                instance.SetParam(PARAM_DUMMY_ID, GetAutomatedGain(in_config.eAutomation, uBuffer));
+            instance.Execute(buffer.Get());
+        }
+
+        WoaGainFX* pFX = GetFX(instance);
+        pFX->GetStats(out_summary);
+        bool bValid = out_summary.uCalls == in_uNumBuffers
+            && out_summary.uFrames == (AkUInt64)in_uNumBuffers * in_config.uFrames
+            && out_summary.uMeteredCalls == (in_config.bMetering ? in_uNumBuffers : 0)
+            && out_summary.fMinNs <= out_summary.fAvgNs && out_summary.fAvgNs <= out_summary.fMaxNs
+            && out_summary.fMinNs <= out_summary.fP99Ns && out_summary.fP99Ns <= out_summary.fMaxNs;
+        for (AkUInt32 i = 0; i < WoaGainDSP::Path_Count; ++i)
+            bValid = bValid && out_summary.uPathCalls[i] == pFX->GetPathCount((WoaGainDSP::Path)i);
+        instance.Term();
+        return bValid;
+    }
+
+    void PrintStatsResult(bool in_bJson, const Config& in_config, const WoaGainStats::Summary& in_summary)
+    {
+        const char* szAutomation = GetAutomationName(in_config.eAutomation);
+        if (in_bJson)
+        {
+            printf("{\"frames\":%u,\"metering\":%s,\"automation\":\"%s\",\"calls\":%llu,\"min_ns\":%.0f,\"avg_ns\":%.0f,\"p99_ns\":%.0f,\"max_ns\":%.0f,\"ns_per_frame\":%.4f}\n",
+                in_config.uFrames, in_config.bMetering ? "true" : "false", szAutomation, (unsigned long long)in_summary.uCalls,
+                in_summary.fMinNs, in_summary.fAvgNs, in_summary.fP99Ns, in_summary.fMaxNs, in_summary.fNsPerFrame);
+        }
+        else
+        {
+            printf("%u,%d,%s,%llu,%.0f,%.0f,%.0f,%.0f,%.4f\n",
+                in_config.uFrames, in_config.bMetering ? 1 : 0, szAutomation, (unsigned long long)in_summary.uCalls,
+                in_summary.fMinNs, in_summary.fAvgNs, in_summary.fP99Ns, in_summary.fMaxNs, in_summary.fNsPerFrame);
+        }
+        fflush(stdout);
+    }
+#endif
+
+    // dB to linear conversions of --exp2
+    enum Conversion
+    {
+        Conversion_Powf,
+        Conversion_DbToLin,
+        Conversion_Fast,
+        Conversion_FastVector,
+        Conversion_Count
+    };
+
+    const char* GetConversionName(Conversion in_eConversion)
+    {
+        switch (in_eConversion)
+        {
+        case Conversion_Powf: return "powf";
+        case Conversion_DbToLin: return "AK_DBTOLIN";
+        case Conversion_Fast: return "DbToLinFast";
+        case Conversion_FastVector: return "DbToLinFast_v4";
+        default: return "unknown";
+        }
+    }
+
+    void Convert(Conversion in_eConversion, const AkReal32* in_pDb, AkReal32* out_pLin, AkUInt32 in_uCount)
+    {
+        switch (in_eConversion)
+        {
+        case Conversion_Powf:
+            for (AkUInt32 i = 0; i < in_uCount; ++i)
+                out_pLin[i] = powf(10.f, in_pDb[i] / 20.f);
+            break;
+        case Conversion_DbToLin:
+            for (AkUInt32 i = 0; i < in_uCount; ++i)
+                out_pLin[i] = AK_DBTOLIN(in_pDb[i]);
+            break;
+        case Conversion_Fast:
+            for (AkUInt32 i = 0; i < in_uCount; ++i)
+                out_pLin[i] = WoaGainDSP::DbToLinFast(in_pDb[i]);
+            break;
+        default:
+            WoaGainDSP::DbToLinFast(in_pDb, out_pLin, in_uCount);
+            break;
+        }
+    }
+
+    struct Exp2Result
+    {
+        AkReal64 fNsPerValue;
+        AkReal64 fMaxErrorDb;
+    };
+
+    // Largest error of in_eConversion over 2^20 values evenly spread over the range of the gain,
+    // then the time of converting blocks of values that stay in the cache
+    Exp2Result RunConversion(Conversion in_eConversion, AkUInt32 in_uRepetitions)
+    {
+        const AkUInt32 kNumValues = 1 << 20;
+        std::vector<AkReal32> db(kNumValues), lin(kNumValues);
+        for (AkUInt32 i = 0; i < kNumValues; ++i)
+            db[i] = -96.f + 106.f * (AkReal32)i / (AkReal32)(kNumValues - 1);
+        Convert(in_eConversion, db.data(), lin.data(), kNumValues);
+
+        Exp2Result result;
+        result.fMaxErrorDb = 0.;
+        for (AkUInt32 i = 0; i < kNumValues; ++i)
+            result.fMaxErrorDb = fmax(result.fMaxErrorDb, fabs(20. * log10((AkReal64)lin[i]) - db[i]));
+
+        const AkUInt32 kBlockValues = 1024;
+        const AkUInt32 kNumBlocks = 2048;
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (AkUInt32 uBlock = 0; uBlock < kNumBlocks; ++uBlock)
+                Convert(in_eConversion, db.data() + (uBlock & 63) * kBlockValues, lin.data(), kBlockValues);
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        result.fNsPerValue = fBestSeconds * 1e9 / ((AkReal64)kNumBlocks * kBlockValues);
+        return result;
+    }
+
+    // Largest error of the gains of a -96 to +10 dB ramp along in_eCurve against the exact curve,
+    // then the time of the stereo buffer kernel ramping between -6 and +6 dB, so that the signal
+    // neither decays nor grows over the buffers processed between refills
+    Exp2Result RunCurveRamp(WoaGainDSP::Curve in_eCurve, bool in_bMetering, AkUInt16 in_uFrames, AkUInt32 in_uRepetitions)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        const WoaGainDSP::ProcessFunc fnProcess = WoaGainDSP::GetProcessFunc(2, in_bMetering);
+        WoaGainDSP::ChannelMeter meters[2];
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(channelConfig, in_uFrames);
+        buffer.Allocate(channelConfig, in_uFrames);
+
+        Exp2Result result;
+        result.fMaxErrorDb = 0.;
+        const WoaGainDSP::BufferGain fullRange = MakeCurveRamp(in_eCurve, in_uFrames, -96.f, 10.f);
+        for (AkUInt32 i = 0; i < buffer.GetNumSamples(); ++i)
+            buffer.GetData()[i] = 1.f;
+        fnProcess(&buffer.Get(), fullRange, meters);
+        const AkReal32* pGains = buffer.Get().GetChannel(0);
+        for (AkUInt32 i = 0; i < in_uFrames; ++i)
+        {
+            const AkReal64 fPos = (i + 1.) / in_uFrames;
+            AkReal64 fExpected;
+            if (in_eCurve == WoaGainDSP::Curve_Linear)
+                fExpected = pow(10., -96. / 20.) + (pow(10., 10. / 20.) - pow(10., -96. / 20.)) * fPos;
+            else
+                fExpected = pow(10., (-96. + 106. * (in_eCurve == WoaGainDSP::Curve_SCurve ? fPos * fPos * (3. - 2. * fPos) : fPos)) / 20.);
+            result.fMaxErrorDb = fmax(result.fMaxErrorDb, fabs(20. * log10(pGains[i] / fExpected)));
+        }
+
+        const WoaGainDSP::BufferGain rampUp = MakeCurveRamp(in_eCurve, in_uFrames, -6.f, 6.f);
+        const WoaGainDSP::BufferGain rampDown = MakeCurveRamp(in_eCurve, in_uFrames, 6.f, -6.f);
+        source.FillNoise(1234, 0.5f);
+        const AkUInt32 uNumChunks = (1 << 20) / (source.GetNumSamples() * BuffersPerChunk) + 1;
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumChunks; ++uChunk)
+            {
+                buffer.CopyFrom(source);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < BuffersPerChunk; ++i)
+                    fnProcess(&buffer.Get(), (i & 1) ? rampDown : rampUp, meters);
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        result.fNsPerValue = fBestSeconds * 1e9 / ((AkReal64)uNumChunks * BuffersPerChunk * source.GetNumSamples());
+        return result;
+    }
+
+    // Time per sample of stereo buffers of in_uFrames frames with in_uEventsPerBuffer gain events
+    // each, spread over the buffer. The events of a chunk are posted before it is timed.
+    AkReal64 RunEvents(AkUInt16 in_uFrames, AkUInt32 in_uEventsPerBuffer, AkUInt32 in_uRepetitions)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_DUMMY_ID, -6.f);
+        WoaGainFXParams* pParams = static_cast<WoaGainFXParams*>(instance.GetParams());
+
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(channelConfig, in_uFrames);
+        buffer.Allocate(channelConfig, in_uFrames);
+        source.FillNoise(1234, 0.5f);
+
+        const AkUInt32 uNumChunks = (1 << 20) / (source.GetNumSamples() * BuffersPerChunk) + 1;
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumChunks; ++uChunk)
+            {
+                // Between -6 and -12 dB, so that the signal neither decays nor grows
+                buffer.CopyFrom(source);
+                for (AkUInt32 i = 0; i < BuffersPerChunk * in_uEventsPerBuffer; ++i)
+                    pParams->PostGainEvent((i + 1) * in_uFrames / in_uEventsPerBuffer - 1, (i & 1) ? -6.f : -12.f);
+
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < BuffersPerChunk; ++i)
+                    instance.Execute(buffer.Get());
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        instance.Term();
+        return fBestSeconds * 1e9 / ((AkReal64)uNumChunks * BuffersPerChunk * source.GetNumSamples());
+    }
+
+    // Time of the kernel of in_eIsa per sample, in ns
+    AkReal64 RunKernel(WoaGainDSP::Isa in_eIsa, AkUInt32 in_uNumChannels, AkUInt16 in_uFrames, bool in_bMetering, KernelGain in_eGain, AkUInt32 in_uRepetitions)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(in_uNumChannels);
+        const WoaGainDSP::ProcessFunc fnProcess = WoaGainDSP::GetProcessFunc(in_uNumChannels, in_bMetering, in_eIsa);
+        const WoaGainDSP::BufferGain gainUp = MakeKernelGain(in_eGain, in_uFrames, true);
+        const WoaGainDSP::BufferGain gainDown = MakeKernelGain(in_eGain, in_uFrames, false);
+        std::vector<WoaGainDSP::ChannelMeter> meters(in_uNumChannels);
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(channelConfig, in_uFrames);
+        buffer.Allocate(channelConfig, in_uFrames);
+        source.FillNoise(1234, 0.5f);
+
+        const AkUInt32 uNumChunks = (1 << 20) / (source.GetNumSamples() * BuffersPerChunk) + 1;
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumChunks; ++uChunk)
+            {
+                buffer.CopyFrom(source);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < BuffersPerChunk; ++i)
+                    fnProcess(&buffer.Get(), (i & 1) ? gainDown : gainUp, meters.data());
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        return fBestSeconds * 1e9 / ((AkReal64)uNumChunks * BuffersPerChunk * source.GetNumSamples());
+    }
+
+    // Keys of --levels
+    const AkUInt32 kLevelKey = 1001;
+    // Metering of the buffers timed by --levels
+    enum LevelMode
+    {
+        LevelMode_Off,      ///< Neither monitored nor publishing
+        LevelMode_Publish,  ///< Publishing under a level key, not monitored
+        LevelMode_Monitor,  ///< Monitored, not publishing
+        LevelMode_Count
+    };
+
+    const char* GetLevelModeName(LevelMode in_eMode)
+    {
+        switch (in_eMode)
+        {
+        case LevelMode_Off: return "off";
+        case LevelMode_Publish: return "level_key";
+        case LevelMode_Monitor: return "monitored";
+        default: return "";
+        }
+    }
+
+    // Time per sample of stereo buffers of in_uFrames frames, metered at the default meter rate
+    // as in_eMode requires
+    AkReal64 RunLevelPublish(AkUInt16 in_uFrames, LevelMode in_eMode, AkUInt32 in_uRepetitions)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        context.bCanPostMonitorData = in_eMode == LevelMode_Monitor;
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_DUMMY_ID, -6.f);
+        instance.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)(in_eMode == LevelMode_Publish ? kLevelKey : 0));
+
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(channelConfig, in_uFrames);
+        buffer.Allocate(channelConfig, in_uFrames);
+        source.FillNoise(1234, 0.5f);
+
+        const AkUInt32 uNumChunks = (1 << 20) / (source.GetNumSamples() * BuffersPerChunk) + 1;
+        AkReal64 fBestSeconds = 0.;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            std::chrono::steady_clock::duration elapsed(0);
+            for (AkUInt32 uChunk = 0; uChunk < uNumChunks; ++uChunk)
+            {
+                buffer.CopyFrom(source);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < BuffersPerChunk; ++i)
+                    instance.Execute(buffer.Get());
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(elapsed).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        instance.Term();
+        return fBestSeconds * 1e9 / ((AkReal64)uNumChunks * BuffersPerChunk * source.GetNumSamples());
+    }
+
+    // Time of a WoaGainLevelRegistry::Read of the level of in_uPublishers instances publishing under
+    // the same key
+    AkReal64 RunLevelRead(AkUInt32 in_uPublishers, AkUInt32 in_uRepetitions)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        std::vector<std::unique_ptr<WoaGainHost::Instance>> instances;
+        WoaGainHost::Buffer buffer;
+        buffer.Allocate(channelConfig, 256);
+        for (AkUInt32 i = 0; i < in_uPublishers; ++i)
+        {
+            instances.emplace_back(new WoaGainHost::Instance);
+            instances.back()->Init(allocator, context, format);
+            instances.back()->SetParam(PARAM_METER_RATE_ID, 0.f);
+            instances.back()->SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)kLevelKey);
+            buffer.FillNoise(i + 1, 0.5f);
+            instances.back()->Execute(buffer.Get());
+        }
+
+        const AkUInt32 uNumReads = 1 << 18;
+        AkReal64 fBestSeconds = 0.;
+        AkReal32 fSink = 0.f;
+        for (AkUInt32 uRep = 0; uRep < in_uRepetitions; ++uRep)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (AkUInt32 i = 0; i < uNumReads; ++i)
+            {
+                WoaGainLevelRegistry::Level level;
+                if (WoaGainLevelRegistry::Read(kLevelKey, level))
+                    fSink += level.fRmsDb;
+            }
+            const AkReal64 fSeconds = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+            if (uRep == 0 || fSeconds < fBestSeconds)
+                fBestSeconds = fSeconds;
+        }
+        if (fSink == 1.f)
+            printf("\n");   // Keeps the reads
+        return fBestSeconds * 1e9 / uNumReads;
+    }
+
+    // One line of a CSV output of the default mode, see --baseline
+    struct BaselineEntry
+    {
+        char szLayout[16];
+        AkUInt32 uFrames;
+        AkInt32 iMetering;
+        char szAutomation[16];
+        AkReal64 fNsPerFrame;
+    };
+
+    // Times a configuration slower than its baseline is run again, keeping the fastest run
+    const AkUInt32 kBaselineRetries = 3;
+
+    bool LoadBaseline(const char* in_szPath, std::vector<BaselineEntry>& out_entries)
+    {
+        FILE* pFile = fopen(in_szPath, "r");
+        if (!pFile)
+            return false;
+        char szLine[256];
+        while (fgets(szLine, sizeof(szLine), pFile))
+        {
+            BaselineEntry entry;
+            AkUInt32 uChannels;
+            if (sscanf(szLine, "%15[^,],%u,%u,%d,%15[^,],%lf", entry.szLayout, &uChannels, &entry.uFrames,
+                    &entry.iMetering, entry.szAutomation, &entry.fNsPerFrame) == 6)
+                out_entries.push_back(entry);
+        }
+        fclose(pFile);
+        return !out_entries.empty();
+    }
+
+    const BaselineEntry* FindBaseline(const std::vector<BaselineEntry>& in_entries, const Config& in_config)
+    {
+        const char* szLayout = WoaGainHost::GetChannelConfigName(in_config.channelConfig);
+        const char* szAutomation = GetAutomationName(in_config.eAutomation);
+        for (const BaselineEntry& entry : in_entries)
+        {
+            if (strcmp(entry.szLayout, szLayout) == 0 && entry.uFrames == in_config.uFrames &&
+                (entry.iMetering != 0) == in_config.bMetering && strcmp(entry.szAutomation, szAutomation) == 0)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    void PrintHeader(bool in_bJson)
+    {
+        if (!in_bJson)
+            printf("layout,channels,frames,metering,automation,ns_per_frame,frames_per_sec\n");
+    }
+
+    void PrintResult(bool in_bJson, const Config& in_config, const Result& in_result)
+    {
+        const char* szLayout = WoaGainHost::GetChannelConfigName(in_config.channelConfig);
+        const AkUInt32 uChannels = in_config.channelConfig.uNumChannels;
+        const char* szAutomation = GetAutomationName(in_config.eAutomation);
+        if (in_bJson)
+        {
+            printf("{\"layout\":\"%s\",\"channels\":%u,\"frames\":%u,\"metering\":%s,\"automation\":\"%s\",\"ns_per_frame\":%.4f,\"frames_per_sec\":%.0f}\n",
+                szLayout, uChannels, in_config.uFrames, in_config.bMetering ? "true" : "false", szAutomation,
+                in_result.fNsPerFrame, in_result.fFramesPerSec);
+        }
+        else
+        {
+            printf("%s,%u,%u,%d,%s,%.4f,%.0f\n",
+                szLayout, uChannels, in_config.uFrames, in_config.bMetering ? 1 : 0, szAutomation,
+                in_result.fNsPerFrame, in_result.fFramesPerSec);
+        }
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool bJson = false;
+    bool bQuick = false;
+    bool bTimeSkip = false;
+    bool bAlloc = false;
+    bool bBatch = false;
+    bool bStats = false;
+    bool bExp2 = false;
+    bool bEvents = false;
+    bool bKernels = false;
+    bool bLevels = false;
+    const char* szIsa = nullptr;
+    const char* szBaseline = nullptr;
+    AkReal64 fTolerance = 25.;
+    AkReal64 fMedianTolerance = 10.;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            bJson = true;
+        else if (strcmp(argv[i], "--quick") == 0)
+            bQuick = true;
+        else if (strcmp(argv[i], "--timeskip") == 0)
+            bTimeSkip = true;
+        else if (strcmp(argv[i], "--alloc") == 0)
+            bAlloc = true;
+        else if (strcmp(argv[i], "--batch") == 0)
+            bBatch = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            bStats = true;
+        else if (strcmp(argv[i], "--exp2") == 0)
+            bExp2 = true;
+        else if (strcmp(argv[i], "--events") == 0)
+            bEvents = true;
+        else if (strcmp(argv[i], "--kernels") == 0)
+            bKernels = true;
+        else if (strcmp(argv[i], "--levels") == 0)
+            bLevels = true;
+        else if (strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+            szIsa = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            szBaseline = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            fTolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--median-tolerance") == 0 && i + 1 < argc)
+            fMedianTolerance = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--json] [--quick] [--isa sse2|avx2|avx512] [--timeskip | --alloc | --batch | --stats | --exp2 | --events | --kernels | --levels | --baseline file.csv [--tolerance %%] [--median-tolerance %%]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    WoaGainDSP::Isa eIsa = WoaGainDSP::GetIsa();
+    if (szIsa)
+    {
+        if (!WoaGainDSP::ParseIsa(szIsa, eIsa))
+        {
+            fprintf(stderr, "Unknown instruction set: %s\n", szIsa);
+            return 1;
+        }
+        if (!WoaGainDSP::SetIsa(eIsa))
+        {
+            fprintf(stderr, "%s is not supported by this CPU, which supports up to %s\n", szIsa, WoaGainDSP::GetIsaName(WoaGainDSP::GetSupportedIsa()));
+            return 1;
+        }
+    }
+
+    if (bExp2)
+    {
+        const AkUInt32 uRepetitions = bQuick ? 3 : 10;
+        if (!bJson)
+            printf("conversion,ns_per_value,max_error_db\n");
+        for (int iConversion = 0; iConversion < Conversion_Count; ++iConversion)
+        {
+            const Exp2Result result = RunConversion((Conversion)iConversion, uRepetitions);
+            if (bJson)
+                printf("{\"conversion\":\"%s\",\"ns_per_value\":%.3f,\"max_error_db\":%.6f}\n", GetConversionName((Conversion)iConversion), result.fNsPerValue, result.fMaxErrorDb);
+            else
+                printf("%s,%.3f,%.6f\n", GetConversionName((Conversion)iConversion), result.fNsPerValue, result.fMaxErrorDb);
+        }
+
+        static const AkUInt16 kRampFrames[] = { 64, 512 };
+        if (!bJson)
+            printf("ramp,frames,metering,ns_per_sample,max_error_db\n");
+        for (AkUInt16 uFrames : kRampFrames)
+        {
+            for (int iMetering = 0; iMetering < 2; ++iMetering)
+            {
+                for (int iCurve = 0; iCurve < WoaGainDSP::Curve_Count; ++iCurve)
+                {
+                    const WoaGainDSP::Curve eCurve = (WoaGainDSP::Curve)iCurve;
+                    const Exp2Result result = RunCurveRamp(eCurve, iMetering != 0, uFrames, uRepetitions);
+                    if (bJson)
+                    {
+                        printf("{\"ramp\":\"%s\",\"frames\":%u,\"metering\":%s,\"ns_per_sample\":%.3f,\"max_error_db\":%.6f}\n",
+                            GetCurveName(eCurve), uFrames, iMetering ? "true" : "false", result.fNsPerValue, result.fMaxErrorDb);
+                    }
+                    else
+                    {
+                        printf("%s,%u,%d,%.3f,%.6f\n", GetCurveName(eCurve), uFrames, iMetering, result.fNsPerValue, result.fMaxErrorDb);
+                    }
+                }
+            }
+        }
+        fflush(stdout);
+        return 0;
+    }
+
+    if (bEvents)
+    {
+        static const AkUInt32 kEventsPerBuffer[] = { 0, 1, 4 };
+        static const AkUInt16 kTimedFrames[] = { 64, 256, 1024 };
+        const AkUInt32 uRepetitions = bQuick ? 3 : 10;
+        if (!bJson)
+            printf("frames,events_per_buffer,ns_per_sample\n");
+        for (AkUInt16 uFrames : kTimedFrames)
+        {
+            for (AkUInt32 uEvents : kEventsPerBuffer)
+            {
+                const AkReal64 fNsPerSample = RunEvents(uFrames, uEvents, uRepetitions);
+                if (bJson)
+                    printf("{\"frames\":%u,\"events_per_buffer\":%u,\"ns_per_sample\":%.3f}\n", uFrames, uEvents, fNsPerSample);
+                else
+                    printf("%u,%u,%.3f\n", uFrames, uEvents, fNsPerSample);
+            }
+        }
+        fflush(stdout);
+        return 0;
+    }
+
+    if (bKernels)
+    {
+        const AkInt32 iLastIsa = WoaGainDSP::GetSupportedIsa();
+        static const AkUInt32 kKernelChannels[] = { 1, 2, 6, 12, 16 };
+        static const AkUInt16 kTimedFrames[] = { 64, 256, 1024 };
+        const AkUInt32 uRepetitions = bQuick ? 3 : 10;
+        if (!bJson)
+            printf("isa,channels,frames,metering,gain,ns_per_sample,speedup\n");
+        for (AkUInt32 uChannels : kKernelChannels)
+        {
+            for (AkUInt16 uFrames : kTimedFrames)
+            {
+                for (int iMetering = 0; iMetering < 2; ++iMetering)
+                {
+                    for (int iGain = 0; iGain < KernelGain_Count; ++iGain)
+                    {
+                        // The variants of a configuration are timed one after the other, from the AKSIMD kernels
+                        AkReal64 fBaselineNs = 0.;
+                        for (AkInt32 iIsa = WoaGainDSP::Isa_Baseline; iIsa <= iLastIsa; ++iIsa)
+                        {
+                            const AkReal64 fNs = RunKernel((WoaGainDSP::Isa)iIsa, uChannels, uFrames, iMetering != 0, (KernelGain)iGain, uRepetitions);
+                            fBaselineNs = iIsa == WoaGainDSP::Isa_Baseline ? fNs : fBaselineNs;
+                            const char* szIsaName = WoaGainDSP::GetIsaName((WoaGainDSP::Isa)iIsa);
+                            const char* szGain = GetKernelGainName((KernelGain)iGain);
+                            if (bJson)
+                            {
+                                printf("{\"isa\":\"%s\",\"channels\":%u,\"frames\":%u,\"metering\":%s,\"gain\":\"%s\",\"ns_per_sample\":%.4f,\"speedup\":%.2f}\n",
+                                    szIsaName, uChannels, uFrames, iMetering ? "true" : "false", szGain, fNs, fBaselineNs / fNs);
+                            }
+                            else
+                            {
+                                printf("%s,%u,%u,%d,%s,%.4f,%.2f\n", szIsaName, uChannels, uFrames, iMetering, szGain, fNs, fBaselineNs / fNs);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        fflush(stdout);
+        return 0;
+    }
+
+    if (bLevels)
+    {
+        static const AkUInt16 kLevelFrames[] = { 64, 256, 1024 };
+        const AkUInt32 uRepetitions = bQuick ? 3 : 10;
+        if (!bJson)
+            printf("frames,mode,ns_per_sample\n");
+        for (AkUInt16 uFrames : kLevelFrames)
+        {
+            for (AkInt32 iMode = 0; iMode < LevelMode_Count; ++iMode)
+            {
+                const char* szMode = GetLevelModeName((LevelMode)iMode);
+                const AkReal64 fNsPerSample = RunLevelPublish(uFrames, (LevelMode)iMode, uRepetitions);
+                if (bJson)
+                    printf("{\"frames\":%u,\"mode\":\"%s\",\"ns_per_sample\":%.3f}\n", uFrames, szMode, fNsPerSample);
+                else
+                    printf("%u,%s,%.3f\n", uFrames, szMode, fNsPerSample);
+            }
+        }
+
+        static const AkUInt32 kPublishers[] = { 1, 4, 16 };
+        if (!bJson)
+            printf("publishers,ns_per_read\n");
+        for (AkUInt32 uPublishers : kPublishers)
+        {
+            const AkReal64 fNsPerRead = RunLevelRead(uPublishers, uRepetitions);
+            if (bJson)
+                printf("{\"publishers\":%u,\"ns_per_read\":%.1f}\n", uPublishers, fNsPerRead);
+            else
+                printf("%u,%.1f\n", uPublishers, fNsPerRead);
+        }
+        return 0;
+    }
+
+    if (bStats)
+    {
+#ifdef WOAGAIN_ENABLE_STATS
+        static const AkUInt16 kStatsFrames[] = { 64, 256, 1024 };
+        const AkUInt32 uNumBuffers = bQuick ? 1000 : 20000;
+        if (!bJson)
+            printf("frames,metering,automation,calls,min_ns,avg_ns,p99_ns,max_ns,ns_per_frame\n");
+        for (AkUInt16 uFrames : kStatsFrames)
+        {
+            for (int iMetering = 0; iMetering < 2; ++iMetering)
+            {
+                for (int iAutomation = 0; iAutomation < Automation_Count; ++iAutomation)
+                {
+                    Config config;
+                    config.channelConfig = WoaGainHost::GetChannelConfig(2);
+                    config.uFrames = uFrames;
+                    config.bMetering = iMetering != 0;
+                    config.eAutomation = (Automation)iAutomation;
+                    config.bTimeSkip = false;
+                    WoaGainStats::Summary summary;
+                    if (!RunStats(config, uNumBuffers, summary))
+                    {
+                        fprintf(stderr, "Statistics mismatch: %u frames, %s\n", uFrames, GetAutomationName(config.eAutomation));
+                        return 1;
+                    }
+                    PrintStatsResult(bJson, config, summary);
+                }
+            }
+        }
+        return 0;
+#else
+        fprintf(stderr, "Configure with -DWOAGAIN_ENABLE_STATS=ON for --stats\n");
+        return 1;
+#endif
+    }
+
+    if (bAlloc)
+    {
+        static const AkUInt32 kInstances[] = { 1, 16, 256, 1024 };
+        if (!bJson)
+            printf("instances,pooled,ns_per_create,ns_per_term,bytes_per_instance,allocs,frees\n");
+        for (AkUInt32 uInstances : kInstances)
+            PrintAllocResult(bJson, uInstances, RunAlloc(uInstances, bQuick ? 3 : 20));
+        return 0;
+    }
+
+    if (bBatch)
+    {
+        static const AkUInt32 kInstances[] = { 1, 4, 16, 64, 256, 1024 };
+        static const AkUInt16 kBatchFrames[] = { 32, 64, 256 };
+        const AkUInt32 uTargetSamples = bQuick ? (1 << 20) : (1 << 24);
+        const AkUInt32 uRepetitions = bQuick ? 1 : 5;
+        if (!bJson)
+            printf("instances,frames,mode,ns_per_buffer,frames_per_sec\n");
+        for (AkUInt16 uFrames : kBatchFrames)
+        {
+            for (AkUInt32 uInstances : kInstances)
+            {
+                for (int iBatch = 0; iBatch < 2; ++iBatch)
+                    PrintBatchResult(bJson, uInstances, uFrames, iBatch != 0, RunBatch(uInstances, uFrames, iBatch != 0, uTargetSamples, uRepetitions));
+            }
+        }
+        return 0;
+    }
+
+    static const AkUInt32 kChannels[] = { 1, 2, 6, 8, 12, 16 };
+    static const AkUInt16 kFrames[] = { 64, 256, 1024, 4096, 8192 };
+    const AkUInt32 uTargetSamples = bQuick ? (1 << 18) : (1 << 22);
+    const AkUInt32 uRepetitions = bQuick ? 1 : 3;
+
+    std::vector<BaselineEntry> baseline;
+    if (szBaseline && !LoadBaseline(szBaseline, baseline))
+    {
+        fprintf(stderr, "%s: cannot read a CSV output of WoaGainBench\n", szBaseline);
+        return 1;
+    }
+    std::vector<AkReal64> baselineRatios;
+
+    // Configurations slower than their baseline, timed again at the end of the run
+    struct Suspect
+    {
+        Config config;
+        const BaselineEntry* pBaseline;
+        Result result;
+    };
+    std::vector<Suspect> suspects;
+
+    PrintHeader(bJson);
+    for (AkUInt32 uChannels : kChannels)
+    {
+        for (AkUInt16 uFrames : kFrames)
+        {
+            for (int iMetering = 0; iMetering < 2; ++iMetering)
+            {
+                for (int iAutomation = 0; iAutomation < Automation_Count; ++iAutomation)
+                {
+                    Config config;
+                    config.channelConfig = WoaGainHost::GetChannelConfig(uChannels);
+                    config.uFrames = uFrames;
+                    config.bMetering = iMetering != 0;
+                    config.eAutomation = (Automation)iAutomation;
+                    config.bTimeSkip = bTimeSkip;
+                    const Result result = Run(config, uTargetSamples, uRepetitions);
+                    PrintResult(bJson, config, result);
+
+                    const BaselineEntry* pBaseline = FindBaseline(baseline, config);
+                    if (pBaseline)
+                    {
+                        baselineRatios.push_back(result.fNsPerFrame / pBaseline->fNsPerFrame);
+                        if (result.fNsPerFrame > pBaseline->fNsPerFrame * (1. + fTolerance * 0.01))
+                            suspects.push_back({ config, pBaseline, result });
+                    }
+                }
+            }
+        }
+    }
+
+    // Activity on the machine comes in bursts of a few seconds, which would slow down consecutive
+    // configurations: suspects are only reported when still slower once timed again after the run
+    AkUInt32 uNumRegressions = 0;
+    for (Suspect& suspect : suspects)
+    {
+        const AkReal64 fMaxNsPerFrame = suspect.pBaseline->fNsPerFrame * (1. + fTolerance * 0.01);
+        for (AkUInt32 uRetry = 0; uRetry < kBaselineRetries && suspect.result.fNsPerFrame > fMaxNsPerFrame; ++uRetry)
+        {
+            const Result retry = Run(suspect.config, uTargetSamples, uRepetitions);
+            if (retry.fNsPerFrame < suspect.result.fNsPerFrame)
+                suspect.result = retry;
+        }
+        if (suspect.result.fNsPerFrame > fMaxNsPerFrame)
+        {
+            fprintf(stderr, "Regression: %s, %u frames, metering %d, %s: %.4f ns/frame, baseline %.4f (%+.0f%%)\n",
+                suspect.pBaseline->szLayout, suspect.config.uFrames, suspect.config.bMetering ? 1 : 0, suspect.pBaseline->szAutomation,
+                suspect.result.fNsPerFrame, suspect.pBaseline->fNsPerFrame, (suspect.result.fNsPerFrame / suspect.pBaseline->fNsPerFrame - 1.) * 100.);
+            ++uNumRegressions;
+        }
+    }
+
+    // A median far from 1 means that the whole machine ran faster or slower than for the baseline,
+    // or that a change slowed down most configurations by less than the per-configuration tolerance
+    bool bMedianRegression = false;
+    if (szBaseline)
+    {
+        std::sort(baselineRatios.begin(), baselineRatios.end());
+        const AkReal64 fMedian = baselineRatios.empty() ? 0. : baselineRatios[baselineRatios.size() / 2];
+        fprintf(stderr, "compared=%u median_ratio=%.3f suspects=%u regressions=%u\n",
+            (AkUInt32)baselineRatios.size(), fMedian, (AkUInt32)suspects.size(), uNumRegressions);
+        if (baselineRatios.empty())
+        {
+            fprintf(stderr, "No configuration of the run found in %s\n", szBaseline);
+            return 1;
+        }
+        if (fMedian > 1. + fMedianTolerance * 0.01)
+        {
+            fprintf(stderr, "Median ratio to the baseline more than %.0f%% above 1\n", fMedianTolerance);
+            bMedianRegression = true;
+        }
+    }
+    if (uNumRegressions > 0)
+        fprintf(stderr, "%u configurations more than %.0f%% slower than the baseline\n", uNumRegressions, fTolerance);
+    return (uNumRegressions > 0 || bMedianRegression) ? 1 : 0;
+}
@@ -0,0 +1,434 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// WoaGainMonitorBench: measures the authoring-side aggregation of monitor data
+// (WoaGainMonitorAggregator) for many WoaGainFX instances.
+//
+// Every configuration (payload version x channel count x instance count) aggregates the same set
+// of payloads, with levels spread over 60 dB, and is reported as one machine-readable line on
+// stdout, as CSV (default) or JSON lines (--json). Times are the best of several repetitions.
+// Before timing, the aggregated levels are checked against a direct computation, and the run
+// fails on mismatch.
+//
+// --payload compares instead the size of the payloads with the precision of their levels: for
+// each channel count, the bytes posted per instance as version 1, as version 2 and as version 2
+// would be with AkReal32 levels, the largest error of the quantized levels over the whole range,
+// and the time taken to encode (from the meters, as WoaGainFX does) and decode each channel.
+//
+// Usage: WoaGainMonitorBench [--json] [--quick] [--payload]
+
+#include "../../WwisePlugin/WoaGainMonitorAggregator.h"
+#include "../../WoaGainMonitorData.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    struct Payloads
+    {
+        AkUInt32 uSize;
+        std::vector<AkUInt8> data;  ///< Payloads of all instances, uSize bytes apart
+    };
+
+    AkUInt32 Xorshift(AkUInt32& io_uState)
+    {
+        io_uState ^= io_uState << 13; io_uState ^= io_uState >> 17; io_uState ^= io_uState << 5;
+        return io_uState;
+    }
+
+    // Uniform in [in_fMin, in_fMax)
+    AkReal32 Random(AkUInt32& io_uState, AkReal32 in_fMin, AkReal32 in_fMax)
+    {
+        return in_fMin + (in_fMax - in_fMin) * (AkReal32)(Xorshift(io_uState) >> 8) / (AkReal32)(1 << 24);
+    }
+
+    // Payloads of the given version (legacy for in_uVersion = 0) with deterministic levels
+    void MakePayloads(AkUInt32 in_uVersion, AkUInt32 in_uNumInstances, AkUInt32 in_uNumChannels, Payloads& out_payloads)
+    {
+        if (in_uVersion == WoaGainMonitorData::Version)
+            out_payloads.uSize = WoaGainMonitorData::GetSize(in_uNumChannels);
+        else if (in_uVersion == WoaGainMonitorData::VersionV1)
+            out_payloads.uSize = WoaGainMonitorData::GetSizeV1(in_uNumChannels);
+        else
+            out_payloads.uSize = WoaGainMonitorData::LegacySize;
+        out_payloads.data.assign((size_t)out_payloads.uSize * in_uNumInstances, 0);
+
+        AkUInt32 uState = 0x9E3779B9u;
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            AkUInt8* pPayload = &out_payloads.data[(size_t)i * out_payloads.uSize];
+            const AkReal32 fRmsAfter = Random(uState, -60.f, 0.f);
+            const AkReal32 fRmsBefore = fRmsAfter + 6.f;
+
+            if (in_uVersion == WoaGainMonitorData::Version)
+            {
+                WoaGainMonitorData::Header header;
+                header.uVersion = WoaGainMonitorData::Version;
+                header.uFlags = 0;
+                header.uNumChannels = (AkUInt16)in_uNumChannels;
+                header.iRmsBefore = WoaGainMonitorData::QuantizeDb(fRmsBefore);
+                header.iRmsAfter = WoaGainMonitorData::QuantizeDb(fRmsAfter);
+                memcpy(pPayload, &header, sizeof(header));
+                for (AkUInt32 c = 0; c < in_uNumChannels; ++c)
+                {
+                    WoaGainMonitorData::ChannelLevels levels;
+                    levels.iRmsBefore = WoaGainMonitorData::QuantizeDb(fRmsBefore - 0.1f * (AkReal32)c);
+                    levels.iRmsAfter = WoaGainMonitorData::QuantizeDb(fRmsAfter - 0.1f * (AkReal32)c);
+                    levels.iPeakBefore = WoaGainMonitorData::QuantizeDb(fRmsBefore + 3.f + 0.1f * (AkReal32)c);
+                    levels.iPeakAfter = WoaGainMonitorData::QuantizeDb(fRmsAfter + 3.f + 0.1f * (AkReal32)c);
+                    memcpy(pPayload + sizeof(header) + c * sizeof(levels), &levels, sizeof(levels));
+                }
+                continue;
+            }
+
+            if (in_uVersion != WoaGainMonitorData::VersionV1)
+            {
+                AkReal32 rms[2] = { fRmsBefore, fRmsAfter };
+                memcpy(pPayload, rms, sizeof(rms));
+                continue;
+            }
+
+            WoaGainMonitorData::HeaderV1 header;
+            header.uVersion = WoaGainMonitorData::VersionV1;
+            header.uFlags = 0;
+            header.uNumChannels = (AkUInt16)in_uNumChannels;
+            header.fRmsBefore = fRmsBefore;
+            header.fRmsAfter = fRmsAfter;
+            memcpy(pPayload, &header, sizeof(header));
+            for (AkUInt32 c = 0; c < in_uNumChannels; ++c)
+            {
+                const AkReal32 fPeak = fRmsAfter + 3.f + 0.1f * (AkReal32)c;
+                memcpy(pPayload + sizeof(header) + c * sizeof(AkReal32), &fPeak, sizeof(fPeak));
+            }
+        }
+    }
+
+    const WoaGainMonitorAggregator::Levels& Aggregate(WoaGainMonitorAggregator& io_aggregator, const Payloads& in_payloads, AkUInt32 in_uNumInstances)
+    {
+        io_aggregator.Begin();
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+            io_aggregator.Add(i + 1, &in_payloads.data[(size_t)i * in_payloads.uSize], in_payloads.uSize);
+        return io_aggregator.End();
+    }
+
+    bool Near(AkReal32 in_fA, AkReal32 in_fB)
+    {
+        return fabsf(in_fA - in_fB) <= 1e-3f;
+    }
+
+    // Compares the aggregated levels with a direct computation over the decoded payloads
+    bool Check(const WoaGainMonitorAggregator::Levels& in_levels, const Payloads& in_payloads, AkUInt32 in_uNumInstances)
+    {
+        std::vector<WoaGainMonitorAggregator::Instance> instances(in_uNumInstances);
+        AkReal64 fPowerAfter = 0.;
+        AkReal32 fMaxRmsAfter = -INFINITY;
+        AkReal32 fMaxPeak = -INFINITY;
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            if (!WoaGainMonitorAggregator::Decode(&in_payloads.data[(size_t)i * in_payloads.uSize], in_payloads.uSize, instances[i]))
+                return false;
+            fPowerAfter += pow(10., instances[i].fRmsAfter * 0.1);
+            fMaxRmsAfter = instances[i].fRmsAfter > fMaxRmsAfter ? instances[i].fRmsAfter : fMaxRmsAfter;
+            fMaxPeak = instances[i].fPeak > fMaxPeak ? instances[i].fPeak : fMaxPeak;
+        }
+
+        if (in_levels.uNumInstances != in_uNumInstances ||
+            !Near(in_levels.fMaxRmsAfter, fMaxRmsAfter) ||
+            !Near(in_levels.fMaxPeak, fMaxPeak) ||
+            !Near(in_levels.fSumRmsAfter, (AkReal32)(10. * log10(fPowerAfter)))
+        ) {
+            return false;
+        }
+
+        // The top entries must be the loudest instances, in decreasing order. Quantized levels
+        // can tie, so an entry only needs to be at a position its level can take.
+        const AkUInt32 uExpectedTop = in_uNumInstances < WoaGainMonitorAggregator::MaxTopInstances ? in_uNumInstances : WoaGainMonitorAggregator::MaxTopInstances;
+        if (in_levels.uNumTop != uExpectedTop)
+            return false;
+        for (AkUInt32 i = 0; i < in_levels.uNumTop; ++i)
+        {
+            AkUInt32 uLouder = 0;
+            AkUInt32 uAsLoud = 0;
+            for (const WoaGainMonitorAggregator::Instance& instance : instances)
+            {
+                uLouder += instance.fRmsAfter > in_levels.top[i].fRmsAfter ? 1 : 0;
+                uAsLoud += instance.fRmsAfter == in_levels.top[i].fRmsAfter ? 1 : 0;
+            }
+            if (uLouder > i || uLouder + uAsLoud <= i)
+                return false;
+        }
+        return true;
+    }
+
+    // Levels accumulated by WoaGainFX for one channel, see WoaGainDSP::ChannelMeter
+    struct Meters
+    {
+        AkReal32 fSumSqBefore;
+        AkReal32 fSumSqAfter;
+        AkReal32 fPeakBefore;
+        AkReal32 fPeakAfter;
+    };
+
+    // Encodes a version 2 payload from the meters of in_uNumChannels channels, as WoaGainFX::PostMonitorData
+    void Encode(const Meters* in_pMeters, AkUInt32 in_uNumChannels, AkUInt32 in_uFrames, AkUInt8* out_pPayload)
+    {
+        const AkReal32 fInvFrames = 1.f / (AkReal32)in_uFrames;
+        WoaGainMonitorData::ChannelLevels* pChannels = (WoaGainMonitorData::ChannelLevels*)(out_pPayload + sizeof(WoaGainMonitorData::Header));
+        AkReal32 fSumSqBefore = 0.f;
+        AkReal32 fSumSqAfter = 0.f;
+        for (AkUInt32 i = 0; i < in_uNumChannels; ++i)
+        {
+            fSumSqBefore += in_pMeters[i].fSumSqBefore;
+            fSumSqAfter += in_pMeters[i].fSumSqAfter;
+            pChannels[i].iRmsBefore = WoaGainMonitorData::QuantizePower(in_pMeters[i].fSumSqBefore * fInvFrames);
+            pChannels[i].iRmsAfter = WoaGainMonitorData::QuantizePower(in_pMeters[i].fSumSqAfter * fInvFrames);
+            pChannels[i].iPeakBefore = WoaGainMonitorData::QuantizeAmplitude(in_pMeters[i].fPeakBefore);
+            pChannels[i].iPeakAfter = WoaGainMonitorData::QuantizeAmplitude(in_pMeters[i].fPeakAfter);
+        }
+
+        WoaGainMonitorData::Header header;
+        header.uVersion = WoaGainMonitorData::Version;
+        header.uFlags = 0;
+        header.uNumChannels = (AkUInt16)in_uNumChannels;
+        header.iRmsBefore = WoaGainMonitorData::QuantizePower(fSumSqBefore * fInvFrames / (AkReal32)in_uNumChannels);
+        header.iRmsAfter = WoaGainMonitorData::QuantizePower(fSumSqAfter * fInvFrames / (AkReal32)in_uNumChannels);
+        memcpy(out_pPayload, &header, sizeof(header));
+    }
+
+    AkReal64 GetError(AkReal32 in_fDecoded, AkReal64 in_fExpected)
+    {
+        return fabs((AkReal64)in_fDecoded - in_fExpected);
+    }
+
+    // Size versus precision of the payload formats, see --payload
+    bool RunPayload(bool in_bJson, bool in_bQuick)
+    {
+        static const AkUInt32 kChannels[] = { 1, 2, 6, 12, 16, 64, WoaGainMonitorData::MaxChannels };
+        static const AkUInt32 kFrames = 4800;   // 100 ms at 48 kHz
+        const AkUInt32 uTargetChannels = in_bQuick ? (1 << 16) : (1 << 20);
+        const AkUInt32 uRepetitions = in_bQuick ? 1 : 3;
+
+        if (!in_bJson)
+            printf("channels,v1_bytes,v2_bytes,v2_float_bytes,max_error_db,encode_ns_per_channel,decode_ns_per_channel\n");
+
+        AkUInt32 uState = 0x2545F491u;
+        for (AkUInt32 uChannels : kChannels)
+        {
+            // Levels over the whole quantized range, without silence, which is exact
+            const AkUInt32 uNumPayloads = uTargetChannels / uChannels;
+            const AkUInt32 uSize = WoaGainMonitorData::GetSize(uChannels);
+            std::vector<Meters> meters((size_t)uNumPayloads * uChannels);
+            for (Meters& meter : meters)
+            {
+                meter.fSumSqBefore = kFrames * powf(10.f, Random(uState, -120.f, 120.f) * 0.1f);
+                meter.fSumSqAfter = kFrames * powf(10.f, Random(uState, -120.f, 120.f) * 0.1f);
+                meter.fPeakBefore = powf(10.f, Random(uState, -120.f, 120.f) * 0.05f);
+                meter.fPeakAfter = powf(10.f, Random(uState, -120.f, 120.f) * 0.05f);
+            }
+            std::vector<AkUInt8> payloads((size_t)uNumPayloads * uSize);
+            std::vector<WoaGainMonitorAggregator::Channel> channels(uChannels);
+
+            AkReal64 fBestEncode = 0.;
+            AkReal64 fBestDecode = 0.;
+            AkReal32 fSink = 0.f;
+            for (AkUInt32 uRep = 0; uRep < uRepetitions; ++uRep)
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < uNumPayloads; ++i)
+                    Encode(&meters[(size_t)i * uChannels], uChannels, kFrames, &payloads[(size_t)i * uSize]);
+                const AkReal64 fEncode = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+
+                start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < uNumPayloads; ++i)
+                {
+                    WoaGainMonitorAggregator::DecodeChannels(&payloads[(size_t)i * uSize], uSize, channels.data(), uChannels);
+                    fSink += channels[i % uChannels].fPeakAfter;
+                }
+                const AkReal64 fDecode = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+
+                fBestEncode = uRep == 0 || fEncode < fBestEncode ? fEncode : fBestEncode;
+                fBestDecode = uRep == 0 || fDecode < fBestDecode ? fDecode : fBestDecode;
+            }
+
+            // Compares every decoded level with the level of the meters computed in double precision
+            AkReal64 fMaxError = 0.;
+            for (AkUInt32 i = 0; i < uNumPayloads; ++i)
+            {
+                const AkUInt8* pPayload = &payloads[(size_t)i * uSize];
+                if (WoaGainMonitorAggregator::DecodeChannels(pPayload, uSize, channels.data(), uChannels) != uChannels)
+                {
+                    fprintf(stderr, "Payload decoding failed: %u channels\n", uChannels);
+                    return false;
+                }
+
+                AkReal64 fSumSqBefore = 0.;
+                AkReal64 fSumSqAfter = 0.;
+                for (AkUInt32 c = 0; c < uChannels; ++c)
+                {
+                    const Meters& meter = meters[(size_t)i * uChannels + c];
+                    const WoaGainMonitorAggregator::Channel& channel = channels[c];
+                    fSumSqBefore += meter.fSumSqBefore;
+                    fSumSqAfter += meter.fSumSqAfter;
+                    AkReal64 fError = GetError(channel.fRmsBefore, 10. * log10((AkReal64)meter.fSumSqBefore / kFrames));
+                    fError = fmax(fError, GetError(channel.fRmsAfter, 10. * log10((AkReal64)meter.fSumSqAfter / kFrames)));
+                    fError = fmax(fError, GetError(channel.fPeakBefore, 20. * log10((AkReal64)meter.fPeakBefore)));
+                    fError = fmax(fError, GetError(channel.fPeakAfter, 20. * log10((AkReal64)meter.fPeakAfter)));
+                    fMaxError = fmax(fMaxError, fError);
+                }
+
+                WoaGainMonitorAggregator::Instance instance;
+                if (!WoaGainMonitorAggregator::Decode(pPayload, uSize, instance))
+                {
+                    fprintf(stderr, "Payload decoding failed: %u channels\n", uChannels);
+                    return false;
+                }
+                fMaxError = fmax(fMaxError, GetError(instance.fRmsBefore, 10. * log10(fSumSqBefore / ((AkReal64)kFrames * uChannels))));
+                fMaxError = fmax(fMaxError, GetError(instance.fRmsAfter, 10. * log10(fSumSqAfter / ((AkReal64)kFrames * uChannels))));
+            }
+
+            // Half a step, plus the rounding of log10f
+            if (!(fMaxError <= 0.5 / WoaGainMonitorData::QuantizedDbSteps + 1e-4))
+            {
+                fprintf(stderr, "Quantization error too large: %u channels, %f dB\n", uChannels, fMaxError);
+                return false;
+            }
+
+            const AkUInt32 uV1Bytes = WoaGainMonitorData::GetSizeV1(uChannels);
+            const AkUInt32 uFloatBytes = (AkUInt32)(sizeof(WoaGainMonitorData::HeaderV1) + 4 * sizeof(AkReal32) * uChannels);
+            const AkReal64 fEncodeNs = fBestEncode * 1e9 / ((AkReal64)uNumPayloads * uChannels);
+            const AkReal64 fDecodeNs = fBestDecode * 1e9 / ((AkReal64)uNumPayloads * uChannels);
+            if (in_bJson)
+            {
+                printf("{\"channels\":%u,\"v1_bytes\":%u,\"v2_bytes\":%u,\"v2_float_bytes\":%u,\"max_error_db\":%.5f,\"encode_ns_per_channel\":%.2f,\"decode_ns_per_channel\":%.2f}\n",
+                    uChannels, uV1Bytes, uSize, uFloatBytes, fMaxError, fEncodeNs, fDecodeNs);
+            }
+            else
+            {
+                printf("%u,%u,%u,%u,%.5f,%.2f,%.2f\n", uChannels, uV1Bytes, uSize, uFloatBytes, fMaxError, fEncodeNs, fDecodeNs);
+            }
+            fflush(stdout);
+
+            // Keeps the decoding from being optimized away
+            if (fSink == 1.f)
+                fprintf(stderr, " ");
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool bJson = false;
+    bool bQuick = false;
+    bool bPayload = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            bJson = true;
+        else if (strcmp(argv[i], "--quick") == 0)
+            bQuick = true;
+        else if (strcmp(argv[i], "--payload") == 0)
+            bPayload = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--json] [--quick] [--payload]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (bPayload)
+        return RunPayload(bJson, bQuick) ? 0 : 1;
+
+    // Version 0 stands for legacy payloads, which have no channels
+    struct Format
+    {
+        AkUInt32 uVersion;
+        AkUInt32 uChannels;
+    };
+    static const Format kFormats[] = {
+        { 0, 0 },
+        { WoaGainMonitorData::VersionV1, 2 }, { WoaGainMonitorData::VersionV1, 6 }, { WoaGainMonitorData::VersionV1, 12 },
+        { WoaGainMonitorData::Version, 2 }, { WoaGainMonitorData::Version, 6 }, { WoaGainMonitorData::Version, 12 }
+    };
+    static const AkUInt32 kInstances[] = { 1, 16, 256, 1024, 4096 };
+    const AkUInt32 uTargetInstances = bQuick ? (1 << 18) : (1 << 22);
+    const AkUInt32 uRepetitions = bQuick ? 1 : 3;
+
+    if (!bJson)
+        printf("version,instances,channels,ns_per_update,ns_per_instance\n");
+
+    WoaGainMonitorAggregator aggregator;
+    for (const Format& format : kFormats)
+    {
+        const AkUInt32 uVersion = format.uVersion;
+        const AkUInt32 uChannels = format.uChannels;
+        for (AkUInt32 uInstances : kInstances)
+        {
+            Payloads payloads;
+            MakePayloads(uVersion, uInstances, uChannels, payloads);
+            if (!Check(Aggregate(aggregator, payloads, uInstances), payloads, uInstances))
+            {
+                fprintf(stderr, "Aggregated levels mismatch: version %u, %u instances, %u channels\n", uVersion, uInstances, uChannels);
+                return 1;
+            }
+
+            const AkUInt32 uUpdates = uTargetInstances / uInstances > 0 ? uTargetInstances / uInstances : 1;
+            AkReal64 fBestSeconds = 0.;
+            AkReal32 fSink = 0.f;
+            for (AkUInt32 uRep = 0; uRep < uRepetitions; ++uRep)
+            {
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (AkUInt32 i = 0; i < uUpdates; ++i)
+                    fSink += Aggregate(aggregator, payloads, uInstances).fSumRmsAfter;
+                const AkReal64 fSeconds = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+                if (uRep == 0 || fSeconds < fBestSeconds)
+                    fBestSeconds = fSeconds;
+            }
+
+            const AkReal64 fNsPerUpdate = fBestSeconds * 1e9 / uUpdates;
+            if (bJson)
+            {
+                printf("{\"version\":%u,\"instances\":%u,\"channels\":%u,\"ns_per_update\":%.1f,\"ns_per_instance\":%.3f}\n",
+                    uVersion, uInstances, uChannels, fNsPerUpdate, fNsPerUpdate / uInstances);
+            }
+            else
+            {
+                printf("%u,%u,%u,%.1f,%.3f\n", uVersion, uInstances, uChannels, fNsPerUpdate, fNsPerUpdate / uInstances);
+            }
+            fflush(stdout);
+
+            // Keeps the aggregation from being optimized away
+            if (fSink == 1.f)
+                fprintf(stderr, " ");
+        }
+    }
+
+    return 0;
+}
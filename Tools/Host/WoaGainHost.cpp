@@ -0,0 +1,371 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainHost.h"
+
+#include <AK/Tools/Common/AkAssert.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+AK::IAkPlugin* CreateWoaGainFX(AK::IAkPluginMemAlloc* in_pAllocator);
+AK::IAkPluginParam* CreateWoaGainFXParams(AK::IAkPluginMemAlloc* in_pAllocator);
+
+namespace
+{
+    // Stored right before every block returned by the allocator
+    struct AllocHeader
+    {
+        void* pBase;
+        size_t uSize;
+    };
+
+    void* AlignedAlloc(size_t in_uSize, size_t in_uAlignment)
+    {
+        if (in_uAlignment < AK_SIMD_ALIGNMENT)
+            in_uAlignment = AK_SIMD_ALIGNMENT;
+
+        void* pBase = malloc(in_uSize + in_uAlignment + sizeof(AllocHeader));
+        if (!pBase)
+            return nullptr;
+
+        AkUIntPtr uAddress = (AkUIntPtr)pBase + sizeof(AllocHeader);
+        uAddress = (uAddress + in_uAlignment - 1) & ~(AkUIntPtr)(in_uAlignment - 1);
+
+        AllocHeader* pHeader = (AllocHeader*)uAddress - 1;
+        pHeader->pBase = pBase;
+        pHeader->uSize = in_uSize;
+        return (void*)uAddress;
+    }
+
+    const AllocHeader* GetHeader(void* in_pMemAddress)
+    {
+        return (const AllocHeader*)in_pMemAddress - 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Allocator
+
+WoaGainHost::Allocator::Allocator()
+    : uNumAllocs(0)
+    , uNumFrees(0)
+    , uBytesInUse(0)
+    , uPeakBytesInUse(0)
+{
+}
+
+WoaGainHost::Allocator::~Allocator()
+{
+    // The sound engine terminates before its allocator: pools keep their slabs until then, and
+    // must hand them back while this allocator, which may have provided some, still exists
+    GlobalContext::Get().Term();
+#ifdef WOAGAIN_POOLED_ALLOC
+    AKASSERT(uBytesInUse == 0);
+#endif
+}
+
+void* WoaGainHost::Allocator::Malloc(size_t in_uSize, const char* in_pszFile, AkUInt32 in_uLine)
+{
+    return Malign(in_uSize, AK_SIMD_ALIGNMENT, in_pszFile, in_uLine);
+}
+
+void WoaGainHost::Allocator::Free(void* in_pMemAddress)
+{
+    if (!in_pMemAddress)
+        return;
+
+    const AllocHeader* pHeader = GetHeader(in_pMemAddress);
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ++uNumFrees;
+        uBytesInUse -= pHeader->uSize;
+    }
+    free(pHeader->pBase);
+}
+
+void* WoaGainHost::Allocator::Malign(size_t in_uSize, size_t in_uAlignment, const char* /*in_pszFile*/, AkUInt32 /*in_uLine*/)
+{
+    void* pMem = AlignedAlloc(in_uSize, in_uAlignment);
+    if (pMem)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ++uNumAllocs;
+        uBytesInUse += in_uSize;
+        if (uBytesInUse > uPeakBytesInUse)
+            uPeakBytesInUse = uBytesInUse;
+    }
+    return pMem;
+}
+
+//-----------------------------------------------------------------------------
+// GlobalContext
+
+WoaGainHost::GlobalContext& WoaGainHost::GlobalContext::Get()
+{
+    static GlobalContext s_context;
+    return s_context;
+}
+
+AKRESULT WoaGainHost::GlobalContext::RegisterGlobalCallback(AkPluginType /*in_eType*/, AkUInt32 /*in_ulCompanyID*/, AkUInt32 /*in_ulPluginID*/,
+    AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation, void* in_pCookie)
+{
+    if (!in_pCallback)
+        return AK_InvalidParameter;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    Callback callback;
+    callback.pCallback = in_pCallback;
+    callback.uLocations = in_eLocation;
+    callback.pCookie = in_pCookie;
+    m_callbacks.push_back(callback);
+    return AK_Success;
+}
+
+AKRESULT WoaGainHost::GlobalContext::UnregisterGlobalCallback(AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (size_t i = 0; i < m_callbacks.size(); ++i)
+    {
+        if (m_callbacks[i].pCallback == in_pCallback && m_callbacks[i].uLocations == in_eLocation)
+        {
+            m_callbacks.erase(m_callbacks.begin() + i);
+            return AK_Success;
+        }
+    }
+    return AK_Fail;
+}
+
+void WoaGainHost::GlobalContext::Term()
+{
+    // Called without the lock: callbacks may unregister themselves
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        callbacks = m_callbacks;
+    }
+    for (const Callback& callback : callbacks)
+    {
+        if (callback.uLocations & AkGlobalCallbackLocation_Term)
+            callback.pCallback(this, AkGlobalCallbackLocation_Term, callback.pCookie);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// EffectContext
+
+WoaGainHost::EffectContext::EffectContext()
+    : bCanPostMonitorData(false)
+    , uNodeID(AK_INVALID_UNIQUE_ID)
+    , uNumMonitorPosts(0)
+    , uMonitorDataSize(0)
+{
+}
+
+AK::IAkGlobalPluginContext* WoaGainHost::EffectContext::GlobalContext() const
+{
+    return &GlobalContext::Get();
+}
+
+AKRESULT WoaGainHost::EffectContext::PostMonitorData(void* in_pData, AkUInt32 in_uDataSize)
+{
+    if (in_uDataSize > MaxMonitorDataSize)
+        return AK_InvalidParameter;
+
+    memcpy(monitorData, in_pData, in_uDataSize);
+    uMonitorDataSize = in_uDataSize;
+    ++uNumMonitorPosts;
+    return AK_Success;
+}
+
+bool WoaGainHost::EffectContext::CanPostMonitorData()
+{
+    return bCanPostMonitorData;
+}
+
+bool WoaGainHost::EffectContext::IsSendModeEffect() const
+{
+    return false;
+}
+
+AkUniqueID WoaGainHost::EffectContext::GetNodeID() const
+{
+    return uNodeID;
+}
+
+//-----------------------------------------------------------------------------
+// Buffer
+
+WoaGainHost::Buffer::Buffer()
+    : m_pData(nullptr)
+    , m_uNumSamples(0)
+{
+}
+
+WoaGainHost::Buffer::~Buffer()
+{
+    Release();
+}
+
+bool WoaGainHost::Buffer::Allocate(AkChannelConfig in_channelConfig, AkUInt16 in_uMaxFrames)
+{
+    Release();
+
+    m_uNumSamples = in_channelConfig.uNumChannels * in_uMaxFrames;
+    m_pData = (AkReal32*)AlignedAlloc(m_uNumSamples * sizeof(AkReal32), AK_SIMD_ALIGNMENT);
+    if (!m_pData)
+        return false;
+
+    memset(m_pData, 0, m_uNumSamples * sizeof(AkReal32));
+    m_buffer.AttachContiguousDeinterleavedData(m_pData, in_uMaxFrames, in_uMaxFrames, in_channelConfig);
+    return true;
+}
+
+void WoaGainHost::Buffer::Release()
+{
+    if (m_pData)
+        free(GetHeader(m_pData)->pBase);
+    m_pData = nullptr;
+    m_uNumSamples = 0;
+    m_buffer.Clear();
+}
+
+void WoaGainHost::Buffer::FillNoise(AkUInt32 in_uSeed, AkReal32 in_fAmplitude)
+{
+    // xorshift32, mapped to [-in_fAmplitude, in_fAmplitude]
+    AkUInt32 uState = in_uSeed ? in_uSeed : 0x9E3779B9;
+    for (AkUInt32 i = 0; i < m_uNumSamples; ++i)
+    {
+        uState ^= uState << 13;
+        uState ^= uState >> 17;
+        uState ^= uState << 5;
+        m_pData[i] = in_fAmplitude * ((AkReal32)(uState >> 8) * (2.f / 16777216.f) - 1.f);
+    }
+}
+
+void WoaGainHost::Buffer::CopyFrom(const Buffer& in_other)
+{
+    AKASSERT(in_other.m_uNumSamples == m_uNumSamples);
+    memcpy(m_pData, in_other.m_pData, m_uNumSamples * sizeof(AkReal32));
+    m_buffer.uValidFrames = in_other.m_buffer.uValidFrames;
+}
+
+//-----------------------------------------------------------------------------
+// Instance
+
+WoaGainHost::Instance::Instance()
+    : m_pAllocator(nullptr)
+    , m_pEffect(nullptr)
+    , m_pParams(nullptr)
+{
+}
+
+WoaGainHost::Instance::~Instance()
+{
+    Term();
+}
+
+AKRESULT WoaGainHost::Instance::Init(Allocator& in_allocator, EffectContext& in_context, AkAudioFormat& in_format, const void* in_pParamsBlock, AkUInt32 in_uBlockSize)
+{
+    Term();
+    m_pAllocator = &in_allocator;
+
+    m_pParams = CreateWoaGainFXParams(m_pAllocator);
+    if (!m_pParams)
+        return AK_InsufficientMemory;
+
+    AKRESULT eResult = m_pParams->Init(m_pAllocator, in_pParamsBlock, in_uBlockSize);
+    if (eResult != AK_Success)
+        return eResult;
+
+    m_pEffect = (AK::IAkInPlaceEffectPlugin*)CreateWoaGainFX(m_pAllocator);
+    if (!m_pEffect)
+        return AK_InsufficientMemory;
+
+    return m_pEffect->Init(m_pAllocator, &in_context, m_pParams, in_format);
+}
+
+void WoaGainHost::Instance::Term()
+{
+    if (m_pEffect)
+        m_pEffect->Term(m_pAllocator);
+    if (m_pParams)
+        m_pParams->Term(m_pAllocator);
+    m_pEffect = nullptr;
+    m_pParams = nullptr;
+}
+
+AKRESULT WoaGainHost::Instance::SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 in_uParamSize)
+{
+    return m_pParams->SetParam(in_paramID, in_pValue, in_uParamSize);
+}
+
+//-----------------------------------------------------------------------------
+// Formats
+
+AkChannelConfig WoaGainHost::GetChannelConfig(AkUInt32 in_uNumChannels)
+{
+    AkChannelConfig channelConfig;
+    switch (in_uNumChannels)
+    {
+    case 1: channelConfig.SetStandard(AK_SPEAKER_SETUP_MONO); break;
+    case 2: channelConfig.SetStandard(AK_SPEAKER_SETUP_STEREO); break;
+    case 6: channelConfig.SetStandard(AK_SPEAKER_SETUP_5POINT1); break;
+    case 8: channelConfig.SetStandard(AK_SPEAKER_SETUP_7POINT1); break;
+    case 12: channelConfig.SetStandard(AK_SPEAKER_SETUP_DOLBY_7_1_4); break;
+    default: channelConfig.SetAnonymous(in_uNumChannels); break;
+    }
+    return channelConfig;
+}
+
+const char* WoaGainHost::GetChannelConfigName(AkChannelConfig in_channelConfig)
+{
+    if (in_channelConfig.eConfigType == AK_ChannelConfigType_Standard)
+    {
+        switch (in_channelConfig.uChannelMask)
+        {
+        case AK_SPEAKER_SETUP_MONO: return "mono";
+        case AK_SPEAKER_SETUP_STEREO: return "stereo";
+        case AK_SPEAKER_SETUP_5POINT1: return "5.1";
+        case AK_SPEAKER_SETUP_7POINT1: return "7.1";
+        case AK_SPEAKER_SETUP_DOLBY_7_1_4: return "7.1.4";
+        default: break;
+        }
+    }
+    return "anonymous";
+}
+
+AkAudioFormat WoaGainHost::GetAudioFormat(AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate)
+{
+    AkAudioFormat format;
+    format.uSampleRate = in_uSampleRate;
+    format.channelConfig = in_channelConfig;
+    format.uBitsPerSample = 32;
+    format.uBlockAlign = sizeof(AkReal32) * in_channelConfig.uNumChannels;
+    format.uTypeID = 1;
+    format.uInterleaveID = 1;
+    return format;
+}
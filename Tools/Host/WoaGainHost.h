@@ -0,0 +1,188 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainHost_H
+#define WoaGainHost_H
+
+#include <AK/SoundEngine/Common/IAkPlugin.h>
+
+#include <mutex>
+#include <vector>
+
+/// Minimal sound engine stand-ins used to drive WoaGainFX outside of the Wwise runtime,
+/// e.g. from the Linux benchmark host. They only implement what the plug-in uses.
+namespace WoaGainHost
+{
+    /// Plug-in allocator backed by the C runtime, with allocation statistics.
+    /// Allocations are aligned on AK_SIMD_ALIGNMENT like the sound engine's, and thread-safe like
+    /// them: parameter nodes allocate from the threads setting parameters.
+    class Allocator
+        : public AK::IAkPluginMemAlloc
+    {
+    public:
+        Allocator();
+        ~Allocator();
+
+        void* Malloc(size_t in_uSize, const char* in_pszFile, AkUInt32 in_uLine) override;
+        void Free(void* in_pMemAddress) override;
+        void* Malign(size_t in_uSize, size_t in_uAlignment, const char* in_pszFile, AkUInt32 in_uLine) override;
+
+        AkUInt32 uNumAllocs;
+        AkUInt32 uNumFrees;
+        size_t uBytesInUse;
+        size_t uPeakBytesInUse;
+
+    private:
+        std::mutex m_lock;      ///< Guards the statistics
+    };
+
+    /// Global plug-in context of the sound engine, which only runs the Term callbacks. One for the
+    /// process, returned by every EffectContext.
+    class GlobalContext
+        : public AK::IAkGlobalPluginContext
+    {
+    public:
+        static GlobalContext& Get();
+
+        AKRESULT RegisterGlobalCallback(AkPluginType in_eType, AkUInt32 in_ulCompanyID, AkUInt32 in_ulPluginID,
+            AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation = AkGlobalCallbackLocation_BeginRender, void* in_pCookie = nullptr) override;
+        AKRESULT UnregisterGlobalCallback(AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation = AkGlobalCallbackLocation_BeginRender) override;
+
+        /// Runs the callbacks registered at AkGlobalCallbackLocation_Term, as the sound engine does when
+        /// it terminates. Allocators run it when they are destroyed.
+        void Term();
+
+    private:
+        struct Callback
+        {
+            AkGlobalCallbackFunc pCallback;
+            AkUInt32 uLocations;
+            void* pCookie;
+        };
+
+        std::mutex m_lock;      ///< Guards the callbacks, registered from the threads initializing effects
+        std::vector<Callback> m_callbacks;
+    };
+
+    /// Effect plug-in context. Monitor data posting is enabled with bCanPostMonitorData,
+    /// and the last posted payload is kept in monitorData.
+    class EffectContext
+        : public AK::IAkEffectPluginContext
+    {
+    public:
+        EffectContext();
+
+        AK::IAkGlobalPluginContext* GlobalContext() const override;
+        AKRESULT PostMonitorData(void* in_pData, AkUInt32 in_uDataSize) override;
+        bool CanPostMonitorData() override;
+        bool IsSendModeEffect() const override;
+        AkUniqueID GetNodeID() const override;
+
+        static const AkUInt32 MaxMonitorDataSize = 4096;
+
+        bool bCanPostMonitorData;
+        AkUniqueID uNodeID;
+        AkUInt32 uNumMonitorPosts;
+        AkUInt32 uMonitorDataSize;
+        AkUInt8 monitorData[MaxMonitorDataSize];
+    };
+
+    /// Deinterleaved audio buffer owning its sample storage.
+    class Buffer
+    {
+    public:
+        Buffer();
+        ~Buffer();
+
+        /// Allocates storage for in_uMaxFrames frames of in_channelConfig, all of them valid.
+        bool Allocate(AkChannelConfig in_channelConfig, AkUInt16 in_uMaxFrames);
+        void Release();
+
+        /// Fills every channel with deterministic white noise of the given peak amplitude.
+        void FillNoise(AkUInt32 in_uSeed, AkReal32 in_fAmplitude);
+
+        /// Copies the samples of another buffer of the same shape.
+        void CopyFrom(const Buffer& in_other);
+
+        AkAudioBuffer& Get() { return m_buffer; }
+        AkReal32* GetData() { return m_pData; }
+        AkUInt32 GetNumSamples() const { return m_uNumSamples; }
+
+    private:
+        Buffer(const Buffer&);
+        Buffer& operator=(const Buffer&);
+
+        AkAudioBuffer m_buffer;
+        AkReal32* m_pData;
+        AkUInt32 m_uNumSamples;
+    };
+
+    /// A WoaGainFX instance with its parameter node, created through the plug-in factory functions.
+    class Instance
+    {
+    public:
+        Instance();
+        ~Instance();
+
+        /// Creates and initializes the parameter node, then the effect. The parameter node is initialized
+        /// from in_pParamsBlock as laid out in a bank (see WoaGainPlugin::GetBankParameters), or with its
+        /// default values without a block.
+        AKRESULT Init(Allocator& in_allocator, EffectContext& in_context, AkAudioFormat& in_format, const void* in_pParamsBlock = nullptr, AkUInt32 in_uBlockSize = 0);
+        void Term();
+
+        /// Forwards to IAkPluginParam::SetParam.
+        AKRESULT SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 in_uParamSize);
+        AKRESULT SetParam(AkPluginParamID in_paramID, AkReal32 in_fValue) { return SetParam(in_paramID, &in_fValue, sizeof(in_fValue)); }
+        AKRESULT SetParam(AkPluginParamID in_paramID, bool in_bValue) { return SetParam(in_paramID, &in_bValue, sizeof(in_bValue)); }
+        AKRESULT SetParam(AkPluginParamID in_paramID, AkInt32 in_iValue) { return SetParam(in_paramID, &in_iValue, sizeof(in_iValue)); }
+
+        void Execute(AkAudioBuffer& io_buffer) { m_pEffect->Execute(&io_buffer); }
+        AKRESULT TimeSkip(AkUInt32 in_uFrames) { return m_pEffect->TimeSkip(in_uFrames); }
+
+        AK::IAkInPlaceEffectPlugin* GetEffect() { return m_pEffect; }
+        AK::IAkPluginParam* GetParams() { return m_pParams; }
+
+    private:
+        Instance(const Instance&);
+        Instance& operator=(const Instance&);
+
+        Allocator* m_pAllocator;
+        AK::IAkInPlaceEffectPlugin* m_pEffect;
+        AK::IAkPluginParam* m_pParams;
+    };
+
+    /// Returns a standard channel configuration with in_uNumChannels channels:
+    /// mono, stereo, 5.1, 7.1 and 7.1.4 for 1, 2, 6, 8 and 12, anonymous otherwise.
+    AkChannelConfig GetChannelConfig(AkUInt32 in_uNumChannels);
+
+    /// Returns a short name for a channel configuration, e.g. "5.1".
+    const char* GetChannelConfigName(AkChannelConfig in_channelConfig);
+
+    /// Returns an audio format for the given channel configuration and sample rate.
+    AkAudioFormat GetAudioFormat(AkChannelConfig in_channelConfig, AkUInt32 in_uSampleRate);
+}
+
+#endif // WoaGainHost_H
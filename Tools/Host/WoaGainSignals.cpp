@@ -0,0 +1,113 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#include "WoaGainSignals.h"
+
+#include <math.h>
+
+const char* WoaGainSignals::GetAutomationName(Automation in_eAutomation)
+{
+    switch (in_eAutomation)
+    {
+    case Automation_Static: return "static";
+    case Automation_Steps: return "steps";
+    case Automation_Sweep: return "sweep";
+    case Automation_Unity: return "unity";
+    case Automation_Mute: return "mute";
+    default: return "unknown";
+    }
+}
+
+AkReal32 WoaGainSignals::GetAutomatedGain(Automation in_eAutomation, AkUInt32 in_uBuffer)
+{
+    switch (in_eAutomation)
+    {
+    case Automation_Steps: return ((in_uBuffer / BuffersPerChunk) & 1) ? -12.f : -6.f;
+    case Automation_Sweep: return -6.f + 3.f * sinf((AkReal32)in_uBuffer * 0.1f);
+    case Automation_Unity: return 0.f;
+    case Automation_Mute: return -96.f;
+    default: return -6.f;
+    }
+}
+
+const char* WoaGainSignals::GetCurveName(WoaGainDSP::Curve in_eCurve)
+{
+    switch (in_eCurve)
+    {
+    case WoaGainDSP::Curve_Linear: return "ramp_linear";
+    case WoaGainDSP::Curve_Decibel: return "ramp_decibel";
+    case WoaGainDSP::Curve_SCurve: return "ramp_scurve";
+    default: return "unknown";
+    }
+}
+
+WoaGainDSP::BufferGain WoaGainSignals::MakeCurveRamp(WoaGainDSP::Curve in_eCurve, AkUInt16 in_uFrames, AkReal32 in_fFromDb, AkReal32 in_fToDb)
+{
+    WoaGainDSP::BufferGain gain;
+    gain.uFrames = in_uFrames;
+    gain.uRampFrames = in_uFrames;
+    gain.fGain = AK_DBTOLIN(in_fToDb);
+    gain.eCurve = in_eCurve;
+    gain.fRampFromDb = in_fFromDb;
+    gain.fRampRangeDb = in_fToDb - in_fFromDb;
+    gain.fScaleStart = 1.f;
+    gain.fScaleInc = 0.f;
+    if (in_eCurve == WoaGainDSP::Curve_Linear)
+    {
+        gain.fRampStart = AK_DBTOLIN(in_fFromDb);
+        gain.fRampInc = (gain.fGain - gain.fRampStart) / (AkReal32)in_uFrames;
+    }
+    else
+    {
+        gain.fRampStart = 0.f;
+        gain.fRampInc = 1.f / (AkReal32)in_uFrames;
+    }
+    return gain;
+}
+
+const char* WoaGainSignals::GetKernelGainName(KernelGain in_eGain)
+{
+    switch (in_eGain)
+    {
+    case KernelGain_Constant: return "constant";
+    case KernelGain_Ramp: return "ramp";
+    case KernelGain_Curve: return "scurve";
+    default: return "unknown";
+    }
+}
+
+WoaGainDSP::BufferGain WoaGainSignals::MakeKernelGain(KernelGain in_eGain, AkUInt16 in_uFrames, bool in_bUp)
+{
+    const AkReal32 fFromDb = in_bUp ? -6.f : 6.f;
+    if (in_eGain == KernelGain_Constant)
+    {
+        WoaGainDSP::BufferGain gain = MakeCurveRamp(WoaGainDSP::Curve_Linear, in_uFrames, fFromDb, fFromDb);
+        gain.uRampFrames = 0;
+        return gain;
+    }
+    return MakeCurveRamp(in_eGain == KernelGain_Curve ? WoaGainDSP::Curve_SCurve : WoaGainDSP::Curve_Linear, in_uFrames, fFromDb, -fFromDb);
+}
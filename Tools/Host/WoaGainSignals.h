@@ -0,0 +1,79 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainSignals_H
+#define WoaGainSignals_H
+
+#include "../../SoundEnginePlugin/WoaGainDSP.h"
+
+/// Gain automations and buffer gains shared by WoaGainBench and WoaGainTests, so that the
+/// configurations timed are the ones checked.
+namespace WoaGainSignals
+{
+    /// Buffers between two steps of Automation_Steps, and between two refills of the input in the
+    /// timing loops, so that the signal never decays into denormals, even squared for metering.
+    const AkUInt32 BuffersPerChunk = 16;
+
+    /// Gain parameter changes from buffer to buffer.
+    enum Automation
+    {
+        Automation_Static,  ///< Constant gain
+        Automation_Steps,   ///< A new gain every BuffersPerChunk buffers
+        Automation_Sweep,   ///< A new gain every buffer
+        Automation_Unity,   ///< Constant 0 dB gain
+        Automation_Mute,    ///< Constant gain at the -96 dB floor
+        Automation_Count
+    };
+
+    const char* GetAutomationName(Automation in_eAutomation);
+
+    /// Gain parameter in dB set before processing buffer in_uBuffer.
+    AkReal32 GetAutomatedGain(Automation in_eAutomation, AkUInt32 in_uBuffer);
+
+    /// Short name of a smoothing curve, e.g. "ramp_scurve".
+    const char* GetCurveName(WoaGainDSP::Curve in_eCurve);
+
+    /// Gain ramp of in_uFrames frames along in_eCurve between two gains in dB, as set up by WoaGainFX::RampGain.
+    WoaGainDSP::BufferGain MakeCurveRamp(WoaGainDSP::Curve in_eCurve, AkUInt16 in_uFrames, AkReal32 in_fFromDb, AkReal32 in_fToDb);
+
+    /// Gains applied directly to the buffer kernels.
+    enum KernelGain
+    {
+        KernelGain_Constant,
+        KernelGain_Ramp,    ///< Linear ramp
+        KernelGain_Curve,   ///< S-curve ramp
+        KernelGain_Count
+    };
+
+    const char* GetKernelGainName(KernelGain in_eGain);
+
+    /// Buffer gain of in_eGain between -6 and +6 dB, up or down, so that the signal neither decays
+    /// nor grows over buffers processed alternately up and down.
+    WoaGainDSP::BufferGain MakeKernelGain(KernelGain in_eGain, AkUInt16 in_uFrames, bool in_bUp);
+}
+
+#endif // WoaGainSignals_H
@@ -0,0 +1,155 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name.
+
+#ifndef AK_MOCK_AKCOMMONDEFS_H
+#define AK_MOCK_AKCOMMONDEFS_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+#include <AK/SoundEngine/Common/AkSpeakerConfig.h>
+
+#include <math.h>
+#include <string.h>
+
+#define AK_DBTOLIN( __db__ ) (powf(10.f,(__db__) * 0.05f))
+
+enum AkPluginType
+{
+    AkPluginTypeNone = 0,
+    AkPluginTypeCodec = 1,
+    AkPluginTypeSource = 2,
+    AkPluginTypeEffect = 3,
+    AkPluginTypeMixer = 6,
+    AkPluginTypeSink = 7,
+};
+
+enum AkChannelConfigType
+{
+    AK_ChannelConfigType_Anonymous = 0x0,
+    AK_ChannelConfigType_Standard = 0x1,
+    AK_ChannelConfigType_Ambisonic = 0x2,
+};
+
+struct AkChannelConfig
+{
+    AkUInt32 uNumChannels : 8;
+    AkUInt32 eConfigType : 4;
+    AkUInt32 uChannelMask : 20;
+
+    AkChannelConfig() : uNumChannels(0), eConfigType(0), uChannelMask(0) {}
+
+    AkChannelConfig(AkUInt32 in_uNumChannels, AkUInt32 in_uChannelMask)
+    {
+        uNumChannels = in_uNumChannels;
+        eConfigType = AK_ChannelConfigType_Standard;
+        uChannelMask = in_uChannelMask;
+    }
+
+    inline void Clear() { uNumChannels = 0; eConfigType = 0; uChannelMask = 0; }
+
+    inline void SetStandard(AkUInt32 in_uChannelMask)
+    {
+        uNumChannels = AK::GetNumberOfChannels(in_uChannelMask);
+        eConfigType = AK_ChannelConfigType_Standard;
+        uChannelMask = in_uChannelMask;
+    }
+
+    inline void SetAnonymous(AkUInt32 in_uNumChannels)
+    {
+        uNumChannels = in_uNumChannels;
+        eConfigType = AK_ChannelConfigType_Anonymous;
+        uChannelMask = 0;
+    }
+
+    inline bool IsValid() const { return uNumChannels != 0; }
+    inline bool HasLFE() const { return (uChannelMask & AK_SPEAKER_LOW_FREQUENCY) != 0; }
+    inline bool HasCenter() const { return (uChannelMask & AK_SPEAKER_FRONT_CENTER) != 0; }
+};
+
+struct AkAudioFormat
+{
+    AkUInt32 uSampleRate;
+    AkChannelConfig channelConfig;
+    AkUInt32 uBitsPerSample : 6;
+    AkUInt32 uBlockAlign : 10;
+    AkUInt32 uTypeID : 2;
+    AkUInt32 uInterleaveID : 1;
+
+    inline AkUInt32 GetNumChannels() const { return channelConfig.uNumChannels; }
+    inline bool HasLFE() const { return channelConfig.HasLFE(); }
+};
+
+/// Deinterleaved audio buffer. Channels are stored contiguously, MaxFrames() samples apart,
+/// with the LFE channel last as in the Wwise pipeline.
+class AkAudioBuffer
+{
+public:
+    AkAudioBuffer() { Clear(); }
+
+    inline void ClearData() { pData = NULL; uValidFrames = 0; }
+    inline void Clear() { ClearData(); uMaxFrames = 0; channelConfig.Clear(); eState = AK_DataReady; }
+
+    inline AkUInt32 NumChannels() const { return channelConfig.uNumChannels; }
+    inline bool HasLFE() const { return channelConfig.HasLFE(); }
+    inline AkChannelConfig GetChannelConfig() const { return channelConfig; }
+
+    inline AkSampleType* GetChannel(AkUInt32 in_uIndex)
+    {
+        return (AkSampleType*)((AkUInt8*)(pData) + (in_uIndex * sizeof(AkSampleType) * MaxFrames()));
+    }
+
+    inline AkSampleType* GetLFE()
+    {
+        return HasLFE() ? GetChannel(NumChannels() - 1) : (AkSampleType*)0;
+    }
+
+    inline AkUInt16 MaxFrames() const { return uMaxFrames; }
+
+    inline void AttachContiguousDeinterleavedData(void* in_pData, AkUInt16 in_uMaxFrames, AkUInt16 in_uValidFrames, AkChannelConfig in_channelConfig)
+    {
+        pData = in_pData;
+        uMaxFrames = in_uMaxFrames;
+        uValidFrames = in_uValidFrames;
+        channelConfig = in_channelConfig;
+    }
+
+    inline void ZeroPadToMaxFrames()
+    {
+        for (AkUInt32 i = 0; i < NumChannels(); ++i)
+            memset(GetChannel(i) + uValidFrames, 0, sizeof(AkSampleType) * (uMaxFrames - uValidFrames));
+    }
+
+    AKRESULT eState;
+    AkUInt16 uValidFrames;
+
+protected:
+    void* pData;
+    AkChannelConfig channelConfig;
+    AkUInt16 uMaxFrames;
+};
+
+#endif // AK_MOCK_AKCOMMONDEFS_H
@@ -0,0 +1,123 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name. Only the AKSIMD macros used by
+// the plug-in are provided, for SSE2 (x86) and NEON (ARM) hosts.
+
+#ifndef AK_MOCK_AKSIMD_H
+#define AK_MOCK_AKSIMD_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#define AKSIMD_ALIGNSIZE( __Size__ ) (((__Size__) + 15) & ~15)
+
+#if defined(AK_CPU_X86_64) || defined(AK_CPU_X86)
+
+#include <emmintrin.h>
+
+#define AKSIMD_SSE2
+#define AKSIMD_V4F32_SUPPORTED
+
+typedef __m128 AKSIMD_V4F32;
+typedef __m128i AKSIMD_V4I32;
+
+#define AKSIMD_LOAD_V4F32( __addr__ ) _mm_load_ps( (AkReal32*)(__addr__) )
+#define AKSIMD_LOADU_V4F32( __addr__ ) _mm_loadu_ps( (__addr__) )
+#define AKSIMD_LOAD1_V4F32( __scalar__ ) _mm_load1_ps( &(__scalar__) )
+#define AKSIMD_SET_V4F32( __scalar__ ) _mm_set_ps1( (__scalar__) )
+#define AKSIMD_SETV_V4F32( _d, _c, _b, _a ) _mm_set_ps( (_d), (_c), (_b), (_a) )
+#define AKSIMD_SETZERO_V4F32() _mm_setzero_ps()
+#define AKSIMD_STORE_V4F32( __addr__, __vec__ ) _mm_store_ps( (AkReal32*)(__addr__), (__vec__) )
+#define AKSIMD_STOREU_V4F32( __addr__, __vec__ ) _mm_storeu_ps( (AkReal32*)(__addr__), (__vec__) )
+#define AKSIMD_GETELEMENT_V4F32( __vName, __num__ ) ((AkReal32*)&(__vName))[(__num__)]
+
+#define AKSIMD_ADD_V4F32( a, b ) _mm_add_ps( (a), (b) )
+#define AKSIMD_SUB_V4F32( a, b ) _mm_sub_ps( (a), (b) )
+#define AKSIMD_MUL_V4F32( a, b ) _mm_mul_ps( (a), (b) )
+#define AKSIMD_DIV_V4F32( a, b ) _mm_div_ps( (a), (b) )
+#define AKSIMD_MADD_V4F32( __a__, __b__, __c__ ) _mm_add_ps( _mm_mul_ps( (__a__), (__b__) ), (__c__) )
+#define AKSIMD_MIN_V4F32( a, b ) _mm_min_ps( (a), (b) )
+#define AKSIMD_MAX_V4F32( a, b ) _mm_max_ps( (a), (b) )
+#define AKSIMD_ABS_V4F32( a ) _mm_andnot_ps( _mm_set1_ps( -0.f ), (a) )
+#define AKSIMD_SQRT_V4F32( __a__ ) _mm_sqrt_ps( (__a__) )
+
+#define AKSIMD_SET_V4I32( __scalar__ ) _mm_set1_epi32( (__scalar__) )
+#define AKSIMD_ADD_V4I32( a, b ) _mm_add_epi32( (a), (b) )
+#define AKSIMD_SHIFTLEFT_V4I32( __vec__, __shiftBy__ ) _mm_slli_epi32( (__vec__), (__shiftBy__) )
+#define AKSIMD_CONVERT_V4I32_TO_V4F32( __vec__ ) _mm_cvtepi32_ps( (__vec__) )
+#define AKSIMD_CONVERT_V4F32_TO_V4I32( __vec__ ) _mm_cvtps_epi32( (__vec__) )
+#define AKSIMD_TRUNCATE_V4F32_TO_V4I32( __vec__ ) _mm_cvttps_epi32( (__vec__) )
+#define AKSIMD_CAST_V4I32_TO_V4F32( __vec__ ) _mm_castsi128_ps( (__vec__) )
+#define AKSIMD_CAST_V4F32_TO_V4I32( __vec__ ) _mm_castps_si128( (__vec__) )
+
+#elif defined(AK_CPU_ARM_NEON)
+
+#include <arm_neon.h>
+
+#define AKSIMD_NEON
+#define AKSIMD_V4F32_SUPPORTED
+
+typedef float32x4_t AKSIMD_V4F32;
+typedef int32x4_t AKSIMD_V4I32;
+
+static inline float32x4_t AKSIMD_SETV_V4F32_impl(float d, float c, float b, float a)
+{
+    const float v[4] = { a, b, c, d };
+    return vld1q_f32(v);
+}
+
+#define AKSIMD_LOAD_V4F32( __addr__ ) vld1q_f32( (const float32_t*)(__addr__) )
+#define AKSIMD_LOADU_V4F32( __addr__ ) vld1q_f32( (const float32_t*)(__addr__) )
+#define AKSIMD_LOAD1_V4F32( __scalar__ ) vld1q_dup_f32( &(__scalar__) )
+#define AKSIMD_SET_V4F32( __scalar__ ) vdupq_n_f32( (__scalar__) )
+#define AKSIMD_SETV_V4F32( _d, _c, _b, _a ) AKSIMD_SETV_V4F32_impl( (_d), (_c), (_b), (_a) )
+#define AKSIMD_SETZERO_V4F32() vdupq_n_f32( 0.f )
+#define AKSIMD_STORE_V4F32( __addr__, __vec__ ) vst1q_f32( (float32_t*)(__addr__), (__vec__) )
+#define AKSIMD_STOREU_V4F32( __addr__, __vec__ ) vst1q_f32( (float32_t*)(__addr__), (__vec__) )
+#define AKSIMD_GETELEMENT_V4F32( __vName, __num__ ) ((AkReal32*)&(__vName))[(__num__)]
+
+#define AKSIMD_ADD_V4F32( a, b ) vaddq_f32( (a), (b) )
+#define AKSIMD_SUB_V4F32( a, b ) vsubq_f32( (a), (b) )
+#define AKSIMD_MUL_V4F32( a, b ) vmulq_f32( (a), (b) )
+#define AKSIMD_DIV_V4F32( a, b ) vdivq_f32( (a), (b) )
+#define AKSIMD_MADD_V4F32( __a__, __b__, __c__ ) vaddq_f32( vmulq_f32( (__a__), (__b__) ), (__c__) )
+#define AKSIMD_MIN_V4F32( a, b ) vminq_f32( (a), (b) )
+#define AKSIMD_MAX_V4F32( a, b ) vmaxq_f32( (a), (b) )
+#define AKSIMD_ABS_V4F32( a ) vabsq_f32( (a) )
+#define AKSIMD_SQRT_V4F32( __a__ ) vsqrtq_f32( (__a__) )
+
+#define AKSIMD_SET_V4I32( __scalar__ ) vdupq_n_s32( (__scalar__) )
+#define AKSIMD_ADD_V4I32( a, b ) vaddq_s32( (a), (b) )
+#define AKSIMD_SHIFTLEFT_V4I32( __vec__, __shiftBy__ ) vshlq_n_s32( (__vec__), (__shiftBy__) )
+#define AKSIMD_CONVERT_V4I32_TO_V4F32( __vec__ ) vcvtq_f32_s32( (__vec__) )
+#define AKSIMD_CONVERT_V4F32_TO_V4I32( __vec__ ) vcvtnq_s32_f32( (__vec__) )
+#define AKSIMD_TRUNCATE_V4F32_TO_V4I32( __vec__ ) vcvtq_s32_f32( (__vec__) )
+#define AKSIMD_CAST_V4I32_TO_V4F32( __vec__ ) vreinterpretq_f32_s32( (__vec__) )
+#define AKSIMD_CAST_V4F32_TO_V4I32( __vec__ ) vreinterpretq_s32_f32( (__vec__) )
+
+#endif
+
+#endif // AK_MOCK_AKSIMD_H
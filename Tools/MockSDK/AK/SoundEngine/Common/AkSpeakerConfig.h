@@ -0,0 +1,69 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name.
+
+#ifndef AK_MOCK_AKSPEAKERCONFIG_H
+#define AK_MOCK_AKSPEAKERCONFIG_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#define AK_SPEAKER_FRONT_LEFT           0x1
+#define AK_SPEAKER_FRONT_RIGHT          0x2
+#define AK_SPEAKER_FRONT_CENTER         0x4
+#define AK_SPEAKER_LOW_FREQUENCY        0x8
+#define AK_SPEAKER_BACK_LEFT            0x10
+#define AK_SPEAKER_BACK_RIGHT           0x20
+#define AK_SPEAKER_BACK_CENTER          0x100
+#define AK_SPEAKER_SIDE_LEFT            0x200
+#define AK_SPEAKER_SIDE_RIGHT           0x400
+#define AK_SPEAKER_TOP                  0x800
+#define AK_SPEAKER_HEIGHT_FRONT_LEFT    0x1000
+#define AK_SPEAKER_HEIGHT_FRONT_CENTER  0x2000
+#define AK_SPEAKER_HEIGHT_FRONT_RIGHT   0x4000
+#define AK_SPEAKER_HEIGHT_BACK_LEFT     0x8000
+#define AK_SPEAKER_HEIGHT_BACK_CENTER   0x10000
+#define AK_SPEAKER_HEIGHT_BACK_RIGHT    0x20000
+
+#define AK_SPEAKER_SETUP_MONO           AK_SPEAKER_FRONT_CENTER
+#define AK_SPEAKER_SETUP_STEREO         (AK_SPEAKER_FRONT_LEFT | AK_SPEAKER_FRONT_RIGHT)
+#define AK_SPEAKER_SETUP_5              (AK_SPEAKER_SETUP_STEREO | AK_SPEAKER_FRONT_CENTER | AK_SPEAKER_SIDE_LEFT | AK_SPEAKER_SIDE_RIGHT)
+#define AK_SPEAKER_SETUP_5POINT1        (AK_SPEAKER_SETUP_5 | AK_SPEAKER_LOW_FREQUENCY)
+#define AK_SPEAKER_SETUP_7              (AK_SPEAKER_SETUP_5 | AK_SPEAKER_BACK_LEFT | AK_SPEAKER_BACK_RIGHT)
+#define AK_SPEAKER_SETUP_7POINT1        (AK_SPEAKER_SETUP_7 | AK_SPEAKER_LOW_FREQUENCY)
+#define AK_SPEAKER_SETUP_DOLBY_7_1_4    (AK_SPEAKER_SETUP_7POINT1 | AK_SPEAKER_HEIGHT_FRONT_LEFT | AK_SPEAKER_HEIGHT_FRONT_RIGHT | AK_SPEAKER_HEIGHT_BACK_LEFT | AK_SPEAKER_HEIGHT_BACK_RIGHT)
+
+namespace AK
+{
+    inline AkUInt32 GetNumberOfChannels(AkUInt32 in_uChannelMask)
+    {
+        AkUInt32 num = 0;
+        while (in_uChannelMask) { ++num; in_uChannelMask &= in_uChannelMask - 1; }
+        return num;
+    }
+}
+
+#endif // AK_MOCK_AKSPEAKERCONFIG_H
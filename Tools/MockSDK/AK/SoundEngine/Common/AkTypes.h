@@ -0,0 +1,109 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name, sufficient to build the
+// WoaGain sound engine plug-in on a Linux host without the SDK. Only the subset of the
+// API used by the plug-in is declared here.
+
+#ifndef AK_MOCK_AKTYPES_H
+#define AK_MOCK_AKTYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AK_CPU_X86_64
+#elif defined(__i386__) || defined(_M_IX86)
+#define AK_CPU_X86
+#elif defined(__aarch64__) || defined(__arm__)
+#define AK_CPU_ARM
+#define AK_CPU_ARM_NEON
+#endif
+
+#define AK_LINUX
+
+typedef int8_t   AkInt8;
+typedef int16_t  AkInt16;
+typedef int32_t  AkInt32;
+typedef int64_t  AkInt64;
+typedef uint8_t  AkUInt8;
+typedef uint16_t AkUInt16;
+typedef uint32_t AkUInt32;
+typedef uint64_t AkUInt64;
+typedef float    AkReal32;
+typedef double   AkReal64;
+typedef size_t   AkUIntPtr;
+
+typedef AkUInt32 AkUniqueID;
+typedef AkUInt16 AkPluginParamID;
+typedef AkUInt64 AkGameObjectID;
+typedef AkUInt32 AkPluginID;
+typedef AkReal32 AkSampleType;
+
+#define AK_RESTRICT __restrict__
+#define AkForceInline inline __attribute__((always_inline))
+#define AK_ALIGN(__declaration__, __alignment__) __declaration__ __attribute__((aligned(__alignment__)))
+#define AK_ALIGN_DMA __attribute__((aligned(16)))
+#define AK_SIMD_ALIGNMENT 16
+
+#define AK_INVALID_UNIQUE_ID 0
+
+enum AKRESULT
+{
+    AK_NotImplemented = 0,
+    AK_Success = 1,
+    AK_Fail = 2,
+    AK_PartialSuccess = 3,
+    AK_NotCompatible = 4,
+    AK_AlreadyConnected = 5,
+    AK_InvalidFile = 7,
+    AK_AudioFileHeaderTooLarge = 8,
+    AK_MaxReached = 9,
+    AK_InvalidID = 14,
+    AK_IDNotFound = 15,
+    AK_InvalidInstanceID = 16,
+    AK_NoMoreData = 17,
+    AK_InvalidStateGroup = 19,
+    AK_ChildAlreadyHasAParent = 20,
+    AK_InvalidLanguage = 21,
+    AK_CannotAddItseflAsAChild = 22,
+    AK_InvalidParameter = 31,
+    AK_ElementAlreadyInList = 35,
+    AK_PathNotFound = 36,
+    AK_PathNoVertices = 37,
+    AK_PathNotRunning = 38,
+    AK_PathNotPaused = 39,
+    AK_PathNodeAlreadyInList = 40,
+    AK_PathNodeNotInList = 41,
+    AK_DataNeeded = 43,
+    AK_NoDataNeeded = 44,
+    AK_DataReady = 45,
+    AK_NoDataReady = 46,
+    AK_InsufficientMemory = 52,
+    AK_Cancelled = 53,
+};
+
+#endif // AK_MOCK_AKTYPES_H
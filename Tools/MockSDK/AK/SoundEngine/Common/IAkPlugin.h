@@ -0,0 +1,236 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name.
+
+#ifndef AK_MOCK_IAKPLUGIN_H
+#define AK_MOCK_IAKPLUGIN_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+#include <AK/SoundEngine/Common/AkCommonDefs.h>
+
+#include <new>
+
+struct AkPluginInfo
+{
+    AkPluginInfo()
+        : eType(AkPluginTypeNone)
+        , uBuildVersion(0)
+        , bIsInPlace(true)
+        , bCanChangeRate(false)
+        , bReserved(false)
+    {}
+
+    AkPluginType eType;
+    AkUInt32 uBuildVersion;
+    bool bIsInPlace;
+    bool bCanChangeRate;
+    bool bReserved;
+};
+
+namespace AK
+{
+    class IAkPluginMemAlloc
+    {
+    protected:
+        virtual ~IAkPluginMemAlloc() {}
+
+    public:
+        virtual void* Malloc(size_t in_uSize, const char* in_pszFile, AkUInt32 in_uLine) = 0;
+        virtual void Free(void* in_pMemAddress) = 0;
+        virtual void* Malign(size_t in_uSize, size_t in_uAlignment, const char* in_pszFile, AkUInt32 in_uLine) = 0;
+    };
+
+    class IAkGlobalPluginContext;
+}
+
+// Locations of the global callbacks of the sound engine, from AkCallback.h in the SDK.
+enum AkGlobalCallbackLocation
+{
+    AkGlobalCallbackLocation_Register = (1 << 0),
+    AkGlobalCallbackLocation_Begin = (1 << 1),
+    AkGlobalCallbackLocation_PreProcessMessageQueueForRender = (1 << 2),
+    AkGlobalCallbackLocation_PostMessagesProcessed = (1 << 3),
+    AkGlobalCallbackLocation_BeginRender = (1 << 4),
+    AkGlobalCallbackLocation_EndRender = (1 << 5),
+    AkGlobalCallbackLocation_End = (1 << 6),
+    AkGlobalCallbackLocation_Term = (1 << 7),
+    AkGlobalCallbackLocation_Monitor = (1 << 8),
+    AkGlobalCallbackLocation_MonitorRecap = (1 << 9),
+    AkGlobalCallbackLocation_Init = (1 << 10),
+    AkGlobalCallbackLocation_Suspend = (1 << 11),
+    AkGlobalCallbackLocation_WakeupFromSuspend = (1 << 12),
+    AkGlobalCallbackLocation_Num = 13
+};
+
+typedef void (*AkGlobalCallbackFunc)(AK::IAkGlobalPluginContext* in_pContext, AkGlobalCallbackLocation in_eLocation, void* in_pCookie);
+
+namespace AK
+{
+    class IAkGlobalPluginContext
+    {
+    protected:
+        virtual ~IAkGlobalPluginContext() {}
+
+    public:
+        virtual AKRESULT RegisterGlobalCallback(AkPluginType in_eType, AkUInt32 in_ulCompanyID, AkUInt32 in_ulPluginID,
+            AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation = AkGlobalCallbackLocation_BeginRender, void* in_pCookie = nullptr) = 0;
+        virtual AKRESULT UnregisterGlobalCallback(AkGlobalCallbackFunc in_pCallback, AkUInt32 in_eLocation = AkGlobalCallbackLocation_BeginRender) = 0;
+    };
+
+    class IAkPluginContextBase
+    {
+    protected:
+        virtual ~IAkPluginContextBase() {}
+
+    public:
+        virtual IAkGlobalPluginContext* GlobalContext() const = 0;
+        virtual AKRESULT PostMonitorData(void* in_pData, AkUInt32 in_uDataSize) = 0;
+        virtual bool CanPostMonitorData() = 0;
+    };
+
+    class IAkEffectPluginContext : public IAkPluginContextBase
+    {
+    protected:
+        virtual ~IAkEffectPluginContext() {}
+
+    public:
+        virtual bool IsSendModeEffect() const = 0;
+        virtual AkUniqueID GetNodeID() const = 0;
+    };
+
+    class IAkPluginParam
+    {
+    protected:
+        virtual ~IAkPluginParam() {}
+
+    public:
+        virtual IAkPluginParam* Clone(IAkPluginMemAlloc* in_pAllocator) = 0;
+        virtual AKRESULT Init(IAkPluginMemAlloc* in_pAllocator, const void* in_pParamsBlock, AkUInt32 in_uBlockSize) = 0;
+        virtual AKRESULT Term(IAkPluginMemAlloc* in_pAllocator) = 0;
+        virtual AKRESULT SetParamsBlock(const void* in_pParamsBlock, AkUInt32 in_uBlockSize) = 0;
+        virtual AKRESULT SetParam(AkPluginParamID in_paramID, const void* in_pValue, AkUInt32 in_uParamSize) = 0;
+
+        static const AkPluginParamID ALL_PLUGIN_DATA_ID = 0x7FFF;
+    };
+
+    class IAkPlugin
+    {
+    protected:
+        virtual ~IAkPlugin() {}
+
+    public:
+        virtual AKRESULT Term(IAkPluginMemAlloc* in_pAllocator) = 0;
+        virtual AKRESULT Reset() = 0;
+        virtual AKRESULT GetPluginInfo(AkPluginInfo& out_rPluginInfo) = 0;
+        virtual bool SupportMediaRelocation() const { return false; }
+    };
+
+    class IAkEffectPlugin : public IAkPlugin
+    {
+    protected:
+        virtual ~IAkEffectPlugin() {}
+
+    public:
+        virtual AKRESULT Init(IAkPluginMemAlloc* in_pAllocator, IAkEffectPluginContext* in_pEffectPluginContext, IAkPluginParam* in_pParams, AkAudioFormat& io_rFormat) = 0;
+    };
+
+    class IAkInPlaceEffectPlugin : public IAkEffectPlugin
+    {
+    public:
+        virtual void Execute(AkAudioBuffer* io_pBuffer) = 0;
+        virtual AKRESULT TimeSkip(AkUInt32 in_uFrames) = 0;
+    };
+
+    template <class T>
+    AkForceInline void AkPluginDelete(IAkPluginMemAlloc* in_pAllocator, T* in_pObject)
+    {
+        if (in_pObject)
+        {
+            in_pObject->~T();
+            in_pAllocator->Free(in_pObject);
+        }
+    }
+}
+
+typedef AK::IAkPlugin* (*AkCreatePluginCallback)(AK::IAkPluginMemAlloc* in_pAllocator);
+typedef AK::IAkPluginParam* (*AkCreateParamCallback)(AK::IAkPluginMemAlloc* in_pAllocator);
+
+namespace AK
+{
+    class PluginRegistration;
+    inline PluginRegistration* g_pAKPluginList = nullptr;
+
+    class PluginRegistration
+    {
+    public:
+        PluginRegistration(AkPluginType in_eType, AkUInt32 in_ulCompanyID, AkUInt32 in_ulPluginID,
+            AkCreatePluginCallback in_pCreateFunc, AkCreateParamCallback in_pCreateParamFunc)
+            : pNext(g_pAKPluginList)
+            , m_eType(in_eType)
+            , m_ulCompanyID(in_ulCompanyID)
+            , m_ulPluginID(in_ulPluginID)
+            , m_pCreateFunc(in_pCreateFunc)
+            , m_pCreateParamFunc(in_pCreateParamFunc)
+        {
+            g_pAKPluginList = this;
+        }
+
+        PluginRegistration* pNext;
+        AkPluginType m_eType;
+        AkUInt32 m_ulCompanyID;
+        AkUInt32 m_ulPluginID;
+        AkCreatePluginCallback m_pCreateFunc;
+        AkCreateParamCallback m_pCreateParamFunc;
+    };
+}
+
+AkForceInline void* operator new(size_t size, AK::IAkPluginMemAlloc* in_pAllocator)
+{
+    return in_pAllocator->Malloc(size, __FILE__, __LINE__);
+}
+
+AkForceInline void operator delete(void*, AK::IAkPluginMemAlloc*)
+{
+}
+
+#define AK_PLUGIN_NEW(_allocator, _what) new(_allocator) _what
+#define AK_PLUGIN_ALLOC(_allocator, _size) (_allocator)->Malloc((_size), __FILE__, __LINE__)
+#define AK_PLUGIN_ALLOC_ALIGN(_allocator, _size, _align) (_allocator)->Malign((_size), (_align), __FILE__, __LINE__)
+#define AK_PLUGIN_DELETE(_allocator, _what) AK::AkPluginDelete((_allocator), (_what))
+#define AK_PLUGIN_FREE(_allocator, _pvmem) (_allocator)->Free((_pvmem))
+
+#define AK_IMPLEMENT_PLUGIN_FACTORY(_pluginName_, _plugintype_, _companyid_, _pluginid_) \
+    AK::IAkPlugin* Create##_pluginName_(AK::IAkPluginMemAlloc* in_pAllocator); \
+    AK::IAkPluginParam* Create##_pluginName_##Params(AK::IAkPluginMemAlloc* in_pAllocator); \
+    AK::PluginRegistration _pluginName_##Registration(_plugintype_, _companyid_, _pluginid_, Create##_pluginName_, Create##_pluginName_##Params);
+
+#define AK_STATIC_LINK_PLUGIN(_pluginName_) \
+    extern AK::PluginRegistration _pluginName_##Registration;
+
+#define DEFINE_PLUGIN_REGISTER_HOOK
+
+#endif // AK_MOCK_IAKPLUGIN_H
@@ -0,0 +1,54 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// Minimal stand-in for the Wwise SDK header of the same name.
+
+#ifndef AK_MOCK_AKBANKREADHELPERS_H
+#define AK_MOCK_AKBANKREADHELPERS_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include <string.h>
+
+namespace AK
+{
+    template <typename T>
+    inline T ReadBankData(AkUInt8*& in_rptr, AkUInt32& in_rSize)
+    {
+        T value;
+        memcpy(&value, in_rptr, sizeof(T));
+        in_rptr += sizeof(T);
+        in_rSize -= sizeof(T);
+        return value;
+    }
+}
+
+#define READBANKDATA( _Type, _Ptr, _Size ) AK::ReadBankData<_Type>( _Ptr, _Size )
+#define SKIPBANKDATA( _Type, _Ptr, _Size ) ( _Ptr ) += sizeof( _Type ); ( _Size ) -= sizeof( _Type )
+#define SKIPBANKBYTES( _NumBytes, _Ptr, _Size ) ( _Ptr ) += _NumBytes; ( _Size ) -= _NumBytes
+#define CHECKBANKDATASIZE( _DATACOUNT_, _RESULT_ ) if ( _DATACOUNT_ != 0 ) { _RESULT_ = AK_InvalidParameter; }
+
+#endif // AK_MOCK_AKBANKREADHELPERS_H
@@ -0,0 +1,54 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// Minimal stand-in for the Wwise SDK header of the same name.
+
+#ifndef AK_MOCK_AKPLATFORMFUNCS_H
+#define AK_MOCK_AKPLATFORMFUNCS_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include <time.h>
+
+namespace AKPLATFORM
+{
+    /// Current value of the high-resolution counter, in ticks of PerformanceFrequency.
+    inline void PerformanceCounter(AkInt64* out_piLastTime)
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        *out_piLastTime = (AkInt64)now.tv_sec * 1000000000 + now.tv_nsec;
+    }
+
+    /// Ticks per second of PerformanceCounter.
+    inline void PerformanceFrequency(AkInt64* out_piFreq)
+    {
+        *out_piFreq = 1000000000;
+    }
+}
+
+#endif // AK_MOCK_AKPLATFORMFUNCS_H
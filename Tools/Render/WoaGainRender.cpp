@@ -0,0 +1,312 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// WoaGainRender: applies the WoaGain effect to WAV files offline, without the Wwise runtime.
+//
+// Every file is streamed through WoaGainFX::Execute one buffer at a time, exactly as the sound
+// engine would process the voice with the same parameters and buffer size (--frames), so the
+// float output is bit-identical to the engine's. Input and output are memory-mapped and
+// converted one buffer at a time, so memory use does not depend on file sizes. Files are
+// rendered in parallel by a pool of --jobs threads with work stealing.
+//
+// Outputs keep the sample format of their input unless --float is given, and are written to
+// the output directory under the name of their input. A summary line with the throughput
+// (input MB per second) is printed once all files are rendered.
+//
+// With --target, the effect runs in auto-gain mode and corrects the gain of each file toward
+// the given loudness, with the default attack, release and maximum correction. With --offsets,
+// the parameter block carries a gain offset table written by WoaGainAnalyze, and each file is
+// rendered as the node whose short ID is the key of its name (WoaGainOffsetTable::GetFileKey).
+//
+// Usage: WoaGainRender [--gain dB] [--target LUFS] [--offsets table] [--frames N] [--jobs N] [--float]
+//                      -o <output dir> <input.wav>...
+
+#include "WoaGainWav.h"
+#include "WoaGainWorkStealingPool.h"
+#include "../Host/WoaGainHost.h"
+#include "../../SoundEnginePlugin/WoaGainFXParams.h"
+#include "../../WoaGainOffsetTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        AkReal32 fGain;         ///< Gain parameter, in dB
+        bool bAutoGain;         ///< Correct the gain toward fTargetLoudness
+        AkReal32 fTargetLoudness;   ///< Target loudness parameter, in LUFS
+        AkUInt16 uFrames;       ///< Frames per buffer processed by the effect
+        AkUInt32 uNumJobs;      ///< Files rendered in parallel
+        bool bFloat;            ///< Write 32-bit float outputs instead of the input format
+        const char* szOutputDir;
+        std::vector<AkUInt8> gainOffsets;   ///< Packed entries of the --offsets table
+        AkUInt32 uNumGainOffsets;
+    };
+
+    // Parameter block as written by WoaGainPlugin::GetBankParameters
+    std::vector<AkUInt8> MakeParamsBlock(const Options& in_options)
+    {
+        const AkReal32 fGain = in_options.fGain;
+        const bool bSmoothing = true;
+        const AkReal32 fSmoothingTime = 0.f;
+        const AkReal32 fMeterRate = 30.f;
+        const bool bLoudness = false;
+        const bool bAutoGain = in_options.bAutoGain;
+        const AkReal32 fTargetLoudness = in_options.fTargetLoudness;
+        const AkReal32 fAttackTime = 1000.f;
+        const AkReal32 fReleaseTime = 3000.f;
+        const AkReal32 fMaxCorrection = 12.f;
+        const AkInt32 iSmoothingCurve = 0;
+        const AkUInt32 uLevelKey = 0;
+
+        std::vector<AkUInt8> block(sizeof(AkReal32) * 7 + sizeof(bool) * 3 + sizeof(AkInt32) + sizeof(AkUInt32) * 2 + in_options.gainOffsets.size());
+        AkUInt8* pData = block.data();
+        memcpy(pData, &fGain, sizeof(fGain)); pData += sizeof(fGain);
+        memcpy(pData, &bSmoothing, sizeof(bSmoothing)); pData += sizeof(bSmoothing);
+        memcpy(pData, &fSmoothingTime, sizeof(fSmoothingTime)); pData += sizeof(fSmoothingTime);
+        memcpy(pData, &fMeterRate, sizeof(fMeterRate)); pData += sizeof(fMeterRate);
+        memcpy(pData, &bLoudness, sizeof(bLoudness)); pData += sizeof(bLoudness);
+        memcpy(pData, &bAutoGain, sizeof(bAutoGain)); pData += sizeof(bAutoGain);
+        memcpy(pData, &fTargetLoudness, sizeof(fTargetLoudness)); pData += sizeof(fTargetLoudness);
+        memcpy(pData, &fAttackTime, sizeof(fAttackTime)); pData += sizeof(fAttackTime);
+        memcpy(pData, &fReleaseTime, sizeof(fReleaseTime)); pData += sizeof(fReleaseTime);
+        memcpy(pData, &fMaxCorrection, sizeof(fMaxCorrection)); pData += sizeof(fMaxCorrection);
+        memcpy(pData, &iSmoothingCurve, sizeof(iSmoothingCurve)); pData += sizeof(iSmoothingCurve);
+        memcpy(pData, &uLevelKey, sizeof(uLevelKey)); pData += sizeof(uLevelKey);
+        memcpy(pData, &in_options.uNumGainOffsets, sizeof(in_options.uNumGainOffsets)); pData += sizeof(in_options.uNumGainOffsets);
+        if (!in_options.gainOffsets.empty())
+            memcpy(pData, in_options.gainOffsets.data(), in_options.gainOffsets.size());
+        return block;
+    }
+
+    bool LoadGainOffsets(const char* in_szPath, Options& io_options)
+    {
+        FILE* pFile = fopen(in_szPath, "rb");
+        if (!pFile)
+            return false;
+        std::vector<AkUInt8> data;
+        AkUInt8 chunk[4096];
+        size_t uRead;
+        while ((uRead = fread(chunk, 1, sizeof(chunk), pFile)) > 0)
+            data.insert(data.end(), chunk, chunk + uRead);
+        fclose(pFile);
+
+        AkUInt32 uNumEntries;
+        const AkUInt8* pEntries = WoaGainOffsetTable::ParseFile(data.data(), data.size(), uNumEntries);
+        if (!pEntries)
+            return false;
+        io_options.gainOffsets.assign(pEntries, pEntries + uNumEntries * WoaGainOffsetTable::EntrySize);
+        io_options.uNumGainOffsets = uNumEntries;
+        return true;
+    }
+
+    std::string GetOutputPath(const char* in_szOutputDir, const char* in_szInput)
+    {
+        const char* szName = strrchr(in_szInput, '/');
+        return std::string(in_szOutputDir) + "/" + (szName ? szName + 1 : in_szInput);
+    }
+
+    bool IsSameFile(const char* in_szPathA, const char* in_szPathB)
+    {
+        struct stat statA, statB;
+        return stat(in_szPathA, &statA) == 0 && stat(in_szPathB, &statB) == 0
+            && statA.st_dev == statB.st_dev && statA.st_ino == statB.st_ino;
+    }
+
+    bool Fail(const char* in_szPath, const char* in_szError)
+    {
+        fprintf(stderr, "%s: %s\n", in_szPath, in_szError);
+        return false;
+    }
+
+    // Renders one file, adding the bytes of its sample data to io_uBytesRead and io_uBytesWritten
+    bool RenderFile(const char* in_szInput, const std::string& in_output, const Options& in_options, WoaGainHost::Allocator& in_allocator, std::atomic<AkUInt64>& io_uBytesRead, std::atomic<AkUInt64>& io_uBytesWritten)
+    {
+        WoaGainWav::Reader reader;
+        if (!reader.Open(in_szInput))
+            return Fail(in_szInput, reader.GetError());
+        if (IsSameFile(in_szInput, in_output.c_str()))
+            return Fail(in_szInput, "the output would overwrite the input");
+
+        WoaGainWav::Format outputFormat = reader.GetFormat();
+        if (in_options.bFloat)
+            outputFormat.eSampleFormat = WoaGainWav::SampleFormat_Float32;
+
+        WoaGainWav::Writer writer;
+        if (!writer.Create(in_output.c_str(), outputFormat, reader.GetNumFrames()))
+            return Fail(in_output.c_str(), writer.GetError());
+
+        // Parameters come from a bank block, as in the engine: the effect starts at the
+        // requested gain without a ramp
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(reader.GetFormat().uNumChannels);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, reader.GetFormat().uSampleRate);
+        WoaGainHost::EffectContext context;
+        context.uNodeID = WoaGainOffsetTable::GetFileKey(in_szInput);
+        WoaGainHost::Instance instance;
+        const std::vector<AkUInt8> block = MakeParamsBlock(in_options);
+        if (instance.Init(in_allocator, context, format, block.data(), (AkUInt32)block.size()) != AK_Success)
+            return Fail(in_szInput, "cannot initialize the effect");
+
+        WoaGainHost::Buffer buffer;
+        if (!buffer.Allocate(channelConfig, in_options.uFrames))
+            return Fail(in_szInput, "cannot allocate the audio buffer");
+
+        for (AkUInt64 uFrame = 0; uFrame < reader.GetNumFrames(); uFrame += in_options.uFrames)
+        {
+            reader.Read(uFrame, buffer.Get());
+            instance.Execute(buffer.Get());
+            writer.Write(uFrame, buffer.Get());
+        }
+
+        instance.Term();
+        if (!writer.Close())
+            return Fail(in_output.c_str(), "cannot complete the file");
+
+        io_uBytesRead += reader.GetNumFrames() * reader.GetFormat().GetBytesPerFrame();
+        io_uBytesWritten += reader.GetNumFrames() * outputFormat.GetBytesPerFrame();
+        return true;
+    }
+
+    void PrintUsage(const char* in_szProgram)
+    {
+        fprintf(stderr, "Usage: %s [--gain dB] [--target LUFS] [--offsets table] [--frames N] [--jobs N] [--float] -o <output dir> <input.wav>...\n", in_szProgram);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.fGain = 0.f;
+    options.bAutoGain = false;
+    options.fTargetLoudness = -23.f;
+    options.uFrames = 1024;
+    options.uNumJobs = std::thread::hardware_concurrency();
+    options.bFloat = false;
+    options.szOutputDir = nullptr;
+    options.uNumGainOffsets = 0;
+
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool bHasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--gain") == 0 && bHasValue)
+            options.fGain = (AkReal32)atof(argv[++i]);
+        else if (strcmp(argv[i], "--target") == 0 && bHasValue)
+        {
+            options.bAutoGain = true;
+            options.fTargetLoudness = (AkReal32)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--offsets") == 0 && bHasValue)
+        {
+            if (!LoadGainOffsets(argv[++i], options))
+            {
+                fprintf(stderr, "%s: not a gain offset table\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && bHasValue)
+            options.uFrames = (AkUInt16)std::min(std::max(atoi(argv[++i]), 1), 65535);
+        else if (strcmp(argv[i], "--jobs") == 0 && bHasValue)
+            options.uNumJobs = (AkUInt32)std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--float") == 0)
+            options.bFloat = true;
+        else if (strcmp(argv[i], "-o") == 0 && bHasValue)
+            options.szOutputDir = argv[++i];
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+            inputs.push_back(argv[i]);
+    }
+    if (!options.szOutputDir || inputs.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (options.uNumJobs == 0)
+        options.uNumJobs = 1;
+
+    // Two inputs with the same name would overwrite each other's output
+    std::vector<std::string> outputs;
+    std::set<std::string> outputSet;
+    for (const char* szInput : inputs)
+    {
+        outputs.push_back(GetOutputPath(options.szOutputDir, szInput));
+        if (!outputSet.insert(outputs.back()).second)
+        {
+            fprintf(stderr, "%s: another input has the same output %s\n", szInput, outputs.back().c_str());
+            return 1;
+        }
+    }
+
+    // Largest files first, so that the last jobs to run are short ones
+    std::vector<AkUInt32> order(inputs.size());
+    std::vector<AkUInt64> sizes(inputs.size());
+    for (AkUInt32 i = 0; i < (AkUInt32)inputs.size(); ++i)
+    {
+        struct stat fileStat;
+        sizes[i] = stat(inputs[i], &fileStat) == 0 ? (AkUInt64)fileStat.st_size : 0;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sizes](AkUInt32 a, AkUInt32 b) { return sizes[a] > sizes[b]; });
+
+    std::atomic<AkUInt64> uBytesRead(0);
+    std::atomic<AkUInt64> uBytesWritten(0);
+    std::atomic<AkUInt32> uNumFailed(0);
+    const AkUInt32 uNumThreads = std::min(options.uNumJobs, (AkUInt32)inputs.size());
+
+    // One allocator for every job, as in the engine: with pooled allocation, the slabs carved
+    // into instances outlive the jobs that allocated them
+    WoaGainHost::Allocator allocator;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    WoaGainWorkStealingPool pool;
+    pool.Run((AkUInt32)inputs.size(), uNumThreads, [&](AkUInt32 in_uJob)
+    {
+        const AkUInt32 uInput = order[in_uJob];
+        if (!RenderFile(inputs[uInput], outputs[uInput], options, allocator, uBytesRead, uBytesWritten))
+            ++uNumFailed;
+    });
+    const AkReal64 fSeconds = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+
+    const AkReal64 fInputMB = (AkReal64)uBytesRead.load() / 1e6;
+    printf("files=%u failed=%u jobs=%u frames=%u input_mb=%.1f output_mb=%.1f seconds=%.3f mb_per_sec=%.1f\n",
+        (AkUInt32)inputs.size(), uNumFailed.load(), uNumThreads, options.uFrames,
+        fInputMB, (AkReal64)uBytesWritten.load() / 1e6, fSeconds, fSeconds > 0. ? fInputMB / fSeconds : 0.);
+    return uNumFailed.load() == 0 ? 0 : 1;
+}
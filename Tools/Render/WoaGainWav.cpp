@@ -0,0 +1,449 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainWav.h"
+
+#include <AK/Tools/Common/AkAssert.h>
+
+#include <math.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const AkUInt16 WAVE_FORMAT_PCM = 1;
+    const AkUInt16 WAVE_FORMAT_IEEE_FLOAT = 3;
+    const AkUInt16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    // Pages behind the current position are released once this many bytes have been processed
+    const AkUInt64 kReleaseBytes = 4 << 20;
+
+    AkForceInline AkUInt16 ReadU16(const AkUInt8* in_pData)
+    {
+        return (AkUInt16)(in_pData[0] | (in_pData[1] << 8));
+    }
+
+    AkForceInline AkUInt32 ReadU32(const AkUInt8* in_pData)
+    {
+        return (AkUInt32)in_pData[0] | ((AkUInt32)in_pData[1] << 8) | ((AkUInt32)in_pData[2] << 16) | ((AkUInt32)in_pData[3] << 24);
+    }
+
+    AkForceInline void WriteU16(AkUInt8* out_pData, AkUInt16 in_uValue)
+    {
+        out_pData[0] = (AkUInt8)in_uValue;
+        out_pData[1] = (AkUInt8)(in_uValue >> 8);
+    }
+
+    AkForceInline void WriteU32(AkUInt8* out_pData, AkUInt32 in_uValue)
+    {
+        for (AkUInt32 i = 0; i < 4; ++i)
+            out_pData[i] = (AkUInt8)(in_uValue >> (8 * i));
+    }
+
+    // Releases the pages of a mapping below in_uPosition, in steps of at least kReleaseBytes.
+    // Pages of a shared mapping that were written stay in the page cache, to be written back.
+    void ReleaseBehind(AkUInt8* in_pMap, AkUInt64 in_uPosition, AkUInt64& io_uReleasedBytes)
+    {
+        if (in_uPosition < io_uReleasedBytes + kReleaseBytes)
+            return;
+
+        const AkUInt64 uPageSize = (AkUInt64)sysconf(_SC_PAGESIZE);
+        const AkUInt64 uEnd = in_uPosition / uPageSize * uPageSize;
+        madvise(in_pMap + io_uReleasedBytes, uEnd - io_uReleasedBytes, MADV_DONTNEED);
+        io_uReleasedBytes = uEnd;
+    }
+
+    template <WoaGainWav::SampleFormat in_eFormat>
+    AkForceInline AkReal32 ToFloat(const AkUInt8* in_pSample)
+    {
+        switch (in_eFormat)
+        {
+        case WoaGainWav::SampleFormat_Int16:
+            return (AkReal32)(AkInt16)ReadU16(in_pSample) * (1.f / 32768.f);
+        case WoaGainWav::SampleFormat_Int24:
+            return (AkReal32)((AkInt32)((AkUInt32)in_pSample[0] << 8 | (AkUInt32)in_pSample[1] << 16 | (AkUInt32)in_pSample[2] << 24) >> 8) * (1.f / 8388608.f);
+        case WoaGainWav::SampleFormat_Int32:
+            return (AkReal32)((AkReal64)(AkInt32)ReadU32(in_pSample) * (1. / 2147483648.));
+        default:
+        {
+            const AkUInt32 uBits = ReadU32(in_pSample);
+            AkReal32 fSample;
+            memcpy(&fSample, &uBits, sizeof(fSample));
+            return fSample;
+        }
+        }
+    }
+
+    // Scales to the integer range, clipping first so that the conversion cannot overflow. NaN gives the minimum.
+    AkForceInline AkInt64 ToInteger(AkReal64 in_fSample, AkReal64 in_fScale)
+    {
+        AkReal64 fValue = in_fSample * in_fScale;
+        if (!(fValue >= -in_fScale))
+            fValue = -in_fScale;
+        else if (fValue > in_fScale - 1.)
+            fValue = in_fScale - 1.;
+        return (AkInt64)llrint(fValue);
+    }
+
+    template <WoaGainWav::SampleFormat in_eFormat>
+    AkForceInline void FromFloat(AkReal32 in_fSample, AkUInt8* out_pSample)
+    {
+        switch (in_eFormat)
+        {
+        case WoaGainWav::SampleFormat_Int16:
+            WriteU16(out_pSample, (AkUInt16)ToInteger(in_fSample, 32768.));
+            break;
+        case WoaGainWav::SampleFormat_Int24:
+        {
+            const AkUInt32 uValue = (AkUInt32)ToInteger(in_fSample, 8388608.);
+            out_pSample[0] = (AkUInt8)uValue;
+            out_pSample[1] = (AkUInt8)(uValue >> 8);
+            out_pSample[2] = (AkUInt8)(uValue >> 16);
+            break;
+        }
+        case WoaGainWav::SampleFormat_Int32:
+            WriteU32(out_pSample, (AkUInt32)ToInteger(in_fSample, 2147483648.));
+            break;
+        default:
+        {
+            AkUInt32 uBits;
+            memcpy(&uBits, &in_fSample, sizeof(uBits));
+            WriteU32(out_pSample, uBits);
+            break;
+        }
+        }
+    }
+
+    template <WoaGainWav::SampleFormat in_eFormat>
+    void Deinterleave(const AkUInt8* in_pFrames, AkUInt32 in_uFrames, const WoaGainWav::Format& in_format, AkAudioBuffer& out_buffer)
+    {
+        const AkUInt32 uBytesPerSample = in_format.GetBytesPerSample();
+        const AkUInt32 uBytesPerFrame = in_format.GetBytesPerFrame();
+        for (AkUInt32 uChannel = 0; uChannel < in_format.uNumChannels; ++uChannel)
+        {
+            const AkUInt8* pIn = in_pFrames + uChannel * uBytesPerSample;
+            AkReal32* AK_RESTRICT pOut = out_buffer.GetChannel(uChannel);
+            for (AkUInt32 i = 0; i < in_uFrames; ++i, pIn += uBytesPerFrame)
+                pOut[i] = ToFloat<in_eFormat>(pIn);
+        }
+    }
+
+    template <WoaGainWav::SampleFormat in_eFormat>
+    void Interleave(AkAudioBuffer& in_buffer, AkUInt32 in_uFrames, const WoaGainWav::Format& in_format, AkUInt8* out_pFrames)
+    {
+        const AkUInt32 uBytesPerSample = in_format.GetBytesPerSample();
+        const AkUInt32 uBytesPerFrame = in_format.GetBytesPerFrame();
+        for (AkUInt32 uChannel = 0; uChannel < in_format.uNumChannels; ++uChannel)
+        {
+            const AkReal32* AK_RESTRICT pIn = in_buffer.GetChannel(uChannel);
+            AkUInt8* pOut = out_pFrames + uChannel * uBytesPerSample;
+            for (AkUInt32 i = 0; i < in_uFrames; ++i, pOut += uBytesPerFrame)
+                FromFloat<in_eFormat>(pIn[i], pOut);
+        }
+    }
+}
+
+AkUInt32 WoaGainWav::Format::GetBytesPerSample() const
+{
+    switch (eSampleFormat)
+    {
+    case SampleFormat_Int16: return 2;
+    case SampleFormat_Int24: return 3;
+    default: return 4;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Reader
+
+WoaGainWav::Reader::Reader()
+    : m_fd(-1)
+    , m_pMap(nullptr)
+    , m_uFileSize(0)
+    , m_uDataOffset(0)
+    , m_uReleasedBytes(0)
+    , m_uNumFrames(0)
+    , m_format()
+    , m_szError(nullptr)
+{
+}
+
+WoaGainWav::Reader::~Reader()
+{
+    Close();
+}
+
+bool WoaGainWav::Reader::Open(const char* in_szPath)
+{
+    Close();
+
+    m_fd = open(in_szPath, O_RDONLY);
+    if (m_fd < 0)
+        return Fail("cannot open the file");
+
+    struct stat fileStat;
+    if (fstat(m_fd, &fileStat) != 0)
+        return Fail("cannot read the file size");
+    m_uFileSize = (AkUInt64)fileStat.st_size;
+    if (m_uFileSize < 12)
+        return Fail("not a WAV file");
+
+    m_pMap = (AkUInt8*)mmap(nullptr, m_uFileSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (m_pMap == MAP_FAILED)
+    {
+        m_pMap = nullptr;
+        return Fail("cannot map the file");
+    }
+    madvise(m_pMap, m_uFileSize, MADV_SEQUENTIAL);
+
+    if (memcmp(m_pMap, "RIFF", 4) != 0 || memcmp(m_pMap + 8, "WAVE", 4) != 0)
+        return Fail("not a WAV file");
+
+    // Chunks are word-aligned. The data chunk may be the last one and its size may be
+    // unset by streaming writers: it then extends to the end of the file.
+    bool bHasFormat = false;
+    AkUInt64 uDataSize = 0;
+    AkUInt64 uOffset = 12;
+    while (uOffset + 8 <= m_uFileSize && m_uDataOffset == 0)
+    {
+        const AkUInt8* pChunk = m_pMap + uOffset;
+        const AkUInt64 uChunkSize = ReadU32(pChunk + 4);
+        const AkUInt64 uAvailable = m_uFileSize - (uOffset + 8);
+        if (memcmp(pChunk, "fmt ", 4) == 0)
+        {
+            if (uChunkSize < 16 || uChunkSize > uAvailable)
+                return Fail("invalid format chunk");
+
+            AkUInt16 uFormatTag = ReadU16(pChunk + 8);
+            const AkUInt16 uNumChannels = ReadU16(pChunk + 10);
+            const AkUInt32 uSampleRate = ReadU32(pChunk + 12);
+            const AkUInt16 uBlockAlign = ReadU16(pChunk + 20);
+            const AkUInt16 uBitsPerSample = ReadU16(pChunk + 22);
+            if (uFormatTag == WAVE_FORMAT_EXTENSIBLE && uChunkSize >= 40)
+                uFormatTag = ReadU16(pChunk + 32);  // First bytes of the sub-format GUID
+
+            if (uFormatTag == WAVE_FORMAT_PCM && uBitsPerSample == 16)
+                m_format.eSampleFormat = SampleFormat_Int16;
+            else if (uFormatTag == WAVE_FORMAT_PCM && uBitsPerSample == 24)
+                m_format.eSampleFormat = SampleFormat_Int24;
+            else if (uFormatTag == WAVE_FORMAT_PCM && uBitsPerSample == 32)
+                m_format.eSampleFormat = SampleFormat_Int32;
+            else if (uFormatTag == WAVE_FORMAT_IEEE_FLOAT && uBitsPerSample == 32)
+                m_format.eSampleFormat = SampleFormat_Float32;
+            else
+                return Fail("unsupported sample format, expecting 16, 24 or 32-bit PCM or 32-bit float");
+
+            // AkChannelConfig holds up to 255 channels
+            if (uNumChannels == 0 || uNumChannels > 255 || uSampleRate == 0)
+                return Fail("unsupported channel count or sample rate");
+            m_format.uNumChannels = uNumChannels;
+            m_format.uSampleRate = uSampleRate;
+            if (uBlockAlign != m_format.GetBytesPerFrame())
+                return Fail("invalid block alignment");
+            bHasFormat = true;
+        }
+        else if (memcmp(pChunk, "data", 4) == 0)
+        {
+            m_uDataOffset = uOffset + 8;
+            uDataSize = uChunkSize < uAvailable ? uChunkSize : uAvailable;
+        }
+        uOffset += 8 + uChunkSize + (uChunkSize & 1);
+    }
+
+    if (!bHasFormat || m_uDataOffset == 0)
+        return Fail("missing format or data chunk");
+
+    m_uNumFrames = uDataSize / m_format.GetBytesPerFrame();
+    m_uReleasedBytes = 0;
+    return true;
+}
+
+void WoaGainWav::Reader::Close()
+{
+    if (m_pMap)
+        munmap(m_pMap, m_uFileSize);
+    if (m_fd >= 0)
+        close(m_fd);
+    m_fd = -1;
+    m_pMap = nullptr;
+    m_uFileSize = 0;
+    m_uDataOffset = 0;
+    m_uNumFrames = 0;
+}
+
+void WoaGainWav::Reader::Read(AkUInt64 in_uFirstFrame, AkAudioBuffer& out_buffer)
+{
+    AKASSERT(out_buffer.NumChannels() == m_format.uNumChannels);
+
+    const AkUInt64 uFramesLeft = in_uFirstFrame < m_uNumFrames ? m_uNumFrames - in_uFirstFrame : 0;
+    const AkUInt32 uFrames = (AkUInt32)(uFramesLeft < out_buffer.MaxFrames() ? uFramesLeft : out_buffer.MaxFrames());
+    const AkUInt64 uOffset = m_uDataOffset + in_uFirstFrame * m_format.GetBytesPerFrame();
+    const AkUInt8* pFrames = m_pMap + uOffset;
+
+    switch (m_format.eSampleFormat)
+    {
+    case SampleFormat_Int16: Deinterleave<SampleFormat_Int16>(pFrames, uFrames, m_format, out_buffer); break;
+    case SampleFormat_Int24: Deinterleave<SampleFormat_Int24>(pFrames, uFrames, m_format, out_buffer); break;
+    case SampleFormat_Int32: Deinterleave<SampleFormat_Int32>(pFrames, uFrames, m_format, out_buffer); break;
+    default: Deinterleave<SampleFormat_Float32>(pFrames, uFrames, m_format, out_buffer); break;
+    }
+    out_buffer.uValidFrames = (AkUInt16)uFrames;
+
+    ReleaseBehind(m_pMap, uOffset, m_uReleasedBytes);
+}
+
+bool WoaGainWav::Reader::Fail(const char* in_szError)
+{
+    Close();
+    m_szError = in_szError;
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Writer
+
+WoaGainWav::Writer::Writer()
+    : m_fd(-1)
+    , m_pMap(nullptr)
+    , m_uFileSize(0)
+    , m_uDataOffset(0)
+    , m_uReleasedBytes(0)
+    , m_format()
+    , m_szError(nullptr)
+{
+}
+
+WoaGainWav::Writer::~Writer()
+{
+    Close();
+}
+
+bool WoaGainWav::Writer::Create(const char* in_szPath, const Format& in_format, AkUInt64 in_uNumFrames)
+{
+    Close();
+    m_format = in_format;
+
+    // Float files have the extended format chunk and the fact chunk that non-PCM formats require
+    const bool bFloat = in_format.eSampleFormat == SampleFormat_Float32;
+    const AkUInt32 uFormatSize = bFloat ? 18 : 16;
+    m_uDataOffset = 12 + (8 + uFormatSize) + (bFloat ? 12 : 0) + 8;
+
+    const AkUInt64 uDataSize = in_uNumFrames * in_format.GetBytesPerFrame();
+    if (m_uDataOffset - 8 + uDataSize > 0xFFFFFFFEull)
+        return Fail("output too large for a WAV file");
+    m_uFileSize = m_uDataOffset + uDataSize + (uDataSize & 1);
+
+    m_fd = open(in_szPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0)
+        return Fail("cannot create the file");
+    if (ftruncate(m_fd, (off_t)m_uFileSize) != 0)
+        return Fail("cannot size the file");
+
+    m_pMap = (AkUInt8*)mmap(nullptr, m_uFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_pMap == MAP_FAILED)
+    {
+        m_pMap = nullptr;
+        return Fail("cannot map the file");
+    }
+    madvise(m_pMap, m_uFileSize, MADV_SEQUENTIAL);
+
+    AkUInt8* pHeader = m_pMap;
+    memcpy(pHeader, "RIFF", 4);
+    WriteU32(pHeader + 4, (AkUInt32)(m_uFileSize - 8));
+    memcpy(pHeader + 8, "WAVE", 4);
+    pHeader += 12;
+
+    memcpy(pHeader, "fmt ", 4);
+    WriteU32(pHeader + 4, uFormatSize);
+    WriteU16(pHeader + 8, bFloat ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+    WriteU16(pHeader + 10, (AkUInt16)in_format.uNumChannels);
+    WriteU32(pHeader + 12, in_format.uSampleRate);
+    WriteU32(pHeader + 16, in_format.uSampleRate * in_format.GetBytesPerFrame());
+    WriteU16(pHeader + 20, (AkUInt16)in_format.GetBytesPerFrame());
+    WriteU16(pHeader + 22, (AkUInt16)(in_format.GetBytesPerSample() * 8));
+    if (bFloat)
+        WriteU16(pHeader + 24, 0);
+    pHeader += 8 + uFormatSize;
+
+    if (bFloat)
+    {
+        memcpy(pHeader, "fact", 4);
+        WriteU32(pHeader + 4, 4);
+        WriteU32(pHeader + 8, (AkUInt32)in_uNumFrames);
+        pHeader += 12;
+    }
+
+    memcpy(pHeader, "data", 4);
+    WriteU32(pHeader + 4, (AkUInt32)uDataSize);
+
+    m_uReleasedBytes = 0;
+    return true;
+}
+
+bool WoaGainWav::Writer::Close()
+{
+    bool bSuccess = true;
+    if (m_pMap)
+        bSuccess = munmap(m_pMap, m_uFileSize) == 0;
+    if (m_fd >= 0)
+        bSuccess = close(m_fd) == 0 && bSuccess;
+    m_fd = -1;
+    m_pMap = nullptr;
+    m_uFileSize = 0;
+    m_uDataOffset = 0;
+    return bSuccess;
+}
+
+void WoaGainWav::Writer::Write(AkUInt64 in_uFirstFrame, AkAudioBuffer& in_buffer)
+{
+    AKASSERT(in_buffer.NumChannels() == m_format.uNumChannels);
+
+    const AkUInt64 uOffset = m_uDataOffset + in_uFirstFrame * m_format.GetBytesPerFrame();
+    AkUInt8* pFrames = m_pMap + uOffset;
+    const AkUInt32 uFrames = in_buffer.uValidFrames;
+    AKASSERT(uOffset + (AkUInt64)uFrames * m_format.GetBytesPerFrame() <= m_uFileSize);
+
+    switch (m_format.eSampleFormat)
+    {
+    case SampleFormat_Int16: Interleave<SampleFormat_Int16>(in_buffer, uFrames, m_format, pFrames); break;
+    case SampleFormat_Int24: Interleave<SampleFormat_Int24>(in_buffer, uFrames, m_format, pFrames); break;
+    case SampleFormat_Int32: Interleave<SampleFormat_Int32>(in_buffer, uFrames, m_format, pFrames); break;
+    default: Interleave<SampleFormat_Float32>(in_buffer, uFrames, m_format, pFrames); break;
+    }
+
+    ReleaseBehind(m_pMap, uOffset, m_uReleasedBytes);
+}
+
+bool WoaGainWav::Writer::Fail(const char* in_szError)
+{
+    Close();
+    m_szError = in_szError;
+    return false;
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainWav_H
+#define WoaGainWav_H
+
+#include <AK/SoundEngine/Common/AkCommonDefs.h>
+
+/// Streaming access to WAV files through memory mapping, for the offline tools.
+///
+/// Files are mapped whole but only touched one chunk of frames at a time: the kernel reads them
+/// ahead sequentially, and pages behind the current position are released regularly, so memory
+/// use does not grow with the file size. Samples are converted to and from the deinterleaved
+/// 32-bit float buffers processed by WoaGainFX.
+namespace WoaGainWav
+{
+    enum SampleFormat
+    {
+        SampleFormat_Int16,
+        SampleFormat_Int24,
+        SampleFormat_Int32,
+        SampleFormat_Float32
+    };
+
+    struct Format
+    {
+        AkUInt32 uSampleRate;
+        AkUInt32 uNumChannels;
+        SampleFormat eSampleFormat;
+
+        AkUInt32 GetBytesPerSample() const;
+        AkUInt32 GetBytesPerFrame() const { return GetBytesPerSample() * uNumChannels; }
+    };
+
+    /// Reads the samples of a PCM (16, 24 or 32-bit) or IEEE float (32-bit) WAV file, including
+    /// WAVE_FORMAT_EXTENSIBLE files with those sample formats.
+    class Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+
+        /// Maps and parses the file. On failure, GetError describes the problem.
+        bool Open(const char* in_szPath);
+        void Close();
+
+        const Format& GetFormat() const { return m_format; }
+        AkUInt64 GetNumFrames() const { return m_uNumFrames; }
+        AkUInt64 GetFileSize() const { return m_uFileSize; }
+        const char* GetError() const { return m_szError; }
+
+        /// Converts frames [in_uFirstFrame, in_uFirstFrame + out_buffer.MaxFrames()) of the file, or
+        /// up to the last frame, into out_buffer and sets its valid frames. out_buffer must have
+        /// the channel count of the file. Frames are expected to be read in increasing order.
+        void Read(AkUInt64 in_uFirstFrame, AkAudioBuffer& out_buffer);
+
+    private:
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+
+        bool Fail(const char* in_szError);
+
+        int m_fd;
+        AkUInt8* m_pMap;
+        AkUInt64 m_uFileSize;
+        AkUInt64 m_uDataOffset;
+        AkUInt64 m_uReleasedBytes;  ///< Bytes at the start of the mapping already released
+        AkUInt64 m_uNumFrames;
+        Format m_format;
+        const char* m_szError;
+    };
+
+    /// Writes a WAV file of a known length, which is mapped and filled one chunk of frames at a time.
+    class Writer
+    {
+    public:
+        Writer();
+        ~Writer();
+
+        /// Creates or truncates the file and sizes it for in_uNumFrames frames of in_format.
+        /// On failure, GetError describes the problem.
+        bool Create(const char* in_szPath, const Format& in_format, AkUInt64 in_uNumFrames);
+
+        /// Unmaps and closes the file. Returns false if the file could not be completed.
+        bool Close();
+
+        const char* GetError() const { return m_szError; }
+
+        /// Converts the valid frames of in_buffer to frames starting at in_uFirstFrame in the file.
+        /// Integer formats are rounded to the nearest value and clipped. Frames are expected to be
+        /// written in increasing order.
+        void Write(AkUInt64 in_uFirstFrame, AkAudioBuffer& in_buffer);
+
+    private:
+        Writer(const Writer&);
+        Writer& operator=(const Writer&);
+
+        bool Fail(const char* in_szError);
+
+        int m_fd;
+        AkUInt8* m_pMap;
+        AkUInt64 m_uFileSize;
+        AkUInt64 m_uDataOffset;
+        AkUInt64 m_uReleasedBytes;  ///< Bytes at the start of the mapping already released
+        Format m_format;
+        const char* m_szError;
+    };
+}
+
+#endif // WoaGainWav_H
@@ -0,0 +1,105 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainWorkStealingPool_H
+#define WoaGainWorkStealingPool_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Runs jobs 0 to in_uNumJobs - 1 on in_uNumThreads threads. Jobs are dealt round-robin, in
+/// order, to one deque per thread. A thread takes its jobs from the front of its own deque and,
+/// once it is empty, steals from the back of the others', so threads given shorter jobs keep
+/// helping until every job is done. No job is added while running.
+class WoaGainWorkStealingPool
+{
+public:
+    void Run(AkUInt32 in_uNumJobs, AkUInt32 in_uNumThreads, const std::function<void(AkUInt32)>& in_job)
+    {
+        m_queues = std::vector<Queue>(in_uNumThreads);
+        for (AkUInt32 uJob = 0; uJob < in_uNumJobs; ++uJob)
+            m_queues[uJob % in_uNumThreads].jobs.push_back(uJob);
+
+        std::vector<std::thread> threads;
+        for (AkUInt32 uThread = 1; uThread < in_uNumThreads; ++uThread)
+            threads.emplace_back([this, uThread, &in_job] { Work(uThread, in_job); });
+        Work(0, in_job);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<AkUInt32> jobs;
+    };
+
+    void Work(AkUInt32 in_uThread, const std::function<void(AkUInt32)>& in_job)
+    {
+        AkUInt32 uJob;
+        while (Pop(in_uThread, uJob) || Steal(in_uThread, uJob))
+            in_job(uJob);
+    }
+
+    bool Pop(AkUInt32 in_uThread, AkUInt32& out_uJob)
+    {
+        Queue& queue = m_queues[in_uThread];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.jobs.empty())
+            return false;
+        out_uJob = queue.jobs.front();
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    bool Steal(AkUInt32 in_uThread, AkUInt32& out_uJob)
+    {
+        const AkUInt32 uNumQueues = (AkUInt32)m_queues.size();
+        for (AkUInt32 i = 1; i < uNumQueues; ++i)
+        {
+            Queue& queue = m_queues[(in_uThread + i) % uNumQueues];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (!queue.jobs.empty())
+            {
+                out_uJob = queue.jobs.back();
+                queue.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Queue> m_queues;
+};
+
+#endif // WoaGainWorkStealingPool_H
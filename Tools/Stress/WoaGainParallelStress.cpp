@@ -0,0 +1,623 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// WoaGainParallelStress: runs many WoaGainFX instances on a pool of worker threads, as a sound
+// engine processing its effect graph on several threads, to check that instances share no mutable
+// state and measure how the throughput scales with the threads.
+//
+// Every tick, the workers take the instances in chunks from a shared counter and process one
+// buffer of each. Instances cycle through mono, stereo and 5.1, a quarter of them monitored, and
+// change their parameters at random from a schedule of their own: gain, smoothing, meter rate,
+// loudness metering, auto gain (allocated and freed while running), level key, gain events and
+// TimeSkip. The run goes through four checks:
+//
+// - layout: the blocks allocated by the plug-in for every instance are recorded, and the run fails
+//   when two instances have blocks on the same cache line, which their threads would then write
+//   to concurrently (false sharing). Checked after each of the following phases.
+// - determinism: the same schedule is rendered with 1 thread, then with every thread count of the
+//   scaling phase, and the run fails when the output of an instance differs.
+// - scaling: the throughput in buffers per second from 1 thread to --threads (the number of cores
+//   by default, at least 2), with the speedup and efficiency over 1 thread.
+// - concurrent: writer threads set the parameters of random instances, post gain events and read
+//   the level registry while the workers process, and the run fails on a non-finite output.
+//
+// Build with -DWOAGAIN_TSAN=ON to run it under ThreadSanitizer, which reports any data race.
+//
+// Usage: WoaGainParallelStress [--json] [--quick] [--instances N] [--threads N] [--writers N] [--seconds N]
+
+#include "../Host/WoaGainHost.h"
+#include "../../SoundEnginePlugin/WoaGainFX.h"
+#include "../../SoundEnginePlugin/WoaGainLevelRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <math.h>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const AkUInt32 kSampleRate = 48000;
+    const AkUInt16 kFrames = 256;
+    const size_t kCacheLineSize = 64;
+
+    // Instances processed by a worker per job, taken from the shared counter
+    const AkUInt32 kInstancesPerJob = 8;
+
+    // Level keys the instances publish under, shared by several instances each
+    const AkUInt32 kNumLevelKeys = 8;
+
+    // Layouts the instances cycle through
+    const AkUInt32 kLayouts[] = { 1, 2, 6 };
+    const AkUInt32 kNumLayouts = sizeof(kLayouts) / sizeof(kLayouts[0]);
+
+    AkUInt32 Xorshift(AkUInt32& io_uState)
+    {
+        io_uState ^= io_uState << 13;
+        io_uState ^= io_uState >> 17;
+        io_uState ^= io_uState << 5;
+        return io_uState;
+    }
+
+    // Instance the blocks allocated by the current thread belong to, see LayoutAllocator
+    thread_local AkUInt32 t_uOwner = 0;
+
+    /// Host allocator recording the live blocks of every instance, tagged with t_uOwner.
+    class LayoutAllocator
+        : public WoaGainHost::Allocator
+    {
+    public:
+        void* Malign(size_t in_uSize, size_t in_uAlignment, const char* in_pszFile, AkUInt32 in_uLine) override
+        {
+            void* pMem = WoaGainHost::Allocator::Malign(in_uSize, in_uAlignment, in_pszFile, in_uLine);
+            if (pMem)
+            {
+                std::lock_guard<std::mutex> guard(m_blocksLock);
+                Block& block = m_blocks[(AkUIntPtr)pMem];
+                block.uSize = in_uSize;
+                block.uOwner = t_uOwner;
+            }
+            return pMem;
+        }
+
+        void Free(void* in_pMemAddress) override
+        {
+            if (in_pMemAddress)
+            {
+                std::lock_guard<std::mutex> guard(m_blocksLock);
+                m_blocks.erase((AkUIntPtr)in_pMemAddress);
+            }
+            WoaGainHost::Allocator::Free(in_pMemAddress);
+        }
+
+        /// Counts the cache lines holding blocks of more than one instance, and the live blocks.
+        AkUInt32 CountSharedLines(AkUInt32& out_uNumBlocks)
+        {
+            std::lock_guard<std::mutex> guard(m_blocksLock);
+            out_uNumBlocks = (AkUInt32)m_blocks.size();
+            AkUInt32 uShared = 0;
+            AkUIntPtr uLastLine = ~(AkUIntPtr)0;
+            AkUInt32 uLastOwner = 0;
+            bool bLastShared = false;
+            for (const std::pair<const AkUIntPtr, Block>& entry : m_blocks)
+            {
+                if (entry.second.uSize == 0)
+                    continue;
+                const AkUIntPtr uFirstLine = entry.first / kCacheLineSize;
+                if (uFirstLine == uLastLine && entry.second.uOwner != uLastOwner && !bLastShared)
+                {
+                    ++uShared;
+                    bLastShared = true;
+                }
+                const AkUIntPtr uEndLine = (entry.first + entry.second.uSize - 1) / kCacheLineSize;
+                if (uEndLine != uLastLine)
+                    bLastShared = false;
+                uLastLine = uEndLine;
+                uLastOwner = entry.second.uOwner;
+            }
+            return uShared;
+        }
+
+    private:
+        struct Block
+        {
+            size_t uSize;
+            AkUInt32 uOwner;
+        };
+
+        std::mutex m_blocksLock;
+        std::map<AkUIntPtr, Block> m_blocks;   ///< By address
+    };
+
+    /// Threads processing the jobs of every tick. The calling thread works as thread 0, and the
+    /// others wait for the next tick in between.
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(AkUInt32 in_uNumThreads)
+            : m_uGeneration(0)
+            , m_uNumBusy(0)
+            , m_bStop(false)
+            , m_uNumJobs(0)
+            , m_pJob(nullptr)
+        {
+            m_uNextJob.store(0, std::memory_order_relaxed);
+            for (AkUInt32 uThread = 1; uThread < in_uNumThreads; ++uThread)
+                m_threads.emplace_back([this] { Wait(); });
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_bStop = true;
+            }
+            m_start.notify_all();
+            for (std::thread& thread : m_threads)
+                thread.join();
+        }
+
+        /// Runs jobs 0 to in_uNumJobs - 1 on every thread and returns once they are all done.
+        void Run(AkUInt32 in_uNumJobs, const std::function<void(AkUInt32)>& in_job)
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_uNumJobs = in_uNumJobs;
+                m_pJob = &in_job;
+                m_uNextJob.store(0, std::memory_order_relaxed);
+                m_uNumBusy = (AkUInt32)m_threads.size();
+                ++m_uGeneration;
+            }
+            m_start.notify_all();
+            Work();
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_done.wait(lock, [this] { return m_uNumBusy == 0; });
+        }
+
+    private:
+        void Wait()
+        {
+            AkUInt32 uGeneration = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    m_start.wait(lock, [&] { return m_bStop || m_uGeneration != uGeneration; });
+                    if (m_bStop)
+                        return;
+                    uGeneration = m_uGeneration;
+                }
+                Work();
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    --m_uNumBusy;
+                }
+                m_done.notify_one();
+            }
+        }
+
+        void Work()
+        {
+            for (AkUInt32 uJob = m_uNextJob.fetch_add(1, std::memory_order_relaxed); uJob < m_uNumJobs; uJob = m_uNextJob.fetch_add(1, std::memory_order_relaxed))
+                (*m_pJob)(uJob);
+        }
+
+        std::mutex m_lock;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        AkUInt32 m_uGeneration;     ///< Ticks started, guarded by m_lock
+        AkUInt32 m_uNumBusy;        ///< Threads other than the caller still working on the tick
+        bool m_bStop;
+        AkUInt32 m_uNumJobs;
+        const std::function<void(AkUInt32)>* m_pJob;
+        std::atomic<AkUInt32> m_uNextJob;
+        std::vector<std::thread> m_threads;
+    };
+
+    /// An instance with its context and buffer, on cache lines of its own like the plug-in's blocks.
+    struct alignas(kCacheLineSize) Voice
+    {
+        WoaGainHost::EffectContext context;
+        WoaGainHost::Instance instance;
+        WoaGainHost::Buffer buffer;
+        AkUInt32 uLayout;       ///< Index in kLayouts
+        AkUInt32 uRandom;       ///< State of the parameter schedule
+        AkUInt64 uHash;         ///< Of every output, see HashBuffer
+        bool bFinite;           ///< No non-finite output so far
+    };
+
+    /// Instances of a run, with the input of each layout.
+    struct Graph
+    {
+        LayoutAllocator allocator;
+        std::vector<std::unique_ptr<Voice>> voices;
+        WoaGainHost::Buffer sources[kNumLayouts];
+    };
+
+    bool CreateGraph(Graph& out_graph, AkUInt32 in_uNumInstances)
+    {
+        for (AkUInt32 uLayout = 0; uLayout < kNumLayouts; ++uLayout)
+        {
+            out_graph.sources[uLayout].Allocate(WoaGainHost::GetChannelConfig(kLayouts[uLayout]), kFrames);
+            out_graph.sources[uLayout].FillNoise(uLayout + 1, 0.5f);
+        }
+
+        out_graph.voices.reserve(in_uNumInstances);
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            out_graph.voices.emplace_back(new Voice);
+            Voice& voice = *out_graph.voices.back();
+            voice.uLayout = i % kNumLayouts;
+            voice.uRandom = 0x9E3779B9u ^ (i * 2654435761u);
+            voice.uHash = 14695981039346656037ull;
+            voice.bFinite = true;
+            voice.context.bCanPostMonitorData = (i & 3) == 0;
+            voice.context.uNodeID = 1000 + i;
+
+            const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(kLayouts[voice.uLayout]);
+            AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+            t_uOwner = i + 1;
+            const AKRESULT eResult = voice.instance.Init(out_graph.allocator, voice.context, format);
+            t_uOwner = 0;
+            if (eResult != AK_Success || !voice.buffer.Allocate(channelConfig, kFrames))
+                return false;
+        }
+        return true;
+    }
+
+    // Changes a parameter of the instance at random, about one tick in eight, from the thread
+    // processing it. Returns whether the instance skips its buffer with TimeSkip.
+    bool ChangeParams(Voice& io_voice, AkUInt32 in_uIndex)
+    {
+        const AkUInt32 uRandom = Xorshift(io_voice.uRandom);
+        if ((uRandom & 7) != 0)
+            return false;
+
+        WoaGainHost::Instance& instance = io_voice.instance;
+        const AkUInt32 uValue = uRandom >> 8;
+        switch ((uRandom >> 3) % 10)
+        {
+        case 0:
+            instance.SetParam(PARAM_DUMMY_ID, -(AkReal32)(uValue % 40));
+            break;
+        case 1:
+            instance.SetParam(PARAM_SMOOTHING_CURVE_ID, (AkInt32)(uValue % WoaGainDSP::Curve_Count));
+            break;
+        case 2:
+            instance.SetParam(PARAM_SMOOTHING_TIME_ID, (AkReal32)(uValue % 3 == 0 ? 0 : uValue % 3 == 1 ? 5 : 50));
+            break;
+        case 3:
+            instance.SetParam(PARAM_METER_RATE_ID, (uValue & 1) ? 30.f : 0.f);
+            break;
+        case 4:
+            instance.SetParam(PARAM_LOUDNESS_ID, (uValue & 1) != 0);
+            break;
+        case 5:
+            instance.SetParam(PARAM_AUTO_GAIN_ID, (uValue & 1) != 0);
+            break;
+        case 6:
+            instance.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)((uValue & 1) ? 1 + in_uIndex % kNumLevelKeys : 0));
+            break;
+        case 7:
+            static_cast<WoaGainFXParams*>(instance.GetParams())->PostGainEvent(uValue % (2 * kFrames), -(AkReal32)(uValue % 40));
+            break;
+        case 8:
+            instance.SetParam(PARAM_SMOOTHING_ID, (uValue & 1) != 0);
+            break;
+        default:
+            return true;
+        }
+        return false;
+    }
+
+    // 64-bit FNV-1a over the words of the valid samples
+    void HashBuffer(WoaGainHost::Buffer& in_buffer, AkUInt64& io_uHash)
+    {
+        const AkUInt32* pWords = (const AkUInt32*)in_buffer.GetData();
+        for (AkUInt32 i = 0; i < in_buffer.GetNumSamples(); ++i)
+            io_uHash = (io_uHash ^ pWords[i]) * 1099511628211ull;
+    }
+
+    bool IsFinite(WoaGainHost::Buffer& in_buffer)
+    {
+        const AkReal32* pData = in_buffer.GetData();
+        for (AkUInt32 i = 0; i < in_buffer.GetNumSamples(); ++i)
+        {
+            if (!isfinite(pData[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Processes one tick of every instance of io_graph on io_pool: parameter changes, then one
+    // buffer of its layout's input, hashed and checked when asked.
+    void RunTick(Graph& io_graph, WorkerPool& io_pool, bool in_bRandomParams, bool in_bHash, bool in_bCheck)
+    {
+        const AkUInt32 uNumInstances = (AkUInt32)io_graph.voices.size();
+        io_pool.Run((uNumInstances + kInstancesPerJob - 1) / kInstancesPerJob, [&](AkUInt32 in_uJob)
+        {
+            const AkUInt32 uEnd = std::min((in_uJob + 1) * kInstancesPerJob, uNumInstances);
+            for (AkUInt32 i = in_uJob * kInstancesPerJob; i < uEnd; ++i)
+            {
+                Voice& voice = *io_graph.voices[i];
+                t_uOwner = i + 1;
+                const bool bSkip = in_bRandomParams && ChangeParams(voice, i);
+                voice.buffer.CopyFrom(io_graph.sources[voice.uLayout]);
+                if (bSkip)
+                    voice.instance.TimeSkip(kFrames);
+                else
+                    voice.instance.Execute(voice.buffer.Get());
+                if (in_bHash)
+                    HashBuffer(voice.buffer, voice.uHash);
+                if (in_bCheck && !IsFinite(voice.buffer))
+                    voice.bFinite = false;
+                t_uOwner = 0;
+            }
+        });
+    }
+
+    bool CheckLayout(bool in_bJson, const char* in_szPhase, Graph& in_graph)
+    {
+        AkUInt32 uNumBlocks;
+        const AkUInt32 uShared = in_graph.allocator.CountSharedLines(uNumBlocks);
+        const AkReal64 fBytesPerInstance = (AkReal64)in_graph.allocator.uBytesInUse / (AkReal64)in_graph.voices.size();
+        if (in_bJson)
+        {
+            printf("{\"check\":\"layout\",\"phase\":\"%s\",\"instances\":%u,\"blocks\":%u,\"bytes_per_instance\":%.0f,\"shared_lines\":%u,\"result\":\"%s\"}\n",
+                in_szPhase, (AkUInt32)in_graph.voices.size(), uNumBlocks, fBytesPerInstance, uShared, uShared == 0 ? "ok" : "fail");
+        }
+        else
+        {
+            printf("layout,%s,%u,%u,%.0f,%u,%s\n", in_szPhase, (AkUInt32)in_graph.voices.size(), uNumBlocks, fBytesPerInstance, uShared, uShared == 0 ? "ok" : "fail");
+        }
+        return uShared == 0;
+    }
+
+    // Renders in_uTicks ticks of the random schedule on in_uNumThreads threads, and returns the
+    // hash of every instance in out_hashes
+    bool RenderSchedule(AkUInt32 in_uNumInstances, AkUInt32 in_uNumThreads, AkUInt32 in_uTicks, bool in_bJson, std::vector<AkUInt64>& out_hashes)
+    {
+        Graph graph;
+        if (!CreateGraph(graph, in_uNumInstances))
+            return false;
+        WorkerPool pool(in_uNumThreads);
+        for (AkUInt32 uTick = 0; uTick < in_uTicks; ++uTick)
+            RunTick(graph, pool, true, true, false);
+        out_hashes.clear();
+        for (const std::unique_ptr<Voice>& pVoice : graph.voices)
+            out_hashes.push_back(pVoice->uHash);
+        return CheckLayout(in_bJson, "determinism", graph);
+    }
+
+    // Buffers processed per second on in_uNumThreads threads, with the random schedule
+    AkReal64 RunScaling(AkUInt32 in_uNumInstances, AkUInt32 in_uNumThreads, AkReal64 in_fSeconds)
+    {
+        Graph graph;
+        if (!CreateGraph(graph, in_uNumInstances))
+            return 0.;
+        WorkerPool pool(in_uNumThreads);
+        for (AkUInt32 uTick = 0; uTick < 4; ++uTick)
+            RunTick(graph, pool, true, false, false);
+
+        AkUInt32 uTicks = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        AkReal64 fElapsed = 0.;
+        do
+        {
+            RunTick(graph, pool, true, false, false);
+            ++uTicks;
+            fElapsed = std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count();
+        } while (fElapsed < in_fSeconds);
+        return (AkReal64)uTicks * in_uNumInstances / fElapsed;
+    }
+
+    // Workers process the instances while writer threads change the parameters of random ones,
+    // post gain events and read the level registry. Returns whether every output was finite and
+    // the layout check passed.
+    bool RunConcurrent(AkUInt32 in_uNumInstances, AkUInt32 in_uNumThreads, AkUInt32 in_uNumWriters, AkReal64 in_fSeconds, bool in_bJson)
+    {
+        Graph graph;
+        if (!CreateGraph(graph, in_uNumInstances))
+            return false;
+        WorkerPool pool(in_uNumThreads);
+
+        std::atomic<bool> bStop(false);
+        std::atomic<AkUInt64> uNumWrites(0);
+        std::atomic<AkUInt64> uNumReads(0);
+        std::vector<std::thread> writers;
+        for (AkUInt32 uWriter = 0; uWriter < in_uNumWriters; ++uWriter)
+        {
+            writers.emplace_back([&, uWriter]()
+            {
+                AkUInt32 uRandom = 0x2545F491u * (uWriter + 1);
+                AkUInt64 uWrites = 0;
+                AkUInt64 uReads = 0;
+                while (!bStop.load(std::memory_order_relaxed))
+                {
+                    const AkUInt32 uIndex = Xorshift(uRandom) % in_uNumInstances;
+                    const AkUInt32 uValue = Xorshift(uRandom);
+                    WoaGainFXParams* pParams = static_cast<WoaGainFXParams*>(graph.voices[uIndex]->instance.GetParams());
+                    t_uOwner = uIndex + 1;
+                    switch (uValue % 4)
+                    {
+                    case 0:
+                    {
+                        const AkReal32 fGain = -(AkReal32)(uValue % 40);
+                        pParams->SetParam(PARAM_DUMMY_ID, &fGain, sizeof(fGain));
+                        break;
+                    }
+                    case 1:
+                    {
+                        const AkInt32 iLevelKey = (uValue & 8) ? (AkInt32)(1 + uIndex % kNumLevelKeys) : 0;
+                        pParams->SetParam(PARAM_LEVEL_KEY_ID, &iLevelKey, sizeof(iLevelKey));
+                        break;
+                    }
+                    case 2:
+                        pParams->PostGainEvent(uValue % (2 * kFrames), -(AkReal32)(uValue % 40));
+                        break;
+                    default:
+                    {
+                        WoaGainLevelRegistry::Level level;
+                        WoaGainLevelRegistry::Read(1 + uValue % kNumLevelKeys, level);
+                        ++uReads;
+                        break;
+                    }
+                    }
+                    t_uOwner = 0;
+                    ++uWrites;
+                }
+                uNumWrites.fetch_add(uWrites - uReads, std::memory_order_relaxed);
+                uNumReads.fetch_add(uReads, std::memory_order_relaxed);
+            });
+        }
+
+        AkUInt32 uTicks = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        do
+        {
+            RunTick(graph, pool, true, false, true);
+            ++uTicks;
+        } while (std::chrono::duration<AkReal64>(std::chrono::steady_clock::now() - start).count() < in_fSeconds);
+
+        bStop.store(true, std::memory_order_relaxed);
+        for (std::thread& writer : writers)
+            writer.join();
+
+        AkUInt32 uNumNonFinite = 0;
+        for (const std::unique_ptr<Voice>& pVoice : graph.voices)
+            uNumNonFinite += pVoice->bFinite ? 0 : 1;
+        if (in_bJson)
+        {
+            printf("{\"check\":\"concurrent\",\"threads\":%u,\"writers\":%u,\"ticks\":%u,\"writes\":%llu,\"reads\":%llu,\"non_finite_instances\":%u,\"result\":\"%s\"}\n",
+                in_uNumThreads, in_uNumWriters, uTicks, (unsigned long long)uNumWrites.load(), (unsigned long long)uNumReads.load(), uNumNonFinite, uNumNonFinite == 0 ? "ok" : "fail");
+        }
+        else
+        {
+            printf("concurrent,threads,writers,ticks,writes,reads,non_finite_instances,result\n");
+            printf("concurrent,%u,%u,%u,%llu,%llu,%u,%s\n", in_uNumThreads, in_uNumWriters, uTicks,
+                (unsigned long long)uNumWrites.load(), (unsigned long long)uNumReads.load(), uNumNonFinite, uNumNonFinite == 0 ? "ok" : "fail");
+        }
+        const bool bLayout = CheckLayout(in_bJson, "concurrent", graph);
+        return uNumNonFinite == 0 && bLayout;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool bJson = false;
+    bool bQuick = false;
+    AkUInt32 uNumInstances = 0;
+    AkUInt32 uMaxThreads = 0;
+    AkUInt32 uNumWriters = 2;
+    AkReal64 fSeconds = 0.;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            bJson = true;
+        else if (strcmp(argv[i], "--quick") == 0)
+            bQuick = true;
+        else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+            uNumInstances = (AkUInt32)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            uMaxThreads = (AkUInt32)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--writers") == 0 && i + 1 < argc)
+            uNumWriters = (AkUInt32)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            fSeconds = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--json] [--quick] [--instances N] [--threads N] [--writers N] [--seconds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (uNumInstances == 0)
+        uNumInstances = bQuick ? 512 : 2048;
+    // At least 2 threads, for the determinism and concurrent checks to run workers in parallel
+    if (uMaxThreads == 0)
+        uMaxThreads = std::max(std::thread::hardware_concurrency(), 2u);
+    if (fSeconds <= 0.)
+        fSeconds = bQuick ? 0.25 : 1.;
+    const AkUInt32 uTicks = bQuick ? 64 : 256;
+
+    // Thread counts of the scaling phase: powers of two up to the cores, and the cores
+    std::vector<AkUInt32> threadCounts;
+    for (AkUInt32 uThreads = 1; uThreads < uMaxThreads; uThreads *= 2)
+        threadCounts.push_back(uThreads);
+    threadCounts.push_back(uMaxThreads);
+
+    if (!bJson)
+        printf("layout,phase,instances,blocks,bytes_per_instance,shared_lines,result\n");
+    bool bPassed = true;
+
+    // Determinism: every thread count renders the schedule of 1 thread
+    std::vector<AkUInt64> reference, hashes;
+    bPassed = RenderSchedule(uNumInstances, 1, uTicks, bJson, reference) && bPassed;
+    AkUInt32 uNumMismatches = 0;
+    for (AkUInt32 uThreads : threadCounts)
+    {
+        if (uThreads == 1)
+            continue;
+        bPassed = RenderSchedule(uNumInstances, uThreads, uTicks, bJson, hashes) && bPassed;
+        for (AkUInt32 i = 0; i < uNumInstances; ++i)
+            uNumMismatches += hashes[i] != reference[i] ? 1 : 0;
+    }
+    if (bJson)
+        printf("{\"check\":\"determinism\",\"instances\":%u,\"ticks\":%u,\"thread_counts\":%u,\"mismatches\":%u,\"result\":\"%s\"}\n", uNumInstances, uTicks, (AkUInt32)threadCounts.size(), uNumMismatches, uNumMismatches == 0 ? "ok" : "fail");
+    else
+        printf("determinism,instances,ticks,thread_counts,mismatches,result\ndeterminism,%u,%u,%u,%u,%s\n", uNumInstances, uTicks, (AkUInt32)threadCounts.size(), uNumMismatches, uNumMismatches == 0 ? "ok" : "fail");
+    bPassed = uNumMismatches == 0 && bPassed;
+    fflush(stdout);
+
+    if (!bJson)
+        printf("scaling,threads,instances,buffers_per_sec,speedup,efficiency\n");
+    AkReal64 fSingleThread = 0.;
+    for (AkUInt32 uThreads : threadCounts)
+    {
+        const AkReal64 fBuffersPerSec = RunScaling(uNumInstances, uThreads, fSeconds);
+        if (uThreads == 1)
+            fSingleThread = fBuffersPerSec;
+        const AkReal64 fSpeedup = fSingleThread > 0. ? fBuffersPerSec / fSingleThread : 0.;
+        if (bJson)
+            printf("{\"check\":\"scaling\",\"threads\":%u,\"instances\":%u,\"buffers_per_sec\":%.0f,\"speedup\":%.2f,\"efficiency\":%.2f}\n", uThreads, uNumInstances, fBuffersPerSec, fSpeedup, fSpeedup / uThreads);
+        else
+            printf("scaling,%u,%u,%.0f,%.2f,%.2f\n", uThreads, uNumInstances, fBuffersPerSec, fSpeedup, fSpeedup / uThreads);
+        fflush(stdout);
+    }
+
+    bPassed = RunConcurrent(uNumInstances, uMaxThreads, uNumWriters, fSeconds, bJson) && bPassed;
+    if (!bPassed)
+        fprintf(stderr, "Parallel stress failed\n");
+    return bPassed ? 0 : 1;
+}
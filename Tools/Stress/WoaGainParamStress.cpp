@@ -0,0 +1,295 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+// WoaGainParamStress: checks the parameter handoff between the threads setting parameters and
+// the audio thread under contention.
+//
+// Writer threads publish complete parameter sets with SetParamsBlock, in which every non-RTPC
+// value derives from the same counter, and hammer the gain with SetParam. Meanwhile, the audio
+// thread runs WoaGainFX::Execute and takes parameter snapshots, checking that every snapshot
+// holds a single published set (no torn read) and that the gain is one of the values written.
+// Every set also replaces the gain offset table, which the audio thread searches concurrently,
+// directly and through clones of the parameter node sharing it.
+// The writers setting the gain also post gain events, which the effect consumes as it executes;
+// from 4 writers on, several threads post to the event ring at once.
+// Exits with an error on the first inconsistent snapshot or offset.
+//
+// Usage: WoaGainParamStress [--seconds N] [--writers N]
+
+#include "../Host/WoaGainHost.h"
+#include "../../SoundEnginePlugin/WoaGainFXParams.h"
+#include "../../WoaGainOffsetTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const AkUInt32 kSampleRate = 48000;
+    const AkUInt16 kFrames = 256;
+    const AkUniqueID kNodeID = 1000;
+
+    // Parameter block as written by WoaGainPlugin::GetBankParameters.
+    // Every value of the set derives from in_uValue, in 1 to 1000. The gain offset table has
+    // 1 to 4 entries, the first one for kNodeID with an offset of -in_uValue hundredths of a dB.
+    std::vector<AkUInt8> MakeParamsBlock(AkUInt32 in_uValue)
+    {
+        const AkReal32 fGain = -(AkReal32)(in_uValue % 97);
+        const bool bSmoothing = (in_uValue & 1) != 0;
+        const AkReal32 fSmoothingTime = (AkReal32)in_uValue;
+        const AkReal32 fMeterRate = (AkReal32)in_uValue;
+        const bool bLoudness = (in_uValue & 2) != 0;
+        const bool bAutoGain = (in_uValue & 4) != 0;
+        const AkReal32 fTargetLoudness = -(AkReal32)(in_uValue % 70);
+        const AkReal32 fAttackTime = (AkReal32)in_uValue;
+        const AkReal32 fReleaseTime = (AkReal32)in_uValue;
+        const AkReal32 fMaxCorrection = (AkReal32)(in_uValue % 48);
+        const AkInt32 iSmoothingCurve = (AkInt32)(in_uValue % 3);
+        const AkUInt32 uLevelKey = in_uValue;
+
+        const AkUInt32 uNumGainOffsets = in_uValue % 4 + 1;
+
+        std::vector<AkUInt8> block(sizeof(AkReal32) * 7 + sizeof(bool) * 3 + sizeof(AkInt32) + sizeof(AkUInt32) * 2 + uNumGainOffsets * WoaGainOffsetTable::EntrySize);
+        AkUInt8* pData = block.data();
+        memcpy(pData, &fGain, sizeof(fGain)); pData += sizeof(fGain);
+        memcpy(pData, &bSmoothing, sizeof(bSmoothing)); pData += sizeof(bSmoothing);
+        memcpy(pData, &fSmoothingTime, sizeof(fSmoothingTime)); pData += sizeof(fSmoothingTime);
+        memcpy(pData, &fMeterRate, sizeof(fMeterRate)); pData += sizeof(fMeterRate);
+        memcpy(pData, &bLoudness, sizeof(bLoudness)); pData += sizeof(bLoudness);
+        memcpy(pData, &bAutoGain, sizeof(bAutoGain)); pData += sizeof(bAutoGain);
+        memcpy(pData, &fTargetLoudness, sizeof(fTargetLoudness)); pData += sizeof(fTargetLoudness);
+        memcpy(pData, &fAttackTime, sizeof(fAttackTime)); pData += sizeof(fAttackTime);
+        memcpy(pData, &fReleaseTime, sizeof(fReleaseTime)); pData += sizeof(fReleaseTime);
+        memcpy(pData, &fMaxCorrection, sizeof(fMaxCorrection)); pData += sizeof(fMaxCorrection);
+        memcpy(pData, &iSmoothingCurve, sizeof(iSmoothingCurve)); pData += sizeof(iSmoothingCurve);
+        memcpy(pData, &uLevelKey, sizeof(uLevelKey)); pData += sizeof(uLevelKey);
+        memcpy(pData, &uNumGainOffsets, sizeof(uNumGainOffsets)); pData += sizeof(uNumGainOffsets);
+        for (AkUInt32 i = 0; i < uNumGainOffsets; ++i)
+        {
+            WoaGainOffsetTable::Entry entry;
+            entry.uKey = kNodeID + i;
+            entry.iOffset = (AkInt16)(-(AkInt32)in_uValue - (AkInt32)i);
+            WoaGainOffsetTable::WriteEntry(entry, pData);
+            pData += WoaGainOffsetTable::EntrySize;
+        }
+        return block;
+    }
+
+    // Gains written by SetParam and SetParamsBlock are integers in [-96, 0] dB
+    bool IsWrittenGain(AkReal32 in_fGain)
+    {
+        return in_fGain <= 0.f && in_fGain >= -96.f && in_fGain == floorf(in_fGain);
+    }
+
+    bool IsConsistent(const WoaGainParamsSnapshot& in_snapshot)
+    {
+        const AkReal32 fValue = in_snapshot.NonRTPC.fSmoothingTime;
+        const AkUInt32 uValue = (AkUInt32)fValue;
+        return fValue >= 1.f && fValue <= 1000.f && (AkReal32)uValue == fValue &&
+            in_snapshot.NonRTPC.fMeterRate == fValue &&
+            in_snapshot.NonRTPC.bSmoothing == ((uValue & 1) != 0) &&
+            in_snapshot.NonRTPC.bLoudness == ((uValue & 2) != 0) &&
+            in_snapshot.NonRTPC.bAutoGain == ((uValue & 4) != 0) &&
+            in_snapshot.RTPC.fTargetLoudness == -(AkReal32)(uValue % 70) &&
+            in_snapshot.NonRTPC.fAttackTime == fValue &&
+            in_snapshot.NonRTPC.fReleaseTime == fValue &&
+            in_snapshot.NonRTPC.fMaxCorrection == (AkReal32)(uValue % 48) &&
+            in_snapshot.NonRTPC.iSmoothingCurve == (AkInt32)(uValue % 3) &&
+            in_snapshot.NonRTPC.uLevelKey == uValue &&
+            IsWrittenGain(in_snapshot.RTPC.fDummy);
+    }
+
+    // Every table has an offset for kNodeID, a whole number of hundredths of a dB in [-10, -0.01]
+    bool FindValidOffset(const WoaGainFXParams& in_params)
+    {
+        AkReal32 fOffsetDb;
+        if (!in_params.FindGainOffset(kNodeID, fOffsetDb))
+        {
+            fprintf(stderr, "Missing gain offset\n");
+            return false;
+        }
+        const AkReal32 fHundredths = -fOffsetDb * 100.f;
+        if (!(fHundredths >= 1.f && fHundredths <= 1000.f && fabsf(fHundredths - roundf(fHundredths)) < 1e-3f))
+        {
+            fprintf(stderr, "Invalid gain offset: %f dB\n", fOffsetDb);
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    AkReal64 fSeconds = 2.;
+    AkUInt32 uNumWriters = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            fSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--writers") == 0 && i + 1 < argc)
+            uNumWriters = (AkUInt32)atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--seconds N] [--writers N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (uNumWriters == 0)
+        uNumWriters = 1;
+
+    const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+    AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+    WoaGainHost::Allocator allocator;
+    WoaGainHost::EffectContext context;
+    context.bCanPostMonitorData = true;
+    context.uNodeID = kNodeID;
+    WoaGainHost::Instance instance;
+    if (instance.Init(allocator, context, format) != AK_Success)
+    {
+        fprintf(stderr, "Failed to initialize the effect\n");
+        return 1;
+    }
+
+    WoaGainFXParams* pParams = static_cast<WoaGainFXParams*>(instance.GetParams());
+    const std::vector<AkUInt8> initialBlock = MakeParamsBlock(1);
+    pParams->SetParamsBlock(initialBlock.data(), (AkUInt32)initialBlock.size());
+
+    std::atomic<bool> bStop(false);
+    std::atomic<AkUInt64> uNumWrites(0);
+    std::atomic<AkUInt64> uNumEvents(0);
+
+    // Even writers publish complete sets, odd writers hammer the gain alone and post gain events
+    std::vector<std::thread> writers;
+    for (AkUInt32 uWriter = 0; uWriter < uNumWriters; ++uWriter)
+    {
+        writers.emplace_back([&, uWriter]()
+        {
+            AkUInt64 uWrites = 0;
+            AkUInt64 uEvents = 0;
+            for (AkUInt32 uValue = uWriter; !bStop.load(std::memory_order_relaxed); uValue += uNumWriters)
+            {
+                if (uWriter & 1)
+                {
+                    const AkReal32 fGain = -(AkReal32)(uValue % 97);
+                    pParams->SetParam(PARAM_DUMMY_ID, &fGain, sizeof(fGain));
+                    if (pParams->PostGainEvent(uValue % (4 * kFrames), fGain) == AK_Success)
+                        ++uEvents;
+                }
+                else
+                {
+                    const std::vector<AkUInt8> block = MakeParamsBlock(uValue % 1000 + 1);
+                    pParams->SetParamsBlock(block.data(), (AkUInt32)block.size());
+                }
+                ++uWrites;
+            }
+            uNumWrites.fetch_add(uWrites, std::memory_order_relaxed);
+            uNumEvents.fetch_add(uEvents, std::memory_order_relaxed);
+        });
+    }
+
+    // Audio thread: this one
+    WoaGainHost::Buffer buffer;
+    buffer.Allocate(channelConfig, kFrames);
+    WoaGainParamsSnapshot snapshot = WoaGainParamsSnapshot();
+    AkUInt64 uNumBuffers = 0;
+    AkUInt64 uNumSnapshots = 0;
+    AkUInt64 uNumFallbacks = 0;
+    AkUInt64 uNumLookups = 0;
+    AkUInt64 uNumClones = 0;
+    bool bTorn = false;
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<AkReal64>(fSeconds));
+    while (!bTorn && std::chrono::steady_clock::now() < end)
+    {
+        if ((uNumBuffers & 15) == 0)
+            buffer.FillNoise(1234, 0.5f);
+        instance.Execute(buffer.Get());
+        ++uNumBuffers;
+
+        for (AkUInt32 i = 0; i < 16 && !bTorn; ++i)
+        {
+            if (!pParams->GetSnapshot(snapshot))
+            {
+                ++uNumFallbacks;
+                continue;
+            }
+            ++uNumSnapshots;
+            if (!IsConsistent(snapshot))
+            {
+                fprintf(stderr, "Torn snapshot: gain %f, smoothing %d, smoothing time %f, meter rate %f\n",
+                    snapshot.RTPC.fDummy, snapshot.NonRTPC.bSmoothing ? 1 : 0,
+                    snapshot.NonRTPC.fSmoothingTime, snapshot.NonRTPC.fMeterRate);
+                bTorn = true;
+            }
+
+            ++uNumLookups;
+            if (!FindValidOffset(*pParams))
+                bTorn = true;
+        }
+
+        // A clone shares the table it was made with, which must outlive the writers replacing it
+        if ((uNumBuffers & 3) == 0)
+        {
+            AK::IAkPluginParam* pClone = pParams->Clone(&allocator);
+            if (pClone)
+            {
+                ++uNumClones;
+                std::this_thread::yield();
+                if (!FindValidOffset(*static_cast<WoaGainFXParams*>(pClone)))
+                    bTorn = true;
+                pClone->Term(&allocator);
+            }
+        }
+
+        // The effect must keep producing finite output whatever it reads
+        for (AkUInt32 i = 0; i < buffer.GetNumSamples(); ++i)
+        {
+            if (!isfinite(buffer.GetData()[i]))
+            {
+                fprintf(stderr, "Non-finite output after %llu buffers\n", (unsigned long long)uNumBuffers);
+                bTorn = true;
+                break;
+            }
+        }
+    }
+
+    bStop.store(true, std::memory_order_relaxed);
+    for (std::thread& writer : writers)
+        writer.join();
+    instance.Term();
+
+    printf("writers=%u writes=%llu events=%llu buffers=%llu snapshots=%llu fallbacks=%llu lookups=%llu clones=%llu monitor_posts=%u result=%s\n",
+        uNumWriters, (unsigned long long)uNumWrites.load(), (unsigned long long)uNumEvents.load(), (unsigned long long)uNumBuffers,
+        (unsigned long long)uNumSnapshots, (unsigned long long)uNumFallbacks, (unsigned long long)uNumLookups, (unsigned long long)uNumClones, context.uNumMonitorPosts,
+        bTorn ? "FAIL" : "OK");
+    return bTorn ? 1 : 0;
+}
@@ -0,0 +1,1217 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// WoaGainTests: checks the output and state of WoaGainFX against references, outside of the Wwise
+// runtime. Every test prints one machine-readable line per case, as CSV (default) or JSON lines
+// (--json), and the run fails when any case fails. Tests are registered with CTest one by one.
+//
+// - verify: the output of WoaGainFX::Execute against a double precision reference of the gain law,
+//   across channel layouts, buffer sizes, gains from -96 to +10 dB, gain automation, smoothing
+//   curves and metering, for every instruction set supported by the CPU unless --isa forces one.
+// - timeskip: WoaGainFX::TimeSkip against the processing of the same number of frames of silence,
+//   with skips ending before, during and after parameter ramps and ramps toward gain events.
+// - events: gain events rendered in buffers of several sizes, and after a TimeSkip, against the
+//   render in 1024-frame buffers and the gain of every event at its frame.
+// - batch: WoaGainFX::ExecuteBatch against Execute on instances with mixed paths and metering.
+// - kernels: the buffer kernels of every supported instruction set against the AKSIMD kernels.
+// - levels: the levels read from WoaGainLevelRegistry against the levels of the output of the
+//   instances publishing them, and slots claimed and released under many keys coming back unused.
+// - pool: the memory of instances and parameter node clones back in their allocator once they and
+//   the sound engine are terminated, in either order, pooled slabs included.
+//
+// Usage: WoaGainTests [--json] [--quick] [--isa sse2|avx2|avx512] [test...]
+
+#include "../Host/WoaGainHost.h"
+#include "../Host/WoaGainSignals.h"
+#include "../../SoundEnginePlugin/WoaGainFX.h"
+#include "../../SoundEnginePlugin/WoaGainLevelRegistry.h"
+
+#include <math.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    const AkUInt32 kSampleRate = 48000;
+
+    struct Options
+    {
+        bool bJson;
+        bool bQuick;            ///< Fewer buffers per case
+        const char* szIsa;      ///< Instruction set forced with --isa, nullptr for the CPU's
+        WoaGainDSP::Isa eIsa;   ///< Instruction set of the kernels selected by the instances
+    };
+
+    // Double precision transcription of the gain law of WoaGainFX (StartGainRamp, RampGain and the
+    // ramps of WoaGainDSP::BufferGain), independent of the kernels: the reference of the verify test
+    class ReferenceGain
+    {
+    public:
+        ReferenceGain(bool in_bSmoothing, AkReal32 in_fSmoothingTime, WoaGainDSP::Curve in_eCurve, AkReal32 in_fGainDb)
+            : m_bSmoothing(in_bSmoothing)
+            , m_uSmoothingFrames((AkUInt32)(in_fSmoothingTime * 0.001f * (AkReal32)kSampleRate + 0.5f))
+            , m_eCurve(in_eCurve)
+            , m_fGainDb(in_fGainDb)
+            , m_fGain(ToLinear(in_fGainDb))
+            , m_fTarget(m_fGain)
+            , m_fInc(0.)
+            , m_uRampFrames(0)
+            , m_fPos(0.)
+            , m_fFromDb(0.)
+            , m_fRangeDb(0.)
+        {
+        }
+
+        // Parameter value before a buffer of in_uFrames frames
+        void SetGainDb(AkReal32 in_fGainDb, AkUInt32 in_uFrames)
+        {
+            if (in_fGainDb == m_fGainDb)
+                return;
+            const AkReal64 fFromDb = IsCurveRamping() ? GetCurveDb(m_fPos) : ToRampDb(m_fGain);
+            m_fGainDb = in_fGainDb;
+            m_fTarget = ToLinear(in_fGainDb);
+            const AkUInt32 uRampFrames = m_bSmoothing ? (m_uSmoothingFrames > 0 ? m_uSmoothingFrames : in_uFrames) : 0;
+            if (uRampFrames == 0 || m_fGain == m_fTarget)
+            {
+                m_fGain = m_fTarget;
+                m_uRampFrames = 0;
+                return;
+            }
+            m_uRampFrames = uRampFrames;
+            if (m_eCurve == WoaGainDSP::Curve_Linear)
+            {
+                m_fInc = (m_fTarget - m_fGain) / uRampFrames;
+                return;
+            }
+            m_fPos = 0.;
+            m_fInc = 1. / uRampFrames;
+            m_fFromDb = fFromDb;
+            m_fRangeDb = ToRampDb(m_fTarget) - fFromDb;
+        }
+
+        AkReal64 GetFrameGain(AkUInt32 in_uFrame) const
+        {
+            if (in_uFrame >= m_uRampFrames)
+                return m_fTarget;
+            if (m_eCurve == WoaGainDSP::Curve_Linear)
+                return m_fGain + m_fInc * (in_uFrame + 1);
+            return GetCurveGain(m_fPos + m_fInc * (in_uFrame + 1));
+        }
+
+        // Largest gain of the next in_uFrames frames
+        AkReal64 GetMaxGain() const { return fmax(fabs(m_fGain), fabs(m_fTarget)); }
+        bool IsRamping() const { return m_uRampFrames > 0; }
+        bool IsCurveRamping() const { return m_uRampFrames > 0 && m_eCurve != WoaGainDSP::Curve_Linear; }
+
+        void Advance(AkUInt32 in_uFrames)
+        {
+            const AkUInt32 uRampFrames = m_uRampFrames < in_uFrames ? m_uRampFrames : in_uFrames;
+            m_uRampFrames -= uRampFrames;
+            if (m_uRampFrames == 0)
+            {
+                m_fGain = m_fTarget;
+            }
+            else if (m_eCurve == WoaGainDSP::Curve_Linear)
+            {
+                m_fGain += m_fInc * uRampFrames;
+            }
+            else
+            {
+                m_fPos += m_fInc * uRampFrames;
+                m_fGain = GetCurveGain(m_fPos);
+            }
+        }
+
+        static AkReal64 ToLinear(AkReal32 in_fGainDb) { return in_fGainDb > -96.f ? pow(10., in_fGainDb / 20.) : 0.; }
+
+        // Ramps along dB curves start and end no lower than the -96 dB floor
+        static AkReal64 ToRampDb(AkReal64 in_fGain) { return in_fGain > 0. ? fmax(-96., 20. * log10(in_fGain)) : -96.; }
+
+    private:
+        AkReal64 GetCurveDb(AkReal64 in_fPos) const
+        {
+            const AkReal64 fShape = m_eCurve == WoaGainDSP::Curve_SCurve ? in_fPos * in_fPos * (3. - 2. * in_fPos) : in_fPos;
+            return m_fFromDb + m_fRangeDb * fShape;
+        }
+
+        AkReal64 GetCurveGain(AkReal64 in_fPos) const { return pow(10., GetCurveDb(in_fPos) / 20.); }
+
+        bool m_bSmoothing;
+        AkUInt32 m_uSmoothingFrames;
+        WoaGainDSP::Curve m_eCurve;
+        AkReal32 m_fGainDb;
+        AkReal64 m_fGain;
+        AkReal64 m_fTarget;
+        AkReal64 m_fInc;
+        AkUInt32 m_uRampFrames;
+        AkReal64 m_fPos;
+        AkReal64 m_fFromDb;
+        AkReal64 m_fRangeDb;
+    };
+
+    // Gains of the verify test, in dB: the mute floor, the maximum and values in between
+    const AkReal32 kVerifyGains[] = { -96.f, -40.f, -6.f, 0.f, 6.f, 10.f };
+    const AkUInt32 kNumVerifyGains = sizeof(kVerifyGains) / sizeof(kVerifyGains[0]);
+
+    // Tolerances of the verify test, in ULPs of the input sample times the largest gain of the buffer.
+    // Flat gains take one float multiply by the gain of AK_DBTOLIN, whose float exponent
+    // (dB * 0.05f) is off by up to 8.3 ULPs of the gain toward -96 dB. Ramps also accumulate
+    // the rounding of the ramp start and increment over the buffers of the ramp, up to 9.4 ULPs.
+    const AkReal64 kFlatUlps = 12.;
+    const AkReal64 kRampUlps = 16.;
+
+    // Tolerance of the verify test for ramps along dB curves, in dB: WoaGainDSP::DbToLinFast is within
+    // 0.00065 dB, and ramps restarting during another one start from its exact dB position.
+    const AkReal64 kCurveDb = 0.001;
+
+    struct VerifyConfig
+    {
+        AkUInt32 uNumChannels;
+        AkUInt16 uFrames;
+        AkInt32 iGain;          ///< Index in kVerifyGains for a static gain, -1 for steps, -2 for a sweep
+        bool bSmoothing;
+        AkReal32 fSmoothingTime;
+        WoaGainDSP::Curve eCurve;
+        bool bMetering;
+    };
+
+    AkReal32 GetVerifyGain(AkInt32 in_iGain, AkUInt32 in_uBuffer)
+    {
+        if (in_iGain >= 0)
+            return kVerifyGains[in_iGain];
+        if (in_iGain == -1)
+            return kVerifyGains[(in_uBuffer / 3) % kNumVerifyGains];
+        return fmaxf(-96.f, fminf(10.f, -43.f + 53.f * sinf((AkReal32)in_uBuffer * 0.37f)));
+    }
+
+    const char* GetVerifyGainName(AkInt32 in_iGain)
+    {
+        static char s_szGain[16];
+        if (in_iGain == -1)
+            return "steps";
+        if (in_iGain == -2)
+            return "sweep";
+        snprintf(s_szGain, sizeof(s_szGain), "%+.0fdB", kVerifyGains[in_iGain]);
+        return s_szGain;
+    }
+
+    // Processes in_uNumBuffers buffers of noise with in_config and returns the largest errors of the
+    // output against ReferenceGain, over buffers at a flat gain and over buffers with a linear ramp
+    // in ULPs, and over buffers with a ramp along a dB curve in dB.
+    void Verify(const VerifyConfig& in_config, AkUInt32 in_uNumBuffers, AkReal64& out_fFlatUlps, AkReal64& out_fRampUlps, AkReal64& out_fCurveDb)
+    {
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        context.bCanPostMonitorData = in_config.bMetering;
+
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(in_config.uNumChannels);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_SMOOTHING_ID, in_config.bSmoothing);
+        instance.SetParam(PARAM_SMOOTHING_TIME_ID, in_config.fSmoothingTime);
+        instance.SetParam(PARAM_SMOOTHING_CURVE_ID, (AkInt32)in_config.eCurve);
+        instance.SetParam(PARAM_DUMMY_ID, GetVerifyGain(in_config.iGain, 0));
+        instance.GetEffect()->Reset();
+        ReferenceGain reference(in_config.bSmoothing, in_config.fSmoothingTime, in_config.eCurve, GetVerifyGain(in_config.iGain, 0));
+
+        WoaGainHost::Buffer source, buffer;
+        source.Allocate(channelConfig, in_config.uFrames);
+        buffer.Allocate(channelConfig, in_config.uFrames);
+
+        out_fFlatUlps = 0.;
+        out_fRampUlps = 0.;
+        out_fCurveDb = 0.;
+        for (AkUInt32 uBuffer = 0; uBuffer < in_uNumBuffers; ++uBuffer)
+        {
+            const AkReal32 fGainDb = GetVerifyGain(in_config.iGain, uBuffer);
+            instance.SetParam(PARAM_DUMMY_ID, fGainDb);
+            reference.SetGainDb(fGainDb, in_config.uFrames);
+
+            source.FillNoise(1234 + uBuffer, 0.5f);
+            buffer.CopyFrom(source);
+            instance.Execute(buffer.Get());
+
+            if (reference.IsCurveRamping())
+            {
+                // The fast conversion has a relative error, measured in dB
+                for (AkUInt32 uChannel = 0; uChannel < in_config.uNumChannels; ++uChannel)
+                {
+                    const AkReal32* pIn = source.Get().GetChannel(uChannel);
+                    const AkReal32* pOut = buffer.Get().GetChannel(uChannel);
+                    for (AkUInt32 i = 0; i < in_config.uFrames; ++i)
+                    {
+                        const AkReal64 fExpected = pIn[i] * reference.GetFrameGain(i);
+                        if (fExpected == 0. && pOut[i] == 0.f)
+                            continue;
+                        const AkReal64 fErrorDb = fExpected != 0. && pOut[i] != 0.f ? fabs(20. * log10(pOut[i] / fExpected)) : INFINITY;
+                        if (fErrorDb > out_fCurveDb)
+                            out_fCurveDb = fErrorDb;
+                    }
+                }
+                reference.Advance(in_config.uFrames);
+                continue;
+            }
+
+            // Errors are scaled by the ULP of the input sample times the largest gain of the buffer,
+            // so that a ramp toward the mute floor is not held to the ULP of vanishing outputs
+            const AkReal64 fUlpScale = ldexp(reference.GetMaxGain(), -24);
+            AkReal64& fMaxUlps = reference.IsRamping() ? out_fRampUlps : out_fFlatUlps;
+            for (AkUInt32 uChannel = 0; uChannel < in_config.uNumChannels; ++uChannel)
+            {
+                const AkReal32* pIn = source.Get().GetChannel(uChannel);
+                const AkReal32* pOut = buffer.Get().GetChannel(uChannel);
+                for (AkUInt32 i = 0; i < in_config.uFrames; ++i)
+                {
+                    const AkReal64 fError = fabs((AkReal64)pOut[i] - pIn[i] * reference.GetFrameGain(i));
+                    if (fError > 0.)
+                    {
+                        // Any difference where the reference is exact, e.g. at the mute floor, is a failure
+                        const AkReal64 fUlps = fUlpScale > 0. ? fError / (fUlpScale * fabs(pIn[i])) : INFINITY;
+                        if (fUlps > fMaxUlps)
+                            fMaxUlps = fUlps;
+                    }
+                }
+            }
+            reference.Advance(in_config.uFrames);
+        }
+        instance.Term();
+    }
+
+    // Frames of the 50 ms ramps of the timeskip test at kSampleRate
+    const AkUInt32 kTimeSkipRampFrames = 2400;
+    // Smallest change of the gain within a buffer taken for a ramp in progress
+    const AkReal64 kTimeSkipRampingDb = 0.01;
+
+    struct TimeSkipResult
+    {
+        bool bMatch;    ///< Same output after the skip as after processing silence
+        bool bRamping;  ///< The gain changed within the buffer processed after the skip
+    };
+
+    // Skipping in_uSkipFrames frames then processing a buffer must give the same output as
+    // processing in_uSkipFrames frames of silence, one buffer at a time, then the same buffer. The
+    // gain goes from -6 to -20 dB at the start of the skipped frames, as a parameter change, or as
+    // a gain event at frame in_uEventFrame of the skipped frames when not 0. The buffer after the
+    // skip is a constant 1, so that its output is the gain of every frame.
+    TimeSkipResult CheckTimeSkip(AkUInt32 in_uNumChannels, AkUInt16 in_uFrames, AkUInt32 in_uSkipFrames, AkReal32 in_fSmoothingTime, AkInt32 in_iCurve, AkUInt32 in_uEventFrame)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(in_uNumChannels);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+
+        WoaGainHost::Allocator allocators[2];
+        WoaGainHost::EffectContext contexts[2];
+        WoaGainHost::Instance instances[2];
+        WoaGainHost::Buffer outputs[2];
+        for (AkUInt32 i = 0; i < 2; ++i)
+        {
+            contexts[i].bCanPostMonitorData = true;
+            instances[i].Init(allocators[i], contexts[i], format);
+            instances[i].SetParam(PARAM_SMOOTHING_TIME_ID, in_fSmoothingTime);
+            instances[i].SetParam(PARAM_SMOOTHING_CURVE_ID, in_iCurve);
+            outputs[i].Allocate(channelConfig, in_uFrames);
+            outputs[i].FillNoise(1234, 0.5f);
+
+            // Settle on -6 dB, then move to -20 dB from the start of the skipped frames
+            instances[i].SetParam(PARAM_DUMMY_ID, -6.f);
+            instances[i].Execute(outputs[i].Get());
+            for (AkUInt32 uFrame = in_uFrames; uFrame < 2 * kTimeSkipRampFrames; uFrame += in_uFrames)
+                instances[i].Execute(outputs[i].Get());
+            for (AkUInt32 uSample = 0; uSample < outputs[i].GetNumSamples(); ++uSample)
+                outputs[i].GetData()[uSample] = 1.f;
+            if (in_uEventFrame > 0)
+                static_cast<WoaGainFXParams*>(instances[i].GetParams())->PostGainEvent(in_uEventFrame, -20.f);
+            else
+                instances[i].SetParam(PARAM_DUMMY_ID, -20.f);
+        }
+
+        instances[0].TimeSkip(in_uSkipFrames);
+
+        WoaGainHost::Buffer silence;
+        silence.Allocate(channelConfig, in_uFrames);
+        for (AkUInt32 uFrame = 0; uFrame < in_uSkipFrames; uFrame += in_uFrames)
+        {
+            silence.FillNoise(1, 0.f);
+            silence.Get().uValidFrames = (AkUInt16)(in_uSkipFrames - uFrame < in_uFrames ? in_uSkipFrames - uFrame : in_uFrames);
+            instances[1].Execute(silence.Get());
+        }
+
+        instances[0].Execute(outputs[0].Get());
+        instances[1].Execute(outputs[1].Get());
+
+        // The ramp advances in one step instead of one step per buffer, which only changes the rounding
+        TimeSkipResult result = { true, false };
+        AkReal32 fMinGain = outputs[1].GetData()[0];
+        AkReal32 fMaxGain = fMinGain;
+        for (AkUInt32 i = 0; i < outputs[0].GetNumSamples(); ++i)
+        {
+            const AkReal32 fSkipped = outputs[0].GetData()[i];
+            const AkReal32 fProcessed = outputs[1].GetData()[i];
+            if (fabsf(fSkipped - fProcessed) > 1e-5f * fabsf(fProcessed) + 1e-9f)
+                result.bMatch = false;
+            fMinGain = fProcessed < fMinGain ? fProcessed : fMinGain;
+            fMaxGain = fProcessed > fMaxGain ? fProcessed : fMaxGain;
+        }
+
+        // dB ramps land on their target with the rounding of WoaGainDSP::DbToLinFast, well below this
+        result.bRamping = 20. * log10((AkReal64)fMaxGain / (AkReal64)fMinGain) > kTimeSkipRampingDb;
+
+        instances[0].Term();
+        instances[1].Term();
+        return result;
+    }
+
+    // Frames processed before the gain change of the smoothing test, rounded up to whole buffers, for
+    // the auto-gain to measure its first blocks and move its correction
+    const AkUInt32 kSmoothingStartFrames = kSampleRate;
+
+    struct SmoothingResult
+    {
+        AkReal64 fMaxDiffDb;            ///< Largest difference from the reference ramp
+        AkReal64 fCorrectionSpanDb;     ///< Change of the auto-gain correction over the ramp
+    };
+
+    // With auto-gain enabled, a change from -6 to -20 dB must still ramp over the 50 ms of the
+    // smoothing time along in_iCurve, whatever the correction updates during the ramp, as a parameter
+    // change or as a gain event 50 ms ahead when in_bEvent. A second instance processes the same
+    // noise without the change, so that it applies the same correction: the ratio of the outputs is
+    // the gain ramp, compared with the reference of the verify test.
+    SmoothingResult CheckSmoothing(AkUInt16 in_uFrames, AkInt32 in_iCurve, bool in_bEvent)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+
+        WoaGainHost::Allocator allocators[2];
+        WoaGainHost::EffectContext contexts[2];
+        WoaGainHost::Instance instances[2];
+        WoaGainHost::Buffer outputs[2];
+        WoaGainHost::Buffer input;
+        input.Allocate(channelConfig, in_uFrames);
+        input.FillNoise(1234, 0.5f);
+        for (AkUInt32 i = 0; i < 2; ++i)
+        {
+            instances[i].Init(allocators[i], contexts[i], format);
+            instances[i].SetParam(PARAM_SMOOTHING_TIME_ID, 50.f);
+            instances[i].SetParam(PARAM_SMOOTHING_CURVE_ID, in_iCurve);
+            instances[i].SetParam(PARAM_AUTO_GAIN_ID, true);
+            instances[i].SetParam(PARAM_DUMMY_ID, -6.f);
+            outputs[i].Allocate(channelConfig, in_uFrames);
+        }
+
+        ReferenceGain reference(true, 50.f, (WoaGainDSP::Curve)in_iCurve, -6.f);
+        const AkReal64 fFlatGain = ReferenceGain::ToLinear(-6.f);
+        SmoothingResult result = { 0., 0. };
+        AkReal64 fMinCorrection = INFINITY;
+        AkReal64 fMaxCorrection = 0.;
+        const AkUInt32 uChangeFrame = (kSmoothingStartFrames + in_uFrames - 1) / in_uFrames * in_uFrames;
+        const AkUInt32 uEndFrame = uChangeFrame + 2 * kTimeSkipRampFrames;
+        for (AkUInt32 uFrame = 0; uFrame < uEndFrame; uFrame += in_uFrames)
+        {
+            if (uFrame == uChangeFrame)
+            {
+                // The ramp toward an event spans the frames up to its frame, included
+                if (in_bEvent)
+                    static_cast<WoaGainFXParams*>(instances[0].GetParams())->PostGainEvent(kTimeSkipRampFrames - 1, -20.f);
+                else
+                    instances[0].SetParam(PARAM_DUMMY_ID, -20.f);
+                reference.SetGainDb(-20.f, in_uFrames);
+            }
+            for (AkUInt32 i = 0; i < 2; ++i)
+            {
+                outputs[i].CopyFrom(input);
+                instances[i].Execute(outputs[i].Get());
+            }
+            if (uFrame < uChangeFrame)
+                continue;
+
+            // Channels follow each other in the buffer
+            for (AkUInt32 i = 0; i < outputs[0].GetNumSamples(); ++i)
+            {
+                const AkReal64 fIn = input.GetData()[i];
+                const AkReal64 fUnchanged = outputs[1].GetData()[i];
+                if (fabs(fIn) < 1e-3)
+                    continue;
+                const AkReal64 fGain = reference.GetFrameGain(i % in_uFrames) / fFlatGain;
+                result.fMaxDiffDb = fmax(result.fMaxDiffDb, fabs(20. * log10(outputs[0].GetData()[i] / fUnchanged / fGain)));
+                if (uFrame < uChangeFrame + kTimeSkipRampFrames)
+                {
+                    fMinCorrection = fmin(fMinCorrection, fUnchanged / (fIn * fFlatGain));
+                    fMaxCorrection = fmax(fMaxCorrection, fUnchanged / (fIn * fFlatGain));
+                }
+            }
+            reference.Advance(in_uFrames);
+        }
+        result.fCorrectionSpanDb = 20. * log10(fMaxCorrection / fMinCorrection);
+
+        instances[0].Term();
+        instances[1].Term();
+        return result;
+    }
+
+    WoaGainFX* GetFX(WoaGainHost::Instance& in_instance)
+    {
+        return static_cast<WoaGainFX*>(in_instance.GetEffect());
+    }
+
+    // Processing buffers with ExecuteBatch must give the same output and paths as with Execute,
+    // on instances mixing channel counts, metering and every gain path
+    bool CheckBatch(AkUInt32 in_uNumInstances, AkUInt16 in_uFrames, AkUInt32 in_uNumBuffers)
+    {
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext contexts[2];
+        contexts[1].bCanPostMonitorData = true;
+
+        const AkUInt32 uNumSets = 2 * in_uNumInstances;
+        std::unique_ptr<WoaGainHost::Instance[]> instances(new WoaGainHost::Instance[uNumSets]);
+        std::unique_ptr<WoaGainHost::Buffer[]> buffers(new WoaGainHost::Buffer[uNumSets]);
+        std::unique_ptr<WoaGainFX*[]> batchFX(new WoaGainFX*[in_uNumInstances]);
+        std::unique_ptr<AkAudioBuffer*[]> batchBuffers(new AkAudioBuffer*[in_uNumInstances]);
+        for (AkUInt32 i = 0; i < uNumSets; ++i)
+        {
+            // Instance i is processed with Execute, instance i + in_uNumInstances with ExecuteBatch
+            const AkUInt32 uVoice = i % in_uNumInstances;
+            const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(uVoice % 3 == 0 ? 2 : 1);
+            AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+            instances[i].Init(allocator, contexts[uVoice % 5 == 0 ? 1 : 0], format);
+            buffers[i].Allocate(channelConfig, in_uFrames);
+        }
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            batchFX[i] = GetFX(instances[in_uNumInstances + i]);
+            batchBuffers[i] = &buffers[in_uNumInstances + i].Get();
+        }
+
+        bool bMatch = true;
+        for (AkUInt32 uBuffer = 0; uBuffer < in_uNumBuffers; ++uBuffer)
+        {
+            for (AkUInt32 i = 0; i < uNumSets; ++i)
+            {
+                const AkUInt32 uVoice = i % in_uNumInstances;
+                instances[i].SetParam(PARAM_DUMMY_ID, WoaGainSignals::GetAutomatedGain((WoaGainSignals::Automation)(uVoice % WoaGainSignals::Automation_Count), uBuffer));
+                buffers[i].FillNoise(uVoice * 31 + uBuffer, 0.5f);
+            }
+
+            for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+                instances[i].Execute(buffers[i].Get());
+            WoaGainFX::ExecuteBatch(batchFX.get(), batchBuffers.get(), in_uNumInstances);
+
+            for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+            {
+                WoaGainHost::Buffer& executed = buffers[i];
+                WoaGainHost::Buffer& batched = buffers[in_uNumInstances + i];
+                if (memcmp(executed.GetData(), batched.GetData(), executed.GetNumSamples() * sizeof(AkReal32)) != 0)
+                    bMatch = false;
+            }
+        }
+
+        for (AkUInt32 i = 0; i < in_uNumInstances; ++i)
+        {
+            for (AkUInt32 uPath = 0; uPath < WoaGainDSP::Path_Count; ++uPath)
+            {
+                if (GetFX(instances[i])->GetPathCount((WoaGainDSP::Path)uPath) != batchFX[i]->GetPathCount((WoaGainDSP::Path)uPath))
+                    bMatch = false;
+            }
+        }
+
+        for (AkUInt32 i = 0; i < uNumSets; ++i)
+            instances[i].Term();
+        return bMatch;
+    }
+
+    // Gain events of the events test, in frames from the start of the first buffer
+    const WoaGainEvent kCheckEvents[] = {
+        { 1000, -12.f },    // Ramp from the initial 0 dB
+        { 1500, -12.f },    // Hold
+        { 4000, 0.f },
+        { 4001, -30.f },    // Step on the next frame
+        { 9000, -6.f },
+    };
+    const AkUInt32 kEventCheckFrames = 12000;
+
+    // Renders kEventCheckFrames frames of a constant input of 1, so that the output is the gain of
+    // every frame, with the events of kCheckEvents posted before the first buffer. The first
+    // in_uSkipFrames frames are skipped with TimeSkip, then processed in buffers of in_uFrames.
+    void RenderEvents(AkUInt16 in_uFrames, AkInt32 in_iCurve, bool in_bMetering, AkUInt32 in_uSkipFrames, std::vector<AkReal32>& out_gains)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(1);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        context.bCanPostMonitorData = in_bMetering;
+        WoaGainHost::Instance instance;
+        instance.Init(allocator, context, format);
+        instance.SetParam(PARAM_SMOOTHING_CURVE_ID, in_iCurve);
+        WoaGainFXParams* pParams = static_cast<WoaGainFXParams*>(instance.GetParams());
+        for (const WoaGainEvent& event : kCheckEvents)
+            pParams->PostGainEvent(event.uFrame, event.fGainDb);
+
+        WoaGainHost::Buffer buffer;
+        buffer.Allocate(channelConfig, in_uFrames);
+        out_gains.assign(kEventCheckFrames, 0.f);
+        if (in_uSkipFrames > 0)
+            instance.TimeSkip(in_uSkipFrames);
+        for (AkUInt32 uFrame = in_uSkipFrames; uFrame < kEventCheckFrames; uFrame += in_uFrames)
+        {
+            const AkUInt32 uFrames = kEventCheckFrames - uFrame < in_uFrames ? kEventCheckFrames - uFrame : in_uFrames;
+            for (AkUInt32 i = 0; i < uFrames; ++i)
+                buffer.GetData()[i] = 1.f;
+            buffer.Get().uValidFrames = (AkUInt16)uFrames;
+            instance.Execute(buffer.Get());
+            memcpy(&out_gains[uFrame], buffer.GetData(), uFrames * sizeof(AkReal32));
+        }
+        instance.Term();
+    }
+
+    // Largest difference in dB between two renders of RenderEvents, from in_uFirst on
+    AkReal64 GetGainDifferenceDb(const std::vector<AkReal32>& in_gains, const std::vector<AkReal32>& in_reference, AkUInt32 in_uFirst)
+    {
+        AkReal64 fMaxDb = 0.;
+        for (AkUInt32 i = in_uFirst; i < kEventCheckFrames; ++i)
+            fMaxDb = fmax(fMaxDb, fabs(20. * log10((AkReal64)in_gains[i] / in_reference[i])));
+        return fMaxDb;
+    }
+
+    // Largest difference in dB between the gain at the frame of every event and the gain of the event
+    AkReal64 GetEventErrorDb(const std::vector<AkReal32>& in_gains)
+    {
+        AkReal64 fMaxDb = 0.;
+        for (const WoaGainEvent& event : kCheckEvents)
+            fMaxDb = fmax(fMaxDb, fabs(20. * log10((AkReal64)in_gains[event.uFrame]) - event.fGainDb));
+        return fMaxDb;
+    }
+
+    // Relative difference of two sums of squares of in_uFrames samples, each within
+    // (in_uFrames / 8 + 3) * 2^-24 of the exact sum, see WoaGainDSP.h
+    bool SumsMatch(AkReal32 in_fA, AkReal32 in_fB, AkUInt32 in_uFrames)
+    {
+        const AkReal64 fBound = 2. * (in_uFrames / 8 + 3) * pow(2., -24.);
+        return fabs((AkReal64)in_fA - in_fB) <= fBound * fmax(fabs(in_fA), fabs(in_fB));
+    }
+
+    // Processes the same noise with the kernel of in_eIsa and the AKSIMD kernel, a few buffers in a
+    // row so that the meters accumulate, and compares them. The last two buffers also scale the
+    // ramps, as WoaGainFX does with the auto-gain correction.
+    bool CheckKernel(WoaGainDSP::Isa in_eIsa, AkUInt32 in_uNumChannels, AkUInt16 in_uFrames, bool in_bMetering, WoaGainSignals::KernelGain in_eGain)
+    {
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(in_uNumChannels);
+        const WoaGainDSP::ProcessFunc fnProcess = WoaGainDSP::GetProcessFunc(in_uNumChannels, in_bMetering, in_eIsa);
+        const WoaGainDSP::ProcessFunc fnBaseline = WoaGainDSP::GetProcessFunc(in_uNumChannels, in_bMetering, WoaGainDSP::Isa_Baseline);
+        std::vector<WoaGainDSP::ChannelMeter> meters(in_uNumChannels), baselineMeters(in_uNumChannels);
+        WoaGainHost::Buffer buffer, baseline;
+        buffer.Allocate(channelConfig, in_uFrames);
+        baseline.Allocate(channelConfig, in_uFrames);
+        for (AkUInt32 uBuffer = 0; uBuffer < 4; ++uBuffer)
+        {
+            buffer.FillNoise(uBuffer + 1, 0.5f);
+            baseline.CopyFrom(buffer);
+            WoaGainDSP::BufferGain gain = WoaGainSignals::MakeKernelGain(in_eGain, in_uFrames, (uBuffer & 1) == 0);
+            if (uBuffer >= 2 && gain.uRampFrames > 0)
+            {
+                gain.fScaleStart = 0.8f;
+                gain.fScaleInc = 0.4f / (AkReal32)in_uFrames;
+            }
+            fnProcess(&buffer.Get(), gain, meters.data());
+            fnBaseline(&baseline.Get(), gain, baselineMeters.data());
+            if (memcmp(buffer.GetData(), baseline.GetData(), buffer.GetNumSamples() * sizeof(AkReal32)) != 0)
+                return false;
+        }
+
+        const AkUInt32 uMeteredFrames = 4 * in_uFrames;
+        for (AkUInt32 i = 0; in_bMetering && i < in_uNumChannels; ++i)
+        {
+            const WoaGainDSP::ChannelMeter& meter = meters[i];
+            const WoaGainDSP::ChannelMeter& expected = baselineMeters[i];
+            if (meter.in.fPeak != expected.in.fPeak || meter.out.fPeak != expected.out.fPeak ||
+                !SumsMatch(meter.in.fSumSq, expected.in.fSumSq, uMeteredFrames) ||
+                !SumsMatch(meter.out.fSumSq, expected.out.fSumSq, uMeteredFrames))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Keys of the levels test
+    const AkUInt32 kLevelKey = 1001;
+    const AkUInt32 kOtherLevelKey = 1002;
+    const AkUInt32 kChurnFirstKey = 100000;   ///< First of the keys claimed by CheckChurn, one per slot and round
+
+    // Largest difference between a level read from WoaGainLevelRegistry and the level of the output:
+    // half a step of the quantization, plus the float sums of the meters
+    const AkReal64 kLevelDb = 0.005;
+
+    // Sums of the squares and peak of the samples of a buffer
+    void AddBufferLevel(WoaGainHost::Buffer& in_buffer, AkReal64& io_fSumSq, AkReal64& io_fPeak)
+    {
+        const AkReal32* pData = in_buffer.GetData();
+        for (AkUInt32 i = 0; i < in_buffer.GetNumSamples(); ++i)
+        {
+            io_fSumSq += (AkReal64)pData[i] * pData[i];
+            io_fPeak = fmax(io_fPeak, fabs((AkReal64)pData[i]));
+        }
+    }
+
+    bool LevelsMatch(AkReal64 in_fDb, AkReal64 in_fExpectedDb)
+    {
+        return in_fDb == in_fExpectedDb || fabs(in_fDb - in_fExpectedDb) <= kLevelDb;
+    }
+
+    // Reads the level published under in_uKey, compares it with in_uPublishers publishers of mean
+    // square in_fPower and peak in_fPeak, none expecting no level, and prints the comparison as one
+    // line named in_szStep. Returns whether they match.
+    bool CheckLevel(bool in_bJson, const char* in_szStep, AkUInt32 in_uKey, AkUInt32 in_uPublishers, AkReal64 in_fPower, AkReal64 in_fPeak)
+    {
+        WoaGainLevelRegistry::Level level = { -INFINITY, -INFINITY, 0 };
+        const bool bFound = WoaGainLevelRegistry::Read(in_uKey, level);
+        const AkReal64 fRmsDb = in_uPublishers > 0 && in_fPower > 0. ? 10. * log10(in_fPower) : -INFINITY;
+        const AkReal64 fPeakDb = in_uPublishers > 0 && in_fPeak > 0. ? 20. * log10(in_fPeak) : -INFINITY;
+        const bool bPassed = bFound == (in_uPublishers > 0) && level.uPublishers == in_uPublishers &&
+            LevelsMatch(level.fRmsDb, fRmsDb) && LevelsMatch(level.fPeakDb, fPeakDb);
+        if (in_bJson)
+        {
+            printf("{\"step\":\"%s\",\"publishers\":%u,\"rms_db\":%.4f,\"expected_rms_db\":%.4f,\"peak_db\":%.4f,\"expected_peak_db\":%.4f,\"result\":\"%s\"}\n",
+                in_szStep, level.uPublishers, level.fRmsDb, fRmsDb, level.fPeakDb, fPeakDb, bPassed ? "ok" : "fail");
+        }
+        else
+        {
+            printf("%s,%u,%.4f,%.4f,%.4f,%.4f,%s\n", in_szStep, level.uPublishers, level.fRmsDb, fRmsDb, level.fPeakDb, fPeakDb, bPassed ? "ok" : "fail");
+        }
+        return bPassed;
+    }
+
+    // Publishes the levels of two stereo instances under the keys of the levels test as they turn it on,
+    // share a key, move to another, skip frames and stop, and checks what is read at every step
+    // against the levels of their output. The first instance is not monitored, the second one is
+    // and must keep posting its monitor data. Returns the number of failed checks.
+    AkUInt32 CheckLevels(bool in_bJson)
+    {
+        const AkUInt16 uFrames = 256;
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext contextA, contextB;
+        contextB.bCanPostMonitorData = true;
+        WoaGainHost::Instance a, b;
+        a.Init(allocator, contextA, format);
+        b.Init(allocator, contextB, format);
+        a.SetParam(PARAM_DUMMY_ID, -6.f);
+        b.SetParam(PARAM_DUMMY_ID, -12.f);
+        a.SetParam(PARAM_METER_RATE_ID, 0.f);
+        b.SetParam(PARAM_METER_RATE_ID, 0.f);
+        a.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)kLevelKey);
+
+        WoaGainHost::Buffer bufferA, bufferB;
+        bufferA.Allocate(channelConfig, uFrames);
+        bufferB.Allocate(channelConfig, uFrames);
+        const AkReal64 fSamples = (AkReal64)bufferA.GetNumSamples();
+        AkUInt32 uSeed = 1;
+        AkReal64 fSumSqA, fPeakA, fSumSqB, fPeakB;
+        auto process = [&]()
+        {
+            bufferA.FillNoise(uSeed++, 0.5f);
+            bufferB.FillNoise(uSeed++, 0.25f);
+            a.Execute(bufferA.Get());
+            b.Execute(bufferB.Get());
+            fSumSqA = fPeakA = fSumSqB = fPeakB = 0.;
+            AddBufferLevel(bufferA, fSumSqA, fPeakA);
+            AddBufferLevel(bufferB, fSumSqB, fPeakB);
+        };
+
+        AkUInt32 uNumFailed = 0;
+        process();
+        uNumFailed += CheckLevel(in_bJson, "one", kLevelKey, 1, fSumSqA / fSamples, fPeakA) ? 0 : 1;
+
+        b.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)kLevelKey);
+        const AkUInt32 uMonitorPosts = contextB.uNumMonitorPosts;
+        process();
+        uNumFailed += CheckLevel(in_bJson, "shared", kLevelKey, 2, (fSumSqA + fSumSqB) / fSamples, fmax(fPeakA, fPeakB)) ? 0 : 1;
+        uNumFailed += contextB.uNumMonitorPosts > uMonitorPosts ? 0 : 1;
+
+        b.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)kOtherLevelKey);
+        process();
+        uNumFailed += CheckLevel(in_bJson, "moved", kLevelKey, 1, fSumSqA / fSamples, fPeakA) ? 0 : 1;
+        uNumFailed += CheckLevel(in_bJson, "moved_other", kOtherLevelKey, 1, fSumSqB / fSamples, fPeakB) ? 0 : 1;
+
+        // Levels are published at the meter rate: 30 Hz is every 7 buffers at 48 kHz
+        a.SetParam(PARAM_METER_RATE_ID, 30.f);
+        AkReal64 fSumSqInterval = 0., fPeakInterval = 0.;
+        for (AkUInt32 i = 0; i < 7; ++i)
+        {
+            process();
+            AddBufferLevel(bufferA, fSumSqInterval, fPeakInterval);
+        }
+        uNumFailed += CheckLevel(in_bJson, "interval", kLevelKey, 1, fSumSqInterval / (7. * fSamples), fPeakInterval) ? 0 : 1;
+
+        b.TimeSkip(uFrames);
+        uNumFailed += CheckLevel(in_bJson, "skipped", kOtherLevelKey, 1, 0., 0.) ? 0 : 1;
+
+        a.Term();
+        uNumFailed += CheckLevel(in_bJson, "terminated", kLevelKey, 0, 0., 0.) ? 0 : 1;
+
+        b.SetParam(PARAM_LEVEL_KEY_ID, (AkInt32)0);
+        b.Execute(bufferB.Get());
+        uNumFailed += CheckLevel(in_bJson, "off", kOtherLevelKey, 0, 0., 0.) ? 0 : 1;
+        b.Term();
+        return uNumFailed;
+    }
+
+    // Claims half of the slots of the registry under new keys round after round, as publishers
+    // under many keys come and go, and gives them back in the order they were claimed, the last
+    // one after its level is read behind the tombstones of the others. Every released slot must
+    // become unused again, so that the registry ends with no slot used. Returns the number of
+    // failed checks.
+    AkUInt32 CheckChurn(bool in_bJson)
+    {
+        const AkUInt32 kNumRounds = 64;
+        const AkUInt32 kSlotsPerRound = WoaGainLevelRegistry::MaxSlots / 2;
+        const AkReal32 fMeanSquare = 0.25f;
+        const AkReal32 fPeak = 0.5f;
+        AkUInt32 uNumFailed = 0;
+        AkUInt32 slots[kSlotsPerRound];
+        for (AkUInt32 uRound = 0; uRound < kNumRounds; ++uRound)
+        {
+            const AkUInt32 uFirstKey = kChurnFirstKey + uRound * kSlotsPerRound;
+            for (AkUInt32 i = 0; i < kSlotsPerRound; ++i)
+            {
+                slots[i] = WoaGainLevelRegistry::Acquire(uFirstKey + i);
+                uNumFailed += slots[i] != WoaGainLevelRegistry::InvalidSlot ? 0 : 1;
+            }
+            const AkUInt32 uLast = kSlotsPerRound - 1;
+            WoaGainLevelRegistry::Publish(slots[uLast], fMeanSquare, fPeak);
+            for (AkUInt32 i = 0; i < uLast; ++i)
+                WoaGainLevelRegistry::Release(slots[i]);
+            if (uRound == kNumRounds - 1)
+                uNumFailed += CheckLevel(in_bJson, "churn", uFirstKey + uLast, 1, fMeanSquare, fPeak) ? 0 : 1;
+            WoaGainLevelRegistry::Release(slots[uLast]);
+        }
+
+        const AkUInt32 uNumUsedSlots = WoaGainLevelRegistry::GetNumUsedSlots();
+        if (uNumUsedSlots != 0)
+        {
+            fprintf(stderr, "%u level registry slots still used after the churn\n", uNumUsedSlots);
+            ++uNumFailed;
+        }
+        return uNumFailed;
+    }
+
+    AkUInt32 TestVerify(const Options& in_options)
+    {
+        // Odd sizes exercise the scalar head and tail of the kernels around their vector body
+        static const AkUInt32 kVerifyChannels[] = { 1, 2, 6, 8, 12, 16 };
+        static const AkUInt16 kVerifyFrames[] = { 1, 17, 64, 256, 1023, 4096 };
+        static const AkReal32 kSmoothingTimes[] = { -1.f, 0.f, 50.f };     // Off, over one buffer, 50 ms
+        const AkUInt32 uNumBuffers = in_options.bQuick ? 12 : 48;
+
+        // Every supported instruction set, from the AKSIMD kernels, unless one is forced
+        const AkInt32 iFirstIsa = in_options.szIsa ? in_options.eIsa : WoaGainDSP::Isa_Baseline;
+        const AkInt32 iLastIsa = in_options.szIsa ? in_options.eIsa : WoaGainDSP::GetSupportedIsa();
+
+        AkUInt32 uNumFailed = 0;
+        if (!in_options.bJson)
+            printf("isa,channels,frames,gain,flat_ulps,ramp_ulps,curve_db,result\n");
+        for (AkInt32 iIsa = iFirstIsa; iIsa <= iLastIsa; ++iIsa)
+        {
+            WoaGainDSP::SetIsa((WoaGainDSP::Isa)iIsa);
+            const char* szIsaName = WoaGainDSP::GetIsaName((WoaGainDSP::Isa)iIsa);
+            for (AkUInt32 uChannels : kVerifyChannels)
+            {
+                for (AkUInt16 uFrames : kVerifyFrames)
+                {
+                    for (AkInt32 iGain = -2; iGain < (AkInt32)kNumVerifyGains; ++iGain)
+                    {
+                        // Worst errors over smoothing, curves and metering. Without smoothing, the curve makes no difference.
+                        AkReal64 fFlatUlps = 0.;
+                        AkReal64 fRampUlps = 0.;
+                        AkReal64 fCurveDb = 0.;
+                        for (AkReal32 fSmoothingTime : kSmoothingTimes)
+                        {
+                            const AkInt32 iNumCurves = fSmoothingTime >= 0.f ? WoaGainDSP::Curve_Count : 1;
+                            for (AkInt32 iCurve = 0; iCurve < iNumCurves; ++iCurve)
+                            {
+                                for (int iMetering = 0; iMetering < 2; ++iMetering)
+                                {
+                                    VerifyConfig config;
+                                    config.uNumChannels = uChannels;
+                                    config.uFrames = uFrames;
+                                    config.iGain = iGain;
+                                    config.bSmoothing = fSmoothingTime >= 0.f;
+                                    config.fSmoothingTime = fSmoothingTime >= 0.f ? fSmoothingTime : 0.f;
+                                    config.eCurve = (WoaGainDSP::Curve)iCurve;
+                                    config.bMetering = iMetering != 0;
+
+                                    AkReal64 fConfigFlatUlps, fConfigRampUlps, fConfigCurveDb;
+                                    Verify(config, uNumBuffers, fConfigFlatUlps, fConfigRampUlps, fConfigCurveDb);
+                                    if (fConfigFlatUlps > kFlatUlps || fConfigRampUlps > kRampUlps || fConfigCurveDb > kCurveDb)
+                                    {
+                                        fprintf(stderr, "Output mismatch: %s, %u channels, %u frames, gain %s, smoothing %.0f ms, curve %d, metering %d: %.2f flat, %.2f ramp ULPs, %.5f curve dB\n",
+                                            szIsaName, uChannels, uFrames, GetVerifyGainName(iGain), fSmoothingTime, iCurve, iMetering, fConfigFlatUlps, fConfigRampUlps, fConfigCurveDb);
+                                    }
+                                    fFlatUlps = fmax(fFlatUlps, fConfigFlatUlps);
+                                    fRampUlps = fmax(fRampUlps, fConfigRampUlps);
+                                    fCurveDb = fmax(fCurveDb, fConfigCurveDb);
+                                }
+                            }
+                        }
+
+                        const bool bPassed = fFlatUlps <= kFlatUlps && fRampUlps <= kRampUlps && fCurveDb <= kCurveDb;
+                        uNumFailed += bPassed ? 0 : 1;
+                        if (in_options.bJson)
+                        {
+                            printf("{\"isa\":\"%s\",\"channels\":%u,\"frames\":%u,\"gain\":\"%s\",\"flat_ulps\":%.2f,\"ramp_ulps\":%.2f,\"curve_db\":%.5f,\"result\":\"%s\"}\n",
+                                szIsaName, uChannels, uFrames, GetVerifyGainName(iGain), fFlatUlps, fRampUlps, fCurveDb, bPassed ? "ok" : "fail");
+                        }
+                        else
+                        {
+                            printf("%s,%u,%u,%s,%.2f,%.2f,%.5f,%s\n", szIsaName, uChannels, uFrames, GetVerifyGainName(iGain), fFlatUlps, fRampUlps, fCurveDb, bPassed ? "ok" : "fail");
+                        }
+                    }
+                }
+            }
+        }
+        fflush(stdout);
+        if (uNumFailed > 0)
+            fprintf(stderr, "%u configurations above %.0f flat or %.0f ramp ULPs or %.3f curve dB\n", uNumFailed, kFlatUlps, kRampUlps, kCurveDb);
+        return uNumFailed;
+    }
+
+    AkUInt32 TestTimeSkip(const Options& in_options)
+    {
+        // Skips ending before, inside, across the end of and after the ramp, with smoothing over
+        // one buffer or 50 ms, then with the ramp toward a gain event pending at the end of the skip
+        struct Case
+        {
+            AkUInt32 uSkipFrames;
+            AkReal32 fSmoothingTime;
+            AkUInt32 uEventFrame;
+        };
+        static const Case kCases[] = {
+            { 100, 0.f, 0 }, { 1000, 0.f, 0 }, { 2400, 0.f, 0 }, { 10000, 0.f, 0 },
+            { 100, 50.f, 0 }, { 1000, 50.f, 0 }, { 2300, 50.f, 0 }, { 2400, 50.f, 0 }, { 10000, 50.f, 0 },
+            { 1000, 50.f, 3000 }, { 2900, 50.f, 3000 }, { 3000, 50.f, 3000 }, { 10000, 50.f, 3000 },
+        };
+        const AkUInt16 uFrames = 256;
+
+        AkUInt32 uNumFailed = 0;
+        if (!in_options.bJson)
+            printf("skip_frames,smoothing_ms,event_frame,curve,ramping,result\n");
+        for (const Case& testCase : kCases)
+        {
+            // The buffer after the skip must still be ramping when the ramp ends after its first frame
+            const AkUInt32 uRampEnd = testCase.uEventFrame > 0 ? testCase.uEventFrame
+                : testCase.fSmoothingTime > 0.f ? kTimeSkipRampFrames : 0;
+            const bool bExpectRamping = uRampEnd > testCase.uSkipFrames + 1;
+            for (AkInt32 iCurve = 0; iCurve < WoaGainDSP::Curve_Count; ++iCurve)
+            {
+                const TimeSkipResult result = CheckTimeSkip(2, uFrames, testCase.uSkipFrames, testCase.fSmoothingTime, iCurve, testCase.uEventFrame);
+                const bool bPassed = result.bMatch && result.bRamping == bExpectRamping;
+                uNumFailed += bPassed ? 0 : 1;
+                const char* szCurve = WoaGainSignals::GetCurveName((WoaGainDSP::Curve)iCurve);
+                if (in_options.bJson)
+                    printf("{\"skip_frames\":%u,\"smoothing_ms\":%.0f,\"event_frame\":%u,\"curve\":\"%s\",\"ramping\":%s,\"result\":\"%s\"}\n",
+                        testCase.uSkipFrames, testCase.fSmoothingTime, testCase.uEventFrame, szCurve, result.bRamping ? "true" : "false", bPassed ? "ok" : "fail");
+                else
+                    printf("%u,%.0f,%u,%s,%d,%s\n", testCase.uSkipFrames, testCase.fSmoothingTime, testCase.uEventFrame, szCurve, result.bRamping ? 1 : 0, bPassed ? "ok" : "fail");
+            }
+        }
+        fflush(stdout);
+        return uNumFailed;
+    }
+
+    AkUInt32 TestSmoothing(const Options& in_options)
+    {
+        // Buffer sizes dividing the 50 ms ramp or not, and splitting the 100 ms blocks of the auto-gain
+        static const AkUInt16 kSmoothingFrames[] = { 256, 100, 1024 };
+        AkUInt32 uNumFailed = 0;
+        if (!in_options.bJson)
+            printf("mode,frames,curve,correction_span_db,max_diff_db,result\n");
+        for (int iEvent = 0; iEvent < 2; ++iEvent)
+        {
+            for (AkUInt16 uFrames : kSmoothingFrames)
+            {
+                for (AkInt32 iCurve = 0; iCurve < WoaGainDSP::Curve_Count; ++iCurve)
+                {
+                    // The correction must move during the ramp for the check to mean anything
+                    const SmoothingResult result = CheckSmoothing(uFrames, iCurve, iEvent != 0);
+                    const bool bPassed = result.fMaxDiffDb <= kCurveDb && result.fCorrectionSpanDb > kTimeSkipRampingDb;
+                    uNumFailed += bPassed ? 0 : 1;
+                    const char* szMode = iEvent ? "event" : "param";
+                    const char* szCurve = WoaGainSignals::GetCurveName((WoaGainDSP::Curve)iCurve);
+                    if (in_options.bJson)
+                        printf("{\"mode\":\"%s\",\"frames\":%u,\"curve\":\"%s\",\"correction_span_db\":%.4f,\"max_diff_db\":%.6f,\"result\":\"%s\"}\n",
+                            szMode, uFrames, szCurve, result.fCorrectionSpanDb, result.fMaxDiffDb, bPassed ? "ok" : "fail");
+                    else
+                        printf("%s,%u,%s,%.4f,%.6f,%s\n", szMode, uFrames, szCurve, result.fCorrectionSpanDb, result.fMaxDiffDb, bPassed ? "ok" : "fail");
+                }
+            }
+        }
+        fflush(stdout);
+        return uNumFailed;
+    }
+
+    AkUInt32 TestEvents(const Options& in_options)
+    {
+        // Buffer sizes dividing the frames of the events or not, down to one frame per buffer. The
+        // skip ends in the middle of the ramp toward the third event.
+        static const AkUInt16 kEventFrames[] = { 1024, 64, 100, 1 };
+        const AkUInt32 uSkipFrames = 2500;
+        AkUInt32 uNumFailed = 0;
+        if (!in_options.bJson)
+            printf("mode,frames,curve,metering,max_diff_db,event_error_db,result\n");
+        for (AkInt32 iCurve = 0; iCurve < WoaGainDSP::Curve_Count; ++iCurve)
+        {
+            for (int iMetering = 0; iMetering < 2; ++iMetering)
+            {
+                std::vector<AkReal32> reference, gains;
+                RenderEvents(kEventFrames[0], iCurve, iMetering != 0, 0, reference);
+                for (int iSkip = 0; iSkip < 2; ++iSkip)
+                {
+                    for (AkUInt16 uFrames : kEventFrames)
+                    {
+                        const AkUInt32 uFirst = iSkip ? uSkipFrames : 0;
+                        RenderEvents(uFrames, iCurve, iMetering != 0, uFirst, gains);
+                        const AkReal64 fDiffDb = GetGainDifferenceDb(gains, reference, uFirst);
+                        const AkReal64 fEventDb = GetEventErrorDb(iSkip ? reference : gains);
+                        const bool bPassed = fDiffDb <= kCurveDb && fEventDb <= kCurveDb;
+                        uNumFailed += bPassed ? 0 : 1;
+                        const char* szMode = iSkip ? "timeskip" : "execute";
+                        const char* szCurve = WoaGainSignals::GetCurveName((WoaGainDSP::Curve)iCurve);
+                        if (in_options.bJson)
+                        {
+                            printf("{\"mode\":\"%s\",\"frames\":%u,\"curve\":\"%s\",\"metering\":%s,\"max_diff_db\":%.6f,\"event_error_db\":%.6f,\"result\":\"%s\"}\n",
+                                szMode, uFrames, szCurve, iMetering ? "true" : "false", fDiffDb, fEventDb, bPassed ? "ok" : "fail");
+                        }
+                        else
+                        {
+                            printf("%s,%u,%s,%d,%.6f,%.6f,%s\n", szMode, uFrames, szCurve, iMetering, fDiffDb, fEventDb, bPassed ? "ok" : "fail");
+                        }
+                    }
+                }
+            }
+        }
+        fflush(stdout);
+        if (uNumFailed > 0)
+            fprintf(stderr, "%u event renders differing by more than %.3f dB\n", uNumFailed, kCurveDb);
+        return uNumFailed;
+    }
+
+    AkUInt32 TestBatch(const Options& in_options)
+    {
+        const bool bPassed = CheckBatch(100, 64, 40);
+        if (in_options.bJson)
+            printf("{\"instances\":100,\"frames\":64,\"buffers\":40,\"result\":\"%s\"}\n", bPassed ? "ok" : "fail");
+        else
+            printf("instances,frames,buffers,result\n100,64,40,%s\n", bPassed ? "ok" : "fail");
+        fflush(stdout);
+        return bPassed ? 0 : 1;
+    }
+
+    AkUInt32 TestKernels(const Options& /*in_options*/)
+    {
+        const AkInt32 iLastIsa = WoaGainDSP::GetSupportedIsa();
+        static const AkUInt32 kKernelChannels[] = { 1, 2, 6, 12, 16 };
+        static const AkUInt16 kCheckFrames[] = { 1, 17, 64, 1023, 4096 };
+        AkUInt32 uNumFailed = 0;
+        for (AkInt32 iIsa = WoaGainDSP::Isa_Baseline + 1; iIsa <= iLastIsa; ++iIsa)
+        {
+            for (AkUInt32 uChannels : kKernelChannels)
+            {
+                for (AkUInt16 uFrames : kCheckFrames)
+                {
+                    for (int iMetering = 0; iMetering < 2; ++iMetering)
+                    {
+                        for (int iGain = 0; iGain < WoaGainSignals::KernelGain_Count; ++iGain)
+                        {
+                            if (!CheckKernel((WoaGainDSP::Isa)iIsa, uChannels, uFrames, iMetering != 0, (WoaGainSignals::KernelGain)iGain))
+                            {
+                                fprintf(stderr, "Kernel mismatch: %s, %u channels, %u frames, metering %d, %s\n", WoaGainDSP::GetIsaName((WoaGainDSP::Isa)iIsa),
+                                    uChannels, uFrames, iMetering, WoaGainSignals::GetKernelGainName((WoaGainSignals::KernelGain)iGain));
+                                ++uNumFailed;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        if (uNumFailed > 0)
+            fprintf(stderr, "%u kernels differing from the %s kernels\n", uNumFailed, WoaGainDSP::GetIsaName(WoaGainDSP::Isa_Baseline));
+        return uNumFailed;
+    }
+
+    AkUInt32 TestLevels(const Options& in_options)
+    {
+        if (!in_options.bJson)
+            printf("step,publishers,rms_db,expected_rms_db,peak_db,expected_peak_db,result\n");
+        const AkUInt32 uNumFailed = CheckLevels(in_options.bJson) + CheckChurn(in_options.bJson);
+        fflush(stdout);
+        if (uNumFailed > 0)
+            fprintf(stderr, "%u level registry checks failed\n", uNumFailed);
+        return uNumFailed;
+    }
+
+    // Prints the bytes in use in in_allocator after the step in_szStep as one line, and returns
+    // whether none are when in_bEmpty, some are otherwise.
+    bool CheckBytesInUse(bool in_bJson, const char* in_szStep, const WoaGainHost::Allocator& in_allocator, bool in_bEmpty)
+    {
+        const bool bPassed = (in_allocator.uBytesInUse == 0) == in_bEmpty;
+        if (in_bJson)
+            printf("{\"step\":\"%s\",\"bytes_in_use\":%zu,\"result\":\"%s\"}\n", in_szStep, in_allocator.uBytesInUse, bPassed ? "ok" : "fail");
+        else
+            printf("%s,%zu,%s\n", in_szStep, in_allocator.uBytesInUse, bPassed ? "ok" : "fail");
+        return bPassed;
+    }
+
+    // Creates more instances than a slab holds, with a clone of every parameter node, then
+    // terminates them and the sound engine in either order: everything must return to the
+    // allocator, including the slabs of WoaGainPool in pooled builds, which the effect hands back
+    // from its Term global callback. The second sound engine registers the callback again.
+    AkUInt32 TestPool(const Options& in_options)
+    {
+        const AkUInt32 kNumInstances = 40;
+        const AkChannelConfig channelConfig = WoaGainHost::GetChannelConfig(2);
+        AkAudioFormat format = WoaGainHost::GetAudioFormat(channelConfig, kSampleRate);
+        WoaGainHost::Allocator allocator;
+        WoaGainHost::EffectContext context;
+        if (!in_options.bJson)
+            printf("step,bytes_in_use,result\n");
+
+        AkUInt32 uNumFailed = 0;
+        for (int iTermFirst = 0; iTermFirst < 2; ++iTermFirst)
+        {
+            std::unique_ptr<WoaGainHost::Instance[]> instances(new WoaGainHost::Instance[kNumInstances]);
+            std::vector<AK::IAkPluginParam*> clones;
+            for (AkUInt32 i = 0; i < kNumInstances; ++i)
+            {
+                if (instances[i].Init(allocator, context, format) != AK_Success)
+                {
+                    fprintf(stderr, "Failed to initialize instance %u\n", i);
+                    return uNumFailed + 1;
+                }
+                clones.push_back(instances[i].GetParams()->Clone(&allocator));
+            }
+
+            const bool bTermFirst = iTermFirst != 0;
+            if (bTermFirst)
+            {
+                WoaGainHost::GlobalContext::Get().Term();
+                uNumFailed += CheckBytesInUse(in_options.bJson, "alive_at_term", allocator, false) ? 0 : 1;
+            }
+            for (AkUInt32 i = 0; i < kNumInstances; ++i)
+            {
+                instances[i].Term();
+                if (clones[i])
+                    clones[i]->Term(&allocator);
+            }
+            if (!bTermFirst)
+                WoaGainHost::GlobalContext::Get().Term();
+            uNumFailed += CheckBytesInUse(in_options.bJson, bTermFirst ? "terminated_after_term" : "terminated_before_term", allocator, true) ? 0 : 1;
+        }
+        fflush(stdout);
+        if (uNumFailed > 0)
+            fprintf(stderr, "%u pool checks failed\n", uNumFailed);
+        return uNumFailed;
+    }
+
+    struct Test
+    {
+        const char* szName;
+        AkUInt32 (*fnRun)(const Options& in_options);   ///< Returns the number of failed cases
+    };
+
+    const Test kTests[] = {
+        { "verify", TestVerify },
+        { "timeskip", TestTimeSkip },
+        { "smoothing", TestSmoothing },
+        { "events", TestEvents },
+        { "batch", TestBatch },
+        { "kernels", TestKernels },
+        { "levels", TestLevels },
+        { "pool", TestPool },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.bJson = false;
+    options.bQuick = false;
+    options.szIsa = nullptr;
+    std::vector<const Test*> tests;
+    for (int i = 1; i < argc; ++i)
+    {
+        const Test* pTest = nullptr;
+        for (const Test& test : kTests)
+            pTest = strcmp(argv[i], test.szName) == 0 ? &test : pTest;
+
+        if (strcmp(argv[i], "--json") == 0)
+            options.bJson = true;
+        else if (strcmp(argv[i], "--quick") == 0)
+            options.bQuick = true;
+        else if (strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+            options.szIsa = argv[++i];
+        else if (pTest)
+            tests.push_back(pTest);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--json] [--quick] [--isa sse2|avx2|avx512] [verify|timeskip|smoothing|events|batch|kernels|levels|pool...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tests.empty())
+    {
+        for (const Test& test : kTests)
+            tests.push_back(&test);
+    }
+
+    options.eIsa = WoaGainDSP::GetIsa();
+    if (options.szIsa)
+    {
+        if (!WoaGainDSP::ParseIsa(options.szIsa, options.eIsa))
+        {
+            fprintf(stderr, "Unknown instruction set: %s\n", options.szIsa);
+            return 1;
+        }
+        if (!WoaGainDSP::SetIsa(options.eIsa))
+        {
+            fprintf(stderr, "%s is not supported by this CPU, which supports up to %s\n", options.szIsa, WoaGainDSP::GetIsaName(WoaGainDSP::GetSupportedIsa()));
+            return 1;
+        }
+    }
+
+    AkUInt32 uNumFailedTests = 0;
+    for (const Test* pTest : tests)
+    {
+        // Tests changing the instruction set leave it as found
+        const AkUInt32 uNumFailed = pTest->fnRun(options);
+        WoaGainDSP::SetIsa(options.eIsa);
+        fprintf(stderr, "%s: %s\n", pTest->szName, uNumFailed == 0 ? "passed" : "FAILED");
+        uNumFailedTests += uNumFailed == 0 ? 0 : 1;
+    }
+    return uNumFailedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainMonitorData_H
+#define WoaGainMonitorData_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include <math.h>
+
+// Layout of the monitor data posted by WoaGainFX::Execute and decoded by
+// WoaGainPlugin::NotifyMonitorData. Levels are in dB.
+//
+// Version 2: Header, followed by ChannelLevels[uNumChannels], the levels of each channel quantized
+//            to QuantizedDb, then by the optional sections flagged in uFlags, in the order of the flags.
+// Version 1: HeaderV1, followed by AkReal32 fPeak[uNumChannels], the post-gain peak of each channel,
+//            then by the same optional sections.
+// Legacy (unversioned): AkReal32[2] = { RMS before, RMS after }.
+namespace WoaGainMonitorData
+{
+    static const AkUInt8 Version = 2;
+    static const AkUInt8 VersionV1 = 1;
+    static const AkUInt32 MaxChannels = 255;
+
+    /// Level in 1/256 dB steps, covering -128 to +128 dB within 1/512 dB. QuantizedSilence stands
+    /// for -infinity (no signal); levels out of range are clamped.
+    typedef AkInt16 QuantizedDb;
+    static const AkReal32 QuantizedDbSteps = 256.f;
+    static const QuantizedDb QuantizedSilence = -32768;
+    static const QuantizedDb QuantizedMax = 32767;
+
+    struct Header
+    {
+        AkUInt8 uVersion;
+        AkUInt8 uFlags;         ///< Optional sections present after the channels, see Flags
+        AkUInt16 uNumChannels;
+        QuantizedDb iRmsBefore; ///< RMS of all channels
+        QuantizedDb iRmsAfter;
+    };
+
+    struct ChannelLevels
+    {
+        QuantizedDb iRmsBefore;
+        QuantizedDb iRmsAfter;
+        QuantizedDb iPeakBefore;
+        QuantizedDb iPeakAfter;
+    };
+
+    struct HeaderV1
+    {
+        AkUInt8 uVersion;
+        AkUInt8 uFlags;         ///< Optional sections present after the peaks, see Flags
+        AkUInt16 uNumChannels;
+        AkReal32 fRmsBefore;
+        AkReal32 fRmsAfter;
+    };
+
+    enum Flags
+    {
+        Flag_PathCounts = 1 << 0,   ///< PathCounts section
+        Flag_Loudness = 1 << 1,     ///< Loudness section
+        Flag_Stats = 1 << 2,        ///< Stats section, from sound engines built with WOAGAIN_ENABLE_STATS
+        Flag_All = Flag_PathCounts | Flag_Loudness | Flag_Stats
+    };
+
+    /// Number of buffers processed by each path of the DSP since the previous post,
+    /// in the order of WoaGainDSP::Path.
+    static const AkUInt32 NumPaths = 4;
+    struct PathCounts
+    {
+        AkUInt32 uBuffers[NumPaths];    ///< Unity, mute, constant gain, ramp
+    };
+
+    /// BS.1770 loudness of the output in LUFS, -infinity before any sound. Integrated loudness
+    /// covers everything measured since the effect was reset.
+    struct Loudness
+    {
+        AkReal32 fMomentary;    ///< Last 400 ms
+        AkReal32 fShortTerm;    ///< Last 3 s
+        AkReal32 fIntegrated;
+    };
+
+    /// Time taken by WoaGainFX::Execute since the effect was initialized, in ns.
+    struct Stats
+    {
+        AkReal32 fAvgNs;
+        AkReal32 fP99Ns;
+        AkReal32 fMaxNs;
+        AkReal32 fNsPerFrame;
+    };
+
+    static const AkUInt32 LegacySize = sizeof(AkReal32) * 2;
+
+    inline AkUInt32 GetSectionsSize(AkUInt32 in_uFlags)
+    {
+        AkUInt32 uSize = 0;
+        if (in_uFlags & Flag_PathCounts)
+            uSize += sizeof(PathCounts);
+        if (in_uFlags & Flag_Loudness)
+            uSize += sizeof(Loudness);
+        if (in_uFlags & Flag_Stats)
+            uSize += sizeof(Stats);
+        return uSize;
+    }
+
+    inline AkUInt32 GetSize(AkUInt32 in_uNumChannels, AkUInt32 in_uFlags = 0)
+    {
+        return sizeof(Header) + sizeof(ChannelLevels) * in_uNumChannels + GetSectionsSize(in_uFlags);
+    }
+
+    inline AkUInt32 GetSizeV1(AkUInt32 in_uNumChannels, AkUInt32 in_uFlags = 0)
+    {
+        return sizeof(HeaderV1) + sizeof(AkReal32) * in_uNumChannels + GetSectionsSize(in_uFlags);
+    }
+
+    /// Rounds a level in dB to the nearest step. NaN and -infinity give QuantizedSilence.
+    inline QuantizedDb QuantizeDb(AkReal32 in_fDb)
+    {
+        if (!(in_fDb > -INFINITY))
+            return QuantizedSilence;
+        const AkReal32 fSteps = floorf(in_fDb * QuantizedDbSteps + 0.5f);
+        if (fSteps <= (AkReal32)QuantizedSilence)
+            return (QuantizedDb)(QuantizedSilence + 1);
+        return fSteps < (AkReal32)QuantizedMax ? (QuantizedDb)fSteps : QuantizedMax;
+    }
+
+    inline AkReal32 DequantizeDb(QuantizedDb in_iDb)
+    {
+        return in_iDb == QuantizedSilence ? -INFINITY : (AkReal32)in_iDb * (1.f / QuantizedDbSteps);
+    }
+
+    /// Level of a mean square (RMS level): 10 * log10(P)
+    inline QuantizedDb QuantizePower(AkReal32 in_fPower)
+    {
+        return QuantizeDb(log10f(in_fPower) * 10.f);
+    }
+
+    /// Level of an amplitude (peak level): 20 * log10(A)
+    inline QuantizedDb QuantizeAmplitude(AkReal32 in_fAmplitude)
+    {
+        return QuantizeDb(log10f(in_fAmplitude) * 20.f);
+    }
+}
+
+#endif // WoaGainMonitorData_H
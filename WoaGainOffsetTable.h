@@ -0,0 +1,143 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+
+#ifndef WoaGainOffsetTable_H
+#define WoaGainOffsetTable_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include <string.h>
+
+// Gain offsets per asset, computed offline by WoaGainAnalyze, written into the bank by
+// WoaGainPlugin::GetBankParameters and read by WoaGainFXParams::SetParamsBlock. WoaGainFX applies
+// the offset of the node it is inserted on, looked up by the node's short ID.
+//
+// Entries are packed, 6 bytes each: AkUInt32 uKey, then AkInt16 iOffset in hundredths of a dB,
+// sorted by key. In the bank, the entries follow their AkUInt32 count. In a table file, they
+// follow a FileHeader.
+namespace WoaGainOffsetTable
+{
+    static const AkUInt32 Magic = 0x544f4757;   // "WGOT"
+    static const AkUInt16 Version = 1;
+    static const AkUInt32 EntrySize = sizeof(AkUInt32) + sizeof(AkInt16);
+    static const AkUInt32 MaxEntries = 65536;
+
+    struct FileHeader
+    {
+        AkUInt32 uMagic;
+        AkUInt16 uVersion;
+        AkUInt16 uReserved;
+        AkUInt32 uNumEntries;
+    };
+
+    struct Entry
+    {
+        AkUInt32 uKey;
+        AkInt16 iOffset;    ///< In hundredths of a dB
+    };
+
+    inline AkReal32 GetOffsetDb(const Entry& in_entry) { return (AkReal32)in_entry.iOffset * 0.01f; }
+
+    /// Hash of a name as AK::SoundEngine::GetIDFromString: 32-bit FNV-1 of the lowercased name.
+    inline AkUInt32 GetKey(const char* in_szName, size_t in_uLength)
+    {
+        AkUInt32 uHash = 2166136261u;
+        for (size_t i = 0; i < in_uLength; ++i)
+        {
+            const char c = in_szName[i];
+            uHash = (uHash * 16777619u) ^ (AkUInt32)(AkUInt8)(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        }
+        return uHash;
+    }
+
+    /// Key of an asset file without a known short ID: GetKey of its name, without directory and extension.
+    inline AkUInt32 GetFileKey(const char* in_szPath)
+    {
+        const char* szName = in_szPath;
+        for (const char* p = in_szPath; *p; ++p)
+        {
+            if (*p == '/' || *p == '\\')
+                szName = p + 1;
+        }
+        const char* szExtension = strrchr(szName, '.');
+        return GetKey(szName, szExtension ? (size_t)(szExtension - szName) : strlen(szName));
+    }
+
+    inline void ReadEntry(const AkUInt8* in_pData, Entry& out_entry)
+    {
+        memcpy(&out_entry.uKey, in_pData, sizeof(out_entry.uKey));
+        memcpy(&out_entry.iOffset, in_pData + sizeof(out_entry.uKey), sizeof(out_entry.iOffset));
+    }
+
+    inline void WriteEntry(const Entry& in_entry, AkUInt8* out_pData)
+    {
+        memcpy(out_pData, &in_entry.uKey, sizeof(in_entry.uKey));
+        memcpy(out_pData + sizeof(in_entry.uKey), &in_entry.iOffset, sizeof(in_entry.iOffset));
+    }
+
+    /// Validates a table file loaded in memory. Returns its packed entries and their count, or
+    /// nullptr when the file is not a table, is truncated or has unsorted keys.
+    inline const AkUInt8* ParseFile(const void* in_pData, size_t in_uSize, AkUInt32& out_uNumEntries)
+    {
+        FileHeader header;
+        if (in_uSize < sizeof(header))
+            return nullptr;
+        memcpy(&header, in_pData, sizeof(header));
+        if (header.uMagic != Magic || header.uVersion != Version || header.uNumEntries > MaxEntries
+            || in_uSize != sizeof(header) + (size_t)header.uNumEntries * EntrySize)
+            return nullptr;
+
+        const AkUInt8* pEntries = (const AkUInt8*)in_pData + sizeof(header);
+        Entry previous, entry;
+        for (AkUInt32 i = 0; i < header.uNumEntries; ++i)
+        {
+            ReadEntry(pEntries + i * EntrySize, entry);
+            if (i > 0 && entry.uKey <= previous.uKey)
+                return nullptr;
+            previous = entry;
+        }
+        out_uNumEntries = header.uNumEntries;
+        return pEntries;
+    }
+
+    /// Binary search of in_uKey in entries sorted by key.
+    inline const Entry* Find(const Entry* in_pEntries, AkUInt32 in_uNumEntries, AkUInt32 in_uKey)
+    {
+        AkUInt32 uLow = 0, uHigh = in_uNumEntries;
+        while (uLow < uHigh)
+        {
+            const AkUInt32 uMid = uLow + (uHigh - uLow) / 2;
+            if (in_pEntries[uMid].uKey < in_uKey)
+                uLow = uMid + 1;
+            else
+                uHigh = uMid;
+        }
+        return uLow < in_uNumEntries && in_pEntries[uLow].uKey == in_uKey ? &in_pEntries[uLow] : nullptr;
+    }
+}
+
+#endif // WoaGainOffsetTable_H
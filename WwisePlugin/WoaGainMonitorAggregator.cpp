@@ -0,0 +1,268 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#include "WoaGainMonitorAggregator.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    // RMS levels are powers in dB: 10 * log10(P)
+    AkForceInline AkReal32 DbToPower(AkReal32 in_fDb)
+    {
+        return powf(10.f, in_fDb * 0.1f);
+    }
+
+    AkForceInline AkReal32 PowerToDb(AkReal32 in_fPower)
+    {
+        return log10f(in_fPower) * 10.f;
+    }
+
+    // Returns the payload version, or 0 when in_pData is not a version 1 or 2 payload of a consistent size
+    AkUInt8 GetVersion(const void* in_pData, AkUInt32 in_uDataSize)
+    {
+        if (in_pData == nullptr || in_uDataSize < sizeof(WoaGainMonitorData::Header))
+            return 0;
+
+        // Both versions start with the same fields
+        const WoaGainMonitorData::Header* pHeader = (const WoaGainMonitorData::Header*)in_pData;
+        if ((pHeader->uFlags & ~WoaGainMonitorData::Flag_All) != 0)
+            return 0;
+        if (pHeader->uVersion == WoaGainMonitorData::Version)
+            return in_uDataSize == WoaGainMonitorData::GetSize(pHeader->uNumChannels, pHeader->uFlags) ? pHeader->uVersion : 0;
+        if (pHeader->uVersion == WoaGainMonitorData::VersionV1)
+            return in_uDataSize == WoaGainMonitorData::GetSizeV1(pHeader->uNumChannels, pHeader->uFlags) ? pHeader->uVersion : 0;
+        return 0;
+    }
+}
+
+WoaGainMonitorAggregator::WoaGainMonitorAggregator()
+{
+    Begin();
+    End();
+}
+
+void WoaGainMonitorAggregator::Begin()
+{
+    m_levels.uNumInstances = 0;
+    m_levels.fMaxRmsBefore = -INFINITY;
+    m_levels.fMaxRmsAfter = -INFINITY;
+    m_levels.fMaxPeak = -INFINITY;
+    for (AkUInt32 i = 0; i < WoaGainMonitorData::NumPaths; ++i)
+        m_levels.uPathBuffers[i] = 0;
+    m_levels.maxLoudness.fMomentary = -INFINITY;
+    m_levels.maxLoudness.fShortTerm = -INFINITY;
+    m_levels.maxLoudness.fIntegrated = -INFINITY;
+    m_levels.maxStats = WoaGainMonitorData::Stats();
+    m_levels.uNumTop = 0;
+    m_fPowerBefore = 0.f;
+    m_fPowerAfter = 0.f;
+}
+
+bool WoaGainMonitorAggregator::Add(AkUInt64 in_uGameObjectID, const void* in_pData, AkUInt32 in_uDataSize)
+{
+    Instance instance;
+    if (!Decode(in_pData, in_uDataSize, instance))
+        return false;
+    instance.uGameObjectID = in_uGameObjectID;
+
+    ++m_levels.uNumInstances;
+    if (instance.fRmsAfter > m_levels.fMaxRmsAfter || m_levels.uNumInstances == 1)
+    {
+        m_levels.fMaxRmsBefore = instance.fRmsBefore;
+        m_levels.fMaxRmsAfter = instance.fRmsAfter;
+    }
+    if (instance.fPeak > m_levels.fMaxPeak)
+        m_levels.fMaxPeak = instance.fPeak;
+    m_fPowerBefore += DbToPower(instance.fRmsBefore);
+    m_fPowerAfter += DbToPower(instance.fRmsAfter);
+    for (AkUInt32 i = 0; i < WoaGainMonitorData::NumPaths; ++i)
+        m_levels.uPathBuffers[i] += instance.uPathBuffers[i];
+    WoaGainMonitorData::Loudness& maxLoudness = m_levels.maxLoudness;
+    if (instance.loudness.fMomentary > maxLoudness.fMomentary)
+        maxLoudness.fMomentary = instance.loudness.fMomentary;
+    if (instance.loudness.fShortTerm > maxLoudness.fShortTerm)
+        maxLoudness.fShortTerm = instance.loudness.fShortTerm;
+    if (instance.loudness.fIntegrated > maxLoudness.fIntegrated)
+        maxLoudness.fIntegrated = instance.loudness.fIntegrated;
+    WoaGainMonitorData::Stats& maxStats = m_levels.maxStats;
+    if (instance.stats.fAvgNs > maxStats.fAvgNs)
+        maxStats.fAvgNs = instance.stats.fAvgNs;
+    if (instance.stats.fP99Ns > maxStats.fP99Ns)
+        maxStats.fP99Ns = instance.stats.fP99Ns;
+    if (instance.stats.fMaxNs > maxStats.fMaxNs)
+        maxStats.fMaxNs = instance.stats.fMaxNs;
+    if (instance.stats.fNsPerFrame > maxStats.fNsPerFrame)
+        maxStats.fNsPerFrame = instance.stats.fNsPerFrame;
+
+    InsertTop(instance);
+    return true;
+}
+
+const WoaGainMonitorAggregator::Levels& WoaGainMonitorAggregator::End()
+{
+    m_levels.fSumRmsBefore = PowerToDb(m_fPowerBefore);
+    m_levels.fSumRmsAfter = PowerToDb(m_fPowerAfter);
+    return m_levels;
+}
+
+bool WoaGainMonitorAggregator::Decode(const void* in_pData, AkUInt32 in_uDataSize, Instance& out_instance)
+{
+    if (in_pData == nullptr)
+        return false;
+
+    out_instance.uGameObjectID = 0;
+    for (AkUInt32 i = 0; i < WoaGainMonitorData::NumPaths; ++i)
+        out_instance.uPathBuffers[i] = 0;
+    out_instance.loudness.fMomentary = -INFINITY;
+    out_instance.loudness.fShortTerm = -INFINITY;
+    out_instance.loudness.fIntegrated = -INFINITY;
+    out_instance.stats = WoaGainMonitorData::Stats();
+    out_instance.uNumChannels = 0;
+    if (in_uDataSize == WoaGainMonitorData::LegacySize)
+    {
+        // Sound engines built before the payload was versioned
+        const AkReal32* pRms = (const AkReal32*)in_pData;
+        out_instance.fRmsBefore = pRms[0];
+        out_instance.fRmsAfter = pRms[1];
+        out_instance.fPeak = pRms[1];
+        return true;
+    }
+
+    const AkUInt8 uVersion = GetVersion(in_pData, in_uDataSize);
+    if (uVersion == 0)
+        return false;
+
+    const AkUInt8* pSection;
+    AkUInt32 uFlags;
+    if (uVersion == WoaGainMonitorData::Version)
+    {
+        const WoaGainMonitorData::Header* pHeader = (const WoaGainMonitorData::Header*)in_pData;
+        const WoaGainMonitorData::ChannelLevels* pChannels = (const WoaGainMonitorData::ChannelLevels*)(pHeader + 1);
+        out_instance.uNumChannels = pHeader->uNumChannels;
+        out_instance.fRmsBefore = WoaGainMonitorData::DequantizeDb(pHeader->iRmsBefore);
+        out_instance.fRmsAfter = WoaGainMonitorData::DequantizeDb(pHeader->iRmsAfter);
+
+        // Quantized levels are ordered like the levels, silence being the lowest
+        WoaGainMonitorData::QuantizedDb iPeak = WoaGainMonitorData::QuantizedSilence;
+        for (AkUInt32 i = 0; i < pHeader->uNumChannels; ++i)
+        {
+            if (pChannels[i].iPeakAfter > iPeak)
+                iPeak = pChannels[i].iPeakAfter;
+        }
+        out_instance.fPeak = WoaGainMonitorData::DequantizeDb(iPeak);
+        pSection = (const AkUInt8*)(pChannels + pHeader->uNumChannels);
+        uFlags = pHeader->uFlags;
+    }
+    else
+    {
+        const WoaGainMonitorData::HeaderV1* pHeader = (const WoaGainMonitorData::HeaderV1*)in_pData;
+        const AkReal32* pPeaks = (const AkReal32*)(pHeader + 1);
+        out_instance.uNumChannels = pHeader->uNumChannels;
+        out_instance.fRmsBefore = pHeader->fRmsBefore;
+        out_instance.fRmsAfter = pHeader->fRmsAfter;
+        out_instance.fPeak = -INFINITY;
+        for (AkUInt32 i = 0; i < pHeader->uNumChannels; ++i)
+        {
+            if (pPeaks[i] > out_instance.fPeak)
+                out_instance.fPeak = pPeaks[i];
+        }
+        pSection = (const AkUInt8*)(pPeaks + pHeader->uNumChannels);
+        uFlags = pHeader->uFlags;
+    }
+
+    // Sections follow the channels in the order of their flags
+    if (uFlags & WoaGainMonitorData::Flag_PathCounts)
+    {
+        WoaGainMonitorData::PathCounts pathCounts;
+        memcpy(&pathCounts, pSection, sizeof(pathCounts));
+        for (AkUInt32 i = 0; i < WoaGainMonitorData::NumPaths; ++i)
+            out_instance.uPathBuffers[i] = pathCounts.uBuffers[i];
+        pSection += sizeof(pathCounts);
+    }
+    if (uFlags & WoaGainMonitorData::Flag_Loudness)
+    {
+        memcpy(&out_instance.loudness, pSection, sizeof(out_instance.loudness));
+        pSection += sizeof(out_instance.loudness);
+    }
+    if (uFlags & WoaGainMonitorData::Flag_Stats)
+        memcpy(&out_instance.stats, pSection, sizeof(out_instance.stats));
+    return true;
+}
+
+AkUInt32 WoaGainMonitorAggregator::DecodeChannels(const void* in_pData, AkUInt32 in_uDataSize, Channel* out_pChannels, AkUInt32 in_uMaxChannels)
+{
+    const AkUInt8 uVersion = GetVersion(in_pData, in_uDataSize);
+    if (uVersion == 0)
+        return 0;
+
+    const WoaGainMonitorData::Header* pHeader = (const WoaGainMonitorData::Header*)in_pData;
+    const AkUInt32 uNumChannels = pHeader->uNumChannels < in_uMaxChannels ? pHeader->uNumChannels : in_uMaxChannels;
+    if (uVersion == WoaGainMonitorData::Version)
+    {
+        const WoaGainMonitorData::ChannelLevels* pChannels = (const WoaGainMonitorData::ChannelLevels*)(pHeader + 1);
+        for (AkUInt32 i = 0; i < uNumChannels; ++i)
+        {
+            out_pChannels[i].fRmsBefore = WoaGainMonitorData::DequantizeDb(pChannels[i].iRmsBefore);
+            out_pChannels[i].fRmsAfter = WoaGainMonitorData::DequantizeDb(pChannels[i].iRmsAfter);
+            out_pChannels[i].fPeakBefore = WoaGainMonitorData::DequantizeDb(pChannels[i].iPeakBefore);
+            out_pChannels[i].fPeakAfter = WoaGainMonitorData::DequantizeDb(pChannels[i].iPeakAfter);
+        }
+    }
+    else
+    {
+        const AkReal32* pPeaks = (const AkReal32*)((const WoaGainMonitorData::HeaderV1*)in_pData + 1);
+        for (AkUInt32 i = 0; i < uNumChannels; ++i)
+        {
+            out_pChannels[i].fRmsBefore = -INFINITY;
+            out_pChannels[i].fRmsAfter = -INFINITY;
+            out_pChannels[i].fPeakBefore = -INFINITY;
+            out_pChannels[i].fPeakAfter = pPeaks[i];
+        }
+    }
+    return uNumChannels;
+}
+
+void WoaGainMonitorAggregator::InsertTop(const Instance& in_instance)
+{
+    // Insertion into a short sorted array: most instances are rejected by the first comparison
+    AkUInt32 i = m_levels.uNumTop;
+    if (i == MaxTopInstances)
+    {
+        if (!(in_instance.fRmsAfter > m_levels.top[i - 1].fRmsAfter))
+            return;
+        --i;
+    }
+    else
+    {
+        ++m_levels.uNumTop;
+    }
+
+    for (; i > 0 && in_instance.fRmsAfter > m_levels.top[i - 1].fRmsAfter; --i)
+        m_levels.top[i] = m_levels.top[i - 1];
+    m_levels.top[i] = in_instance;
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Copyright (c) 2020 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef WoaGainMonitorAggregator_H
+#define WoaGainMonitorAggregator_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#include "../WoaGainMonitorData.h"
+
+/// Combines the monitor data posted by every WoaGainFX instance during one monitoring update
+/// into the levels shown by the authoring dialog: loudest instance, energy sum of all instances
+/// and the loudest instances by output level.
+///
+/// This only depends on the payload layout in WoaGainMonitorData.h, so it builds outside of the
+/// authoring tool (see Tools/Benchmark/WoaGainMonitorBench.cpp).
+class WoaGainMonitorAggregator
+{
+public:
+    static const AkUInt32 MaxTopInstances = 8;
+
+    /// Levels of a single instance, in dB.
+    struct Instance
+    {
+        AkUInt64 uGameObjectID;
+        AkReal32 fRmsBefore;
+        AkReal32 fRmsAfter;
+        AkReal32 fPeak;         ///< Loudest post-gain channel peak, same as fRmsAfter for legacy payloads
+        AkUInt32 uNumChannels;  ///< 0 for legacy payloads
+        AkUInt32 uPathBuffers[WoaGainMonitorData::NumPaths];    ///< Buffers per DSP path, 0 when not posted
+        WoaGainMonitorData::Loudness loudness;  ///< In LUFS, -infinity when not posted
+        WoaGainMonitorData::Stats stats;        ///< Execute times, 0 when not posted
+    };
+
+    /// Levels of one channel of an instance, in dB, -infinity when not posted.
+    struct Channel
+    {
+        AkReal32 fRmsBefore;
+        AkReal32 fRmsAfter;
+        AkReal32 fPeakBefore;
+        AkReal32 fPeakAfter;
+    };
+
+    /// Levels of all the instances of an update, in dB. Levels without any instance are -infinity.
+    struct Levels
+    {
+        AkUInt32 uNumInstances;     ///< Instances with a valid payload
+        AkReal32 fMaxRmsBefore;     ///< Input RMS of the loudest instance
+        AkReal32 fMaxRmsAfter;      ///< Output RMS of the loudest instance
+        AkReal32 fSumRmsBefore;     ///< Input RMS of all instances summed as uncorrelated signals
+        AkReal32 fSumRmsAfter;      ///< Output RMS of all instances summed as uncorrelated signals
+        AkReal32 fMaxPeak;          ///< Loudest post-gain peak of any channel of any instance
+        AkUInt64 uPathBuffers[WoaGainMonitorData::NumPaths];    ///< Buffers per DSP path, summed over instances
+        WoaGainMonitorData::Loudness maxLoudness;   ///< Loudest momentary, short-term and integrated values of any instance
+        WoaGainMonitorData::Stats maxStats;         ///< Slowest Execute times of any instance, 0 when not posted
+        AkUInt32 uNumTop;           ///< Entries used in top
+        Instance top[MaxTopInstances];  ///< Loudest instances by output RMS, loudest first
+    };
+
+    WoaGainMonitorAggregator();
+
+    /// Starts a new update, dropping the instances added so far.
+    void Begin();
+
+    /// Adds the payload posted by one instance. Returns false, and ignores the payload, when it
+    /// is not a legacy, version 1 or version 2 payload of a consistent size.
+    bool Add(AkUInt64 in_uGameObjectID, const void* in_pData, AkUInt32 in_uDataSize);
+
+    /// Finishes the update, computing the levels of the instances added since Begin.
+    const Levels& End();
+
+    /// Levels of the last finished update.
+    const Levels& GetLevels() const { return m_levels; }
+
+    /// Decodes the payload posted by one instance, see Add.
+    static bool Decode(const void* in_pData, AkUInt32 in_uDataSize, Instance& out_instance);
+
+    /// Decodes the levels of the first in_uMaxChannels channels of a payload into out_pChannels.
+    /// Returns the number of channels decoded, 0 for invalid and legacy payloads. Version 1
+    /// payloads only carry the post-gain peaks, their other levels are -infinity.
+    static AkUInt32 DecodeChannels(const void* in_pData, AkUInt32 in_uDataSize, Channel* out_pChannels, AkUInt32 in_uMaxChannels);
+
+private:
+    /// Inserts in_instance in m_levels.top if it is among the MaxTopInstances loudest.
+    void InsertTop(const Instance& in_instance);
+
+    Levels m_levels;
+
+    // Energy sums of the current update, as linear powers
+    AkReal32 m_fPowerBefore;
+    AkReal32 m_fPowerAfter;
+};
+
+#endif // WoaGainMonitorAggregator_H
@@ -28,16 +28,43 @@ the specific language governing permissions and limitations under the License.
 #include "resource.h"
 
 #include "../SoundEnginePlugin/WoaGainFXFactory.h"
+#include "../WoaGainMonitorData.h"
+#include "../WoaGainOffsetTable.h"
 
 #include <AK/Tools/Common/AkAssert.h>
 
+#include <math.h>
 #include <shellapi.h>
-#include <string>
+#include <stdio.h>
+#include <vector>
 
+// The levels shown in the dialog are refreshed at most at about the display frame rate,
+// whatever the rate and number of instances posting monitor data
+static const UINT_PTR LEVELS_TIMER_ID = 1;
+static const UINT LEVELS_REFRESH_PERIOD_MS = 16;
+
+// Levels at or below this floor are displayed as the floor, e.g. silence (-infinity)
+static const AkReal32 LEVELS_FLOOR_DB = -96.f;
+
+// Reads a whole file, e.g. the gain offset table
+static bool ReadFile(LPCWSTR in_szPath, std::vector<AkUInt8>& out_data)
+{
+    FILE* pFile = _wfopen(in_szPath, L"rb");
+    if (!pFile)
+        return false;
+    fseek(pFile, 0, SEEK_END);
+    const long lSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    out_data.resize(lSize > 0 ? (size_t)lSize : 0);
+    const bool bRead = lSize >= 0 && fread(out_data.data(), 1, out_data.size(), pFile) == out_data.size();
+    fclose(pFile);
+    return bRead;
+}
 
 WoaGainPlugin::WoaGainPlugin()
     : m_pPSet(nullptr)
     , m_hwnd(NULL)
+    , m_bLevelsDirty(false)
 {
 }
 
@@ -61,10 +88,56 @@ bool WoaGainPlugin::GetBankParameters(const GUID& in_guidPlatform, AK::Wwise::IW
     CComVariant varProp;
     m_pPSet->GetValue(in_guidPlatform, L"Dummy", varProp);
     in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"Smoothing", varProp);
+    in_pDataWriter->WriteBool(varProp.boolVal != VARIANT_FALSE);
+    m_pPSet->GetValue(in_guidPlatform, L"SmoothingTime", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"MeterRate", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"Loudness", varProp);
+    in_pDataWriter->WriteBool(varProp.boolVal != VARIANT_FALSE);
+    m_pPSet->GetValue(in_guidPlatform, L"AutoGain", varProp);
+    in_pDataWriter->WriteBool(varProp.boolVal != VARIANT_FALSE);
+    m_pPSet->GetValue(in_guidPlatform, L"TargetLoudness", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"AttackTime", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"ReleaseTime", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"MaxCorrection", varProp);
+    in_pDataWriter->WriteReal32(varProp.fltVal);
+    m_pPSet->GetValue(in_guidPlatform, L"SmoothingCurve", varProp);
+    in_pDataWriter->WriteInt32(varProp.lVal);
+    m_pPSet->GetValue(in_guidPlatform, L"LevelKey", varProp);
+    in_pDataWriter->WriteUInt32((AkUInt32)varProp.lVal);
+
+    // The gain offsets go last, an empty table when there is none or it cannot be read
+    m_pPSet->GetValue(in_guidPlatform, L"GainOffsetTable", varProp);
+    std::vector<AkUInt8> table;
+    AkUInt32 uNumEntries = 0;
+    const AkUInt8* pEntries = nullptr;
+    if (varProp.vt == VT_BSTR && varProp.bstrVal && varProp.bstrVal[0] && ReadFile(varProp.bstrVal, table))
+        pEntries = WoaGainOffsetTable::ParseFile(table.data(), (AkUInt32)table.size(), uNumEntries);
+    if (!pEntries)
+        uNumEntries = 0;
+    in_pDataWriter->WriteUInt32(uNumEntries);
+    for (AkUInt32 i = 0; i < uNumEntries; ++i)
+    {
+        WoaGainOffsetTable::Entry entry;
+        WoaGainOffsetTable::ReadEntry(pEntries + i * WoaGainOffsetTable::EntrySize, entry);
+        in_pDataWriter->WriteUInt32(entry.uKey);
+        in_pDataWriter->WriteInt16(entry.iOffset);
+    }
 
     return true;
 }
 
+void WoaGainPlugin::NotifyPropertyChanged(const GUID& /*in_guidPlatform*/, LPCWSTR in_szPropertyName)
+{
+    if (wcscmp(in_szPropertyName, L"GainOffsetTable") == 0)
+        m_pPSet->NotifyInternalDataChanged(AK::IAkPluginParam::ALL_PLUGIN_DATA_ID);
+}
+
 // Acquire the module instance from the Microsoft linker
 extern "C" IMAGE_DOS_HEADER __ImageBase;
 
@@ -83,6 +156,18 @@ HINSTANCE WoaGainPlugin::GetResourceHandle() const
 // The preprocessor turns the code below into:
 // AK::Wwise::PopulateTableItem WoaGainProperties = {
 //    {IDC_GAIN_SLIDER, L"Dummy"},
+//    {IDC_SMOOTHING_CHECK, L"Smoothing"},
+//    {IDC_SMOOTHING_TIME, L"SmoothingTime"},
+//    {IDC_METER_RATE, L"MeterRate"},
+//    {IDC_LOUDNESS_CHECK, L"Loudness"},
+//    {IDC_AUTO_GAIN_CHECK, L"AutoGain"},
+//    {IDC_TARGET_LOUDNESS, L"TargetLoudness"},
+//    {IDC_ATTACK_TIME, L"AttackTime"},
+//    {IDC_RELEASE_TIME, L"ReleaseTime"},
+//    {IDC_MAX_CORRECTION, L"MaxCorrection"},
+//    {IDC_GAIN_OFFSET_TABLE, L"GainOffsetTable"},
+//    {IDC_SMOOTHING_CURVE, L"SmoothingCurve"},
+//    {IDC_LEVEL_KEY, L"LevelKey"},
 //    {0, NULL}
 // };
 AK_BEGIN_POPULATE_TABLE(WoaGainProperties)
@@ -90,6 +175,18 @@ AK_BEGIN_POPULATE_TABLE(WoaGainProperties)
         IDC_GAIN_SLIDER, /* < ID of the Win32 control in resource.h and WoaGain.rc */
         L"Dummy"         /* < Property Name in WoaGain.xml */
     )
+    AK_POP_ITEM(IDC_SMOOTHING_CHECK, L"Smoothing")
+    AK_POP_ITEM(IDC_SMOOTHING_TIME, L"SmoothingTime")
+    AK_POP_ITEM(IDC_METER_RATE, L"MeterRate")
+    AK_POP_ITEM(IDC_LOUDNESS_CHECK, L"Loudness")
+    AK_POP_ITEM(IDC_AUTO_GAIN_CHECK, L"AutoGain")
+    AK_POP_ITEM(IDC_TARGET_LOUDNESS, L"TargetLoudness")
+    AK_POP_ITEM(IDC_ATTACK_TIME, L"AttackTime")
+    AK_POP_ITEM(IDC_RELEASE_TIME, L"ReleaseTime")
+    AK_POP_ITEM(IDC_MAX_CORRECTION, L"MaxCorrection")
+    AK_POP_ITEM(IDC_GAIN_OFFSET_TABLE, L"GainOffsetTable")
+    AK_POP_ITEM(IDC_SMOOTHING_CURVE, L"SmoothingCurve")
+    AK_POP_ITEM(IDC_LEVEL_KEY, L"LevelKey")
 AK_END_POPULATE_TABLE()
 
 // Return true = Custom GUI
@@ -144,6 +241,8 @@ bool WoaGainPlugin::WindowProc(
         case WM_INITDIALOG:
         {
             m_hwnd = in_hWnd;
+            m_bLevelsDirty = false;
+            ::SetTimer(in_hWnd, LEVELS_TIMER_ID, LEVELS_REFRESH_PERIOD_MS, NULL);
 
             // return TRUE to direct the system to set the keyboard focus to the control specified by wParam
             // return FALSE to prevent the system from setting the default keyboard focus
@@ -154,12 +253,29 @@ bool WoaGainPlugin::WindowProc(
         // It is sent to the window procedure of the window being destroyed after the window is removed from the screen.
         case WM_DESTROY:
         {
+            ::KillTimer(in_hWnd, LEVELS_TIMER_ID);
             m_hwnd = NULL;
 
             // If an application processes this message, it should return zero.
             out_lResult = 0;
             break;
         }
+        // Posted at every LEVELS_REFRESH_PERIOD_MS while the dialog exists
+        case WM_TIMER:
+        {
+            if (in_wParam != LEVELS_TIMER_ID)
+            {
+                messageWasHandled = false;
+                break;
+            }
+
+            if (m_bLevelsDirty)
+                RefreshLevels();
+
+            // An application should return zero if it processes this message.
+            out_lResult = 0;
+            break;
+        }
         default:
         {
             messageWasHandled = false;
@@ -199,24 +315,96 @@ void WoaGainPlugin::NotifyMonitorData(
 {
     // Below are pedantic validation for demonstration purposes
 
-    if (m_hwnd != NULL &&          // The dialog exists
-        in_pData != nullptr &&     // The data payload is not null
-        in_uDataSize >= 1 &&       // Received data from at least 1 instance
-        in_bNeedsByteSwap == false // Only handle little-endian to little-endian
+    if (m_hwnd == NULL ||           // The dialog exists
+        in_pData == nullptr ||      // The data payload is not null
+        in_bNeedsByteSwap == true   // Only handle little-endian to little-endian
     ) {
-        // TODO: This handles only a single instance!
-        //       We _must_ handle all instances (in_uDataSize = number of instances)
+        return;
+    }
 
-        if (in_pData->pData != nullptr &&               // The monitor data is not null
-            in_pData->uDataSize == sizeof(AkReal32) * 2 // 
-        ) {
-            AkReal32* serializedData = (AkReal32*)in_pData->pData;
+    // One entry per instance (in_uDataSize = number of instances). The dialog is only
+    // updated by the refresh timer, so bursts of updates cost a single redraw.
+    m_monitorAggregator.Begin();
+    for (unsigned int i = 0; i < in_uDataSize; ++i)
+        m_monitorAggregator.Add(in_pData[i].uGameObjectID, in_pData[i].pData, in_pData[i].uDataSize);
+    m_monitorAggregator.End();
+    m_bLevelsDirty = true;
+}
 
-            HWND inputLvlLabel = ::GetDlgItem(m_hwnd, IDC_INPUT_LVL);
-            ::SetWindowTextW(inputLvlLabel, std::to_wstring(serializedData[0]).c_str());
+static AkReal32 ClampLevel(AkReal32 in_fDb)
+{
+    return in_fDb > LEVELS_FLOOR_DB ? in_fDb : LEVELS_FLOOR_DB;
+}
 
-            HWND outputLvlLabel = ::GetDlgItem(m_hwnd, IDC_OUTPUT_LVL);
-            ::SetWindowTextW(outputLvlLabel, std::to_wstring(serializedData[1]).c_str());
-        }
+void WoaGainPlugin::RefreshLevels()
+{
+    const WoaGainMonitorAggregator::Levels& levels = m_monitorAggregator.GetLevels();
+    m_bLevelsDirty = false;
+
+    // Input and output levels of the loudest instance
+    wchar_t text[WoaGainMonitorAggregator::MaxTopInstances * 64];
+    swprintf_s(text, L"%.1f", ClampLevel(levels.fMaxRmsBefore));
+    ::SetDlgItemTextW(m_hwnd, IDC_INPUT_LVL, text);
+    swprintf_s(text, L"%.1f", ClampLevel(levels.fMaxRmsAfter));
+    ::SetDlgItemTextW(m_hwnd, IDC_OUTPUT_LVL, text);
+
+    swprintf_s(text, L"%u (sum %.1f dB, peak %.1f dB)",
+        levels.uNumInstances, ClampLevel(levels.fSumRmsAfter), ClampLevel(levels.fMaxPeak));
+    ::SetDlgItemTextW(m_hwnd, IDC_INSTANCES, text);
+
+    // Loudest instance for each loudness measurement, posted when loudness metering is on
+    const WoaGainMonitorData::Loudness& loudness = levels.maxLoudness;
+    if (loudness.fMomentary > -INFINITY)
+    {
+        swprintf_s(text, L"M %.1f, S %.1f, I %.1f LUFS",
+            ClampLevel(loudness.fMomentary), ClampLevel(loudness.fShortTerm), ClampLevel(loudness.fIntegrated));
     }
-}
\ No newline at end of file
+    else
+    {
+        text[0] = L'\0';
+    }
+    ::SetDlgItemTextW(m_hwnd, IDC_LOUDNESS, text);
+
+    // Share of the buffers processed by each DSP path: unity, mute, constant gain, ramp
+    AkUInt64 uTotalBuffers = 0;
+    for (AkUInt32 i = 0; i < WoaGainMonitorData::NumPaths; ++i)
+        uTotalBuffers += levels.uPathBuffers[i];
+    if (uTotalBuffers > 0)
+    {
+        const AkReal64 fPercent = 100. / (AkReal64)uTotalBuffers;
+        swprintf_s(text, L"unity %.0f%%, mute %.0f%%, gain %.0f%%, ramp %.0f%%",
+            levels.uPathBuffers[0] * fPercent, levels.uPathBuffers[1] * fPercent,
+            levels.uPathBuffers[2] * fPercent, levels.uPathBuffers[3] * fPercent);
+    }
+    else
+    {
+        text[0] = L'\0';
+    }
+    ::SetDlgItemTextW(m_hwnd, IDC_PATHS, text);
+
+    // Slowest instance for each Execute time, posted by sound engines built with WOAGAIN_ENABLE_STATS
+    const WoaGainMonitorData::Stats& stats = levels.maxStats;
+    if (stats.fMaxNs > 0.f)
+    {
+        swprintf_s(text, L"avg %.2f, p99 %.2f, max %.2f us (%.2f ns/frame)",
+            stats.fAvgNs * 1e-3f, stats.fP99Ns * 1e-3f, stats.fMaxNs * 1e-3f, stats.fNsPerFrame);
+    }
+    else
+    {
+        text[0] = L'\0';
+    }
+    ::SetDlgItemTextW(m_hwnd, IDC_STATS, text);
+
+    size_t uLength = 0;
+    text[0] = L'\0';
+    for (AkUInt32 i = 0; i < levels.uNumTop; ++i)
+    {
+        const WoaGainMonitorAggregator::Instance& instance = levels.top[i];
+        const int iWritten = swprintf_s(text + uLength, _countof(text) - uLength, L"Game Object %llu: %.1f dB\r\n",
+            (unsigned long long)instance.uGameObjectID, ClampLevel(instance.fRmsAfter));
+        if (iWritten < 0)
+            break;
+        uLength += iWritten;
+    }
+    ::SetDlgItemTextW(m_hwnd, IDC_TOP_INSTANCES, text);
+}
@@ -32,6 +32,8 @@ the specific language governing permissions and limitations under the License.
 
 #include <AK/Wwise/AudioPlugin.h>
 
+#include "WoaGainMonitorAggregator.h"
+
 /// See https://www.audiokinetic.com/library/edge/?source=SDK&id=plugin__dll.html
 /// for the documentation about Authoring plug-ins
 class WoaGainPlugin
@@ -56,6 +58,10 @@ public:
     // Larger data should be put in the Data Block.
     bool GetBankParameters(const GUID& in_guidPlatform, AK::Wwise::IWriteData* in_pDataWriter) const override;
 
+    /// Sends the whole parameter block again when the gain offset table changes, since it has no
+    /// property ID of its own.
+    void NotifyPropertyChanged(const GUID& in_guidPlatform, LPCWSTR in_szPropertyName) override;
+
     //=== Frontend Methods ===
 
     /// Retrieve the handle holding resources for the module containing the plug-in instance
@@ -94,6 +100,13 @@ public:
     ) override;
 
 private:
+    /// Shows the levels of the last monitoring update in the dialog.
+    void RefreshLevels();
+
     AK::Wwise::IPluginPropertySet* m_pPSet;
     HWND m_hwnd;
+
+    // Monitor data of all instances is aggregated on arrival, the dialog is refreshed on a timer
+    WoaGainMonitorAggregator m_monitorAggregator;
+    bool m_bLevelsDirty;    ///< The aggregated levels changed since the last refresh
 };
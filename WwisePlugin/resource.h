@@ -8,6 +8,37 @@
 #define IDC_LABEL1                      1003
 #define IDC_LABEL2                      1004
 #define IDC_OUTPUT_LVL                  1005
+#define IDC_SMOOTHING_CHECK             1006
+#define IDC_SMOOTHING_TIME              1007
+#define IDC_LABEL3                      1008
+#define IDC_METER_RATE                  1009
+#define IDC_LABEL4                      1010
+#define IDC_INSTANCES                   1011
+#define IDC_LABEL5                      1012
+#define IDC_TOP_INSTANCES               1013
+#define IDC_LABEL6                      1014
+#define IDC_PATHS                       1015
+#define IDC_LABEL7                      1016
+#define IDC_LOUDNESS_CHECK              1017
+#define IDC_LOUDNESS                    1018
+#define IDC_LABEL8                      1019
+#define IDC_AUTO_GAIN_CHECK             1020
+#define IDC_TARGET_LOUDNESS             1021
+#define IDC_LABEL9                      1022
+#define IDC_ATTACK_TIME                 1023
+#define IDC_LABEL10                     1024
+#define IDC_RELEASE_TIME                1025
+#define IDC_LABEL11                     1026
+#define IDC_MAX_CORRECTION              1027
+#define IDC_LABEL12                     1028
+#define IDC_GAIN_OFFSET_TABLE           1029
+#define IDC_LABEL13                     1030
+#define IDC_STATS                       1031
+#define IDC_LABEL14                     1032
+#define IDC_SMOOTHING_CURVE             1033
+#define IDC_LABEL15                     1034
+#define IDC_LEVEL_KEY                   1035
+#define IDC_LABEL16                     1036
 
 // Next default values for new objects
 // 
@@ -15,7 +46,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        102
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1006
+#define _APS_NEXT_CONTROL_VALUE         1037
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif